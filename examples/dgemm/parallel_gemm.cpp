@@ -0,0 +1,105 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <tiledarray.h>
+#include <TiledArray/math/parallel_gemm.h>
+
+int main(int argc, char** argv) {
+  // Initialize runtime
+  TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+  // Get command line arguments
+  if(argc < 2) {
+    std::cout << "Usage: " << argv[0] << " matrix_size [repetitions]\n";
+    TiledArray::finalize();
+    return 0;
+  }
+  const long matrix_size = atol(argv[1]);
+  if (matrix_size <= 0) {
+    std::cerr << "Error: matrix size must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  const long repeat = (argc >= 3 ? atol(argv[2]) : 5);
+  if (repeat <= 0) {
+    std::cerr << "Error: number of repetitions must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+
+  if(world.rank() == 0) {
+    std::cout << "\nMatrix size       = " << matrix_size << "x" << matrix_size
+              << "\nMemory per matrix = " << double(matrix_size * matrix_size * sizeof(double)) / 1.0e9
+              << " GB\nThreshold (m*n*k) = " << TiledArray::math::parallel_gemm_threshold()
+              << "\nUse parallel GEMM = " << (TiledArray::math::use_parallel_gemm(
+                  matrix_size, matrix_size, matrix_size) ? "yes" : "no")
+              << "\n";
+
+    // Construct matrices
+    double* a = NULL;
+    if(posix_memalign(reinterpret_cast<void**>(&a), 128, sizeof(double) * matrix_size * matrix_size) != 0)
+      return 1;
+    double* b = NULL;
+    if(posix_memalign(reinterpret_cast<void**>(&b), 128, sizeof(double) * matrix_size * matrix_size) != 0)
+      return 1;
+    double* c = NULL;
+    if(posix_memalign(reinterpret_cast<void**>(&c), 128, sizeof(double) * matrix_size * matrix_size) != 0)
+      return 1;
+    std::fill_n(a, matrix_size * matrix_size, 1.0);
+    std::fill_n(b, matrix_size * matrix_size, 1.0);
+    std::fill_n(c, matrix_size * matrix_size, 0.0);
+
+    const double alpha = 1l, beta = 0l;
+    const integer m = matrix_size, n = matrix_size, k = matrix_size;
+    const double flops = double(repeat) * 2.0 * double(m) * double(n) * double(k);
+
+    // Serial BLAS
+    const double serial_start = madness::wall_time();
+    for(int i = 0; i < repeat; ++i)
+      TiledArray::math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans,
+          m, n, k, alpha, a, k, b, n, beta, c, n);
+    const double serial_stop = madness::wall_time();
+
+    // Blocked, task-parallel GEMM
+    const double parallel_start = madness::wall_time();
+    for(int i = 0; i < repeat; ++i)
+      TiledArray::math::parallel_gemm(madness::cblas::NoTrans,
+          madness::cblas::NoTrans, m, n, k, alpha, a, k, b, n, beta, c, n);
+    const double parallel_stop = madness::wall_time();
+
+    // Cleanup memory
+    free(a);
+    free(b);
+    free(c);
+
+    const double serial_time = (serial_stop - serial_start) / double(repeat);
+    const double parallel_time = (parallel_stop - parallel_start) / double(repeat);
+    std::cout << "Serial BLAS:"
+              << "\n  Average wall time = " << serial_time
+              << "\n  Average GFLOPS    = " << flops / (serial_stop - serial_start) / 1.0e9
+              << "\nParallel GEMM:"
+              << "\n  Average wall time = " << parallel_time
+              << "\n  Average GFLOPS    = " << flops / (parallel_stop - parallel_start) / 1.0e9
+              << "\nSpeedup = " << serial_time / parallel_time << "\n";
+  }
+
+  TiledArray::finalize();
+  return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <tiledarray.h>
+
+/// Run the dense matrix multiply and add benchmark for an array type
+
+/// \tparam Array The array type
+/// \param world The world where the arrays live
+/// \param trange The tiled range of the matrices
+/// \param repeat The number of iterations
+/// \return The average wall time of an iteration
+template <typename Array>
+double run(TiledArray::World& world, const TiledArray::TiledRange& trange,
+    const long repeat)
+{
+  Array a(world, trange);
+  Array b(world, trange);
+  Array c(world, trange);
+  a.fill(1.0);
+  b.fill(1.0);
+  world.gop.fence();
+
+  double total_time = 0.0;
+  for(int i = 0; i < repeat; ++i) {
+    const double start = madness::wall_time();
+    c("m,n") = a("m,k") * b("k,n");
+    c("m,n") = 2.0 * c("m,n") + a("m,n") - b("n,m");
+    world.gop.fence();
+    total_time += madness::wall_time() - start;
+  }
+
+  return total_time / double(repeat);
+}
+
+int main(int argc, char** argv) {
+  // Initialize runtime
+  TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+  // Get command line arguments
+  if(argc < 3) {
+    std::cout << "Usage: " << argv[0] << " matrix_size block_size [repetitions]\n";
+    TiledArray::finalize();
+    return 0;
+  }
+  const long matrix_size = atol(argv[1]);
+  const long block_size = atol(argv[2]);
+  if (matrix_size <= 0) {
+    std::cerr << "Error: matrix size must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  if (block_size <= 0) {
+    std::cerr << "Error: block size must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  if((matrix_size % block_size) != 0ul) {
+    std::cerr << "Error: matrix size must be evenly divisible by block size.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  const long repeat = (argc >= 4 ? atol(argv[3]) : 5);
+  if (repeat <= 0) {
+    std::cerr << "Error: number of repetitions must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+
+  // Construct TiledRange
+  std::vector<unsigned int> blocking;
+  blocking.reserve(matrix_size / block_size + 1);
+  for(long i = 0l; i <= matrix_size; i += block_size)
+    blocking.push_back(i);
+  std::vector<TiledArray::TiledRange1> blocking2(2,
+      TiledArray::TiledRange1(blocking.begin(), blocking.end()));
+  TiledArray::TiledRange trange(blocking2.begin(), blocking2.end());
+
+  if(world.rank() == 0)
+    std::cout << "TiledArray: tensor memory pool test..."
+              << "\nNumber of nodes     = " << world.size()
+              << "\nMatrix size         = " << matrix_size << "x" << matrix_size
+              << "\nBlock size          = " << block_size << "x" << block_size
+              << "\nThread cache limit  = "
+              << TiledArray::detail::TensorPool::instance().thread_cache_limit()
+              << " bytes\n";
+
+  const double default_time = run<TiledArray::TArray<double> >(world, trange, repeat);
+  const double pool_time = run<TiledArray::TArrayPool<double> >(world, trange, repeat);
+
+  const auto stats = TiledArray::tensor_pool_stats();
+  if(world.rank() == 0)
+    std::cout << "Eigen::aligned_allocator:"
+              << "\n  Average wall time = " << default_time
+              << " sec\nPoolAllocator:"
+              << "\n  Average wall time = " << pool_time
+              << " sec\n  Allocations       = " << stats.allocations
+              << "\n  Cache hits        = " << stats.hits
+              << "\n  Hit rate          = "
+              << (stats.allocations ? double(stats.hits) / double(stats.allocations) : 0.0)
+              << "\n  Cached bytes      = " << stats.cached_bytes
+              << "\nSpeedup = " << default_time / pool_time << "\n";
+
+  TiledArray::finalize();
+  return 0;
+}
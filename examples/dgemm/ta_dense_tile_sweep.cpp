@@ -0,0 +1,128 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <tiledarray.h>
+
+// Sweep the block size of a dense matrix multiply. Contractions of small
+// blocks are batched (see TA_BATCHED_CONTRACTION); run with
+// TA_BATCHED_CONTRACTION=0 to compare with one task per block pair.
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if(argc < 2) {
+      std::cout << "Usage: " << argv[0] << " matrix_size [min_block_size = 4] [repetitions = 5]\n";
+      TiledArray::finalize();
+      return 0;
+    }
+    const long matrix_size = atol(argv[1]);
+    if (matrix_size <= 0) {
+      std::cerr << "Error: matrix size must be greater than zero.\n";
+      return 1;
+    }
+    const long min_block_size = (argc >= 3 ? atol(argv[2]) : 4);
+    if (min_block_size <= 0) {
+      std::cerr << "Error: block size must be greater than zero.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 5);
+    if (repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    const double gflop = 2.0 * double(matrix_size * matrix_size * matrix_size) / 1.0e9;
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: dense matrix multiply block size sweep..."
+                << "\nNumber of nodes     = " << world.size()
+                << "\nMatrix size         = " << matrix_size << "x" << matrix_size
+                << "\nBatch threshold     = " << TiledArray::math::batched_contraction_threshold()
+                << "\n\n" << std::setw(10) << "block" << std::setw(10) << "blocks"
+                << std::setw(10) << "batched" << std::setw(14) << "time (s)"
+                << std::setw(12) << "GFLOPS\n";
+
+    for(long block_size = min_block_size; block_size <= matrix_size; block_size *= 2) {
+      // Construct TiledRange, the last block holds the remainder
+      std::vector<long> blocking;
+      for(long i = 0l; i < matrix_size; i += block_size)
+        blocking.push_back(i);
+      blocking.push_back(matrix_size);
+
+      std::vector<TiledArray::TiledRange1> blocking2(2,
+          TiledArray::TiledRange1(blocking.begin(), blocking.end()));
+      TiledArray::TiledRange trange(blocking2.begin(), blocking2.end());
+
+      TiledArray::TArrayD a(world, trange);
+      TiledArray::TArrayD b(world, trange);
+      TiledArray::TArrayD c;
+      a.fill(1.0);
+      b.fill(1.0);
+
+      // Warm up
+      c("m,n") = a("m,k") * b("k,n");
+      world.gop.fence();
+
+      double total_time = 0.0;
+      for(long r = 0l; r < repeat; ++r) {
+        const double start = madness::wall_time();
+        c("m,n") = a("m,k") * b("k,n");
+        world.gop.fence();
+        total_time += madness::wall_time() - start;
+      }
+
+      const double time = total_time / double(repeat);
+      const bool batched = double(block_size * block_size * block_size) <
+          TiledArray::math::batched_contraction_threshold();
+      if(world.rank() == 0)
+        std::cout << std::setw(10) << block_size
+                  << std::setw(10) << blocking.size() - 1ul
+                  << std::setw(10) << (batched ? "yes" : "no")
+                  << std::setw(14) << std::setprecision(6) << time
+                  << std::setw(11) << std::setprecision(4) << gflop / time << "\n";
+    }
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
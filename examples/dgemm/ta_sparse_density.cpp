@@ -0,0 +1,167 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <tiledarray.h>
+
+// Sweep the block density of a block-sparse matrix multiply, from very sparse
+// arguments, where the time is dominated by the screening of tile pairs and
+// the construction of sparse broadcast groups, to dense arguments.
+
+/// Make a random block-sparse shape
+
+/// \param world The world where the shape lives
+/// \param trange The tiled range of the shape
+/// \param density The fraction of non-zero blocks
+/// \param block_size The block size
+/// \return A shape with approximately \c density non-zero blocks
+TiledArray::SparseShape<float> make_shape(TiledArray::World& world,
+    const TiledArray::TiledRange& trange, const double density,
+    const long block_size)
+{
+  TiledArray::Tensor<float> tile_norms(trange.tiles_range(), 0.0f);
+  if(world.rank() == 0) {
+    const long volume = trange.tiles_range().volume();
+    const long block_count = std::max(long(density * double(volume)), 1l);
+    for(long count = 0l; count < block_count; ++count) {
+      std::size_t index = world.rand() % volume;
+
+      // Avoid setting the same tile to non-zero.
+      while(tile_norms[index] > TiledArray::SparseShape<float>::threshold())
+        index = world.rand() % volume;
+
+      tile_norms[index] = std::sqrt(float(block_size * block_size));
+    }
+  }
+
+  return TiledArray::SparseShape<float>(world, tile_norms, trange);
+}
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    if(argc < 3) {
+      std::cout << "Usage: " << argv[0] << " matrix_size block_size [repetitions = 4]\n";
+      TiledArray::finalize();
+      return 0;
+    }
+    const long matrix_size = atol(argv[1]);
+    const long block_size = atol(argv[2]);
+    if(matrix_size <= 0) {
+      std::cerr << "Error: matrix size must be greater than zero.\n";
+      return 1;
+    }
+    if(block_size <= 0) {
+      std::cerr << "Error: block size must be greater than zero.\n";
+      return 1;
+    }
+    if((matrix_size % block_size) != 0ul) {
+      std::cerr << "Error: matrix size must be evenly divisible by block size.\n";
+      return 1;
+    }
+    const long repeat = (argc >= 4 ? atol(argv[3]) : 4);
+    if(repeat <= 0) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    // Construct TiledRange
+    std::vector<unsigned int> blocking;
+    for(long i = 0l; i <= matrix_size; i += block_size)
+      blocking.push_back(i);
+
+    std::vector<TiledArray::TiledRange1> blocking2(2,
+        TiledArray::TiledRange1(blocking.begin(), blocking.end()));
+
+    TiledArray::TiledRange
+      trange(blocking2.begin(), blocking2.end());
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: block-sparse matrix multiply density sweep..."
+                << "\nNumber of nodes    = " << world.size()
+                << "\nMatrix size        = " << matrix_size << "x" << matrix_size
+                << "\nBlock size         = " << block_size << "x" << block_size
+                << "\nNumber of blocks   = " << trange.tiles_range().volume()
+                << "\n\n" << std::setw(10) << "density" << std::setw(12) << "C density"
+                << std::setw(14) << "time (s)" << std::setw(12) << "GFLOPS"
+                << std::setw(14) << "tile pairs/s\n";
+
+    world.srand(42);
+    const double densities[] = { 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1,
+        0.2, 0.5, 1.0 };
+    for(const double density : densities) {
+      // Construct and initialize arrays
+      TiledArray::TSpArrayD a(world, trange, make_shape(world, trange, density, block_size));
+      TiledArray::TSpArrayD b(world, trange, make_shape(world, trange, density, block_size));
+      TiledArray::TSpArrayD c;
+      a.fill(1.0);
+      b.fill(1.0);
+      TiledArray::TSpArrayD::wait_for_lazy_cleanup(world);
+      world.gop.fence();
+
+      double total_time = 0.0, flop = 0.0;
+      for(long r = 0l; r < repeat; ++r) {
+        const double start = madness::wall_time();
+        c("m,n") = a("m,k") * b("k,n");
+        world.gop.fence();
+        total_time += madness::wall_time() - start;
+        // Each element of c is the number of products that contribute to it
+        if(flop < 1.0)
+          flop = 2.0 * c("m,n").sum();
+      }
+
+      const double time = total_time / double(repeat);
+      const double pairs = flop / (2.0 * double(block_size * block_size * block_size));
+      if(world.rank() == 0)
+        std::cout << std::setw(10) << density
+                  << std::setw(12) << std::setprecision(4) << 1.0 - c.shape().sparsity()
+                  << std::setw(14) << std::setprecision(6) << time
+                  << std::setw(12) << std::setprecision(4) << flop / time / 1.0e9
+                  << std::setw(13) << std::setprecision(4) << pairs / time << "\n";
+    }
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
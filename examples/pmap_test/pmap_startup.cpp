@@ -0,0 +1,121 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <cmath>
+#include "tiledarray.h"
+#include "TiledArray/pmap/blocked_pmap.h"
+#include "TiledArray/pmap/cyclic_pmap.h"
+#include "TiledArray/pmap/hash_pmap.h"
+
+/// Time the construction of a process map
+
+/// \param world The world where the tiles are mapped
+/// \param repeat The number of maps to construct
+/// \param op The process map factory
+/// \return The maximum average construction time among all processes
+template <typename Op>
+double time_pmap(TiledArray::World& world, const long repeat, const Op& op) {
+  world.gop.fence();
+  const double start = madness::wall_time();
+  std::size_t local_size = 0ul;
+  for(long i = 0l; i < repeat; ++i) {
+    std::shared_ptr<TiledArray::Pmap> pmap = op();
+    local_size += pmap->local_size();
+  }
+  double time = (madness::wall_time() - start) / double(repeat);
+
+  // Keep the local size live and report the slowest process
+  world.gop.max(time);
+  world.gop.sum(local_size);
+  TA_USER_ASSERT(local_size > 0ul, "No tiles were mapped.");
+
+  return time;
+}
+
+int main(int argc, char** argv) {
+  // Initialize runtime
+  TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+  // Get command line arguments
+  if(argc < 2) {
+    std::cout << "Usage: " << argv[0] << " tiles [repetitions] [buckets_per_proc]\n";
+    TiledArray::finalize();
+    return 0;
+  }
+  const long tiles = atol(argv[1]);
+  if (tiles <= 0) {
+    std::cerr << "Error: number of tiles must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  const long repeat = (argc >= 3 ? atol(argv[2]) : 5);
+  if (repeat <= 0) {
+    std::cerr << "Error: number of repetitions must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  const long buckets_per_proc = (argc >= 4 ? atol(argv[3]) :
+      TiledArray::detail::HashPmap::default_buckets_per_proc);
+  if (buckets_per_proc <= 0) {
+    std::cerr << "Error: number of buckets per process must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+
+  // Arrange the tiles and processes into matrices for the cyclic map
+  const std::size_t procs = world.size();
+  std::size_t proc_rows = std::max<std::size_t>(std::sqrt(double(procs)), 1ul);
+  while(procs % proc_rows)
+    --proc_rows;
+  const std::size_t proc_cols = procs / proc_rows;
+  const std::size_t cols = std::max<std::size_t>(std::sqrt(double(tiles)), proc_cols);
+  const std::size_t rows = std::max<std::size_t>((tiles + cols - 1ul) / cols, proc_rows);
+
+  if(world.rank() == 0)
+    std::cout << "Processes        = " << procs
+              << "\nTiles            = " << tiles
+              << "\nCyclic tiles     = " << rows << "x" << cols
+              << "\nCyclic processes = " << proc_rows << "x" << proc_cols
+              << "\nBuckets per proc = " << buckets_per_proc
+              << "\n\nAverage construction time:\n";
+
+  const double blocked_time = time_pmap(world, repeat, [&] () {
+    return std::make_shared<TiledArray::detail::BlockedPmap>(world, tiles);
+  });
+  if(world.rank() == 0)
+    std::cout << "  BlockedPmap = " << blocked_time << " s\n";
+
+  const double cyclic_time = time_pmap(world, repeat, [&] () {
+    return std::make_shared<TiledArray::detail::CyclicPmap>(world, rows, cols,
+        proc_rows, proc_cols);
+  });
+  if(world.rank() == 0)
+    std::cout << "  CyclicPmap  = " << cyclic_time << " s\n";
+
+  const double hash_time = time_pmap(world, repeat, [&] () {
+    return std::make_shared<TiledArray::detail::HashPmap>(world, tiles, 0ul,
+        buckets_per_proc);
+  });
+  if(world.rank() == 0)
+    std::cout << "  HashPmap    = " << hash_time << " s\n";
+
+  TiledArray::finalize();
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  init_elements.cpp
+ *  Oct 18, 2018
+ *
+ */
+
+#include <tiledarray.h>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Benchmark the element initializers of DistArray
+
+int main(int argc, char** argv) {
+  // Initialize runtime
+  TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+  // Get command line arguments
+  if(argc < 4) {
+    std::cout << "Usage: " << argv[0] << " rank extent block_size [repetitions = 5]\n";
+    TiledArray::finalize();
+    return 0;
+  }
+  const long rank = atol(argv[1]);
+  if (rank <= 0) {
+    std::cerr << "Error: rank must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  const long extent = atol(argv[2]);
+  if (extent <= 0) {
+    std::cerr << "Error: extent must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  const long block_size = atol(argv[3]);
+  if (block_size <= 0) {
+    std::cerr << "Error: block size must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  const long repeat = (argc >= 5 ? atol(argv[4]) : 5);
+  if (repeat <= 0) {
+    std::cerr << "Error: number of repetitions must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+
+  // Construct the tiled range
+  std::vector<unsigned int> blocking;
+  for(long i = 0l; i < extent; i += block_size)
+    blocking.push_back(i);
+  blocking.push_back(extent);
+  const std::vector<TiledArray::TiledRange1> ranges(rank,
+      TiledArray::TiledRange1(blocking.begin(), blocking.end()));
+  const TiledArray::TiledRange trange(ranges.begin(), ranges.end());
+  const auto& elements_range = trange.elements_range();
+  const double volume = double(elements_range.volume());
+
+  if(world.rank() == 0)
+    std::cout << "TiledArray: DistArray element initialization"
+        << "\nNumber of nodes    = " << world.size()
+        << "\nRank               = " << rank
+        << "\nExtent             = " << extent
+        << "\nBlock size         = " << block_size
+        << "\nElements           = " << elements_range.volume()
+        << "\nRepetitions        = " << repeat << "\n";
+
+  typedef TiledArray::TArrayD::index index;
+
+  // Initialize with the element index, as an element initializer would
+  // typically do.
+  auto element_op = [&elements_range] (const index& i) -> double {
+    return double(elements_range.ordinal(i));
+  };
+  auto span_op = [&elements_range] (const index& first, double* data,
+      const std::size_t n)
+  {
+    const double ordinal = double(elements_range.ordinal(first));
+    for(std::size_t j = 0ul; j < n; ++j)
+      data[j] = ordinal + double(j);
+  };
+
+  // The previous implementation of init_elements
+  auto run_index = [&] () {
+    TiledArray::TArrayD array(world, trange);
+    array.init_tiles([element_op] (const TiledArray::Range& range) {
+      TiledArray::TensorD tile(range);
+      for(auto& idx : range)
+        tile[idx] = element_op(idx);
+      return tile;
+    });
+    world.gop.fence();
+  };
+  auto run_elements = [&] () {
+    TiledArray::TArrayD array(world, trange);
+    array.init_elements(element_op);
+    world.gop.fence();
+  };
+  auto run_spans = [&] () {
+    TiledArray::TArrayD array(world, trange);
+    array.init_spans(span_op);
+    world.gop.fence();
+  };
+
+  const char* names[] = { "index iteration", "init_elements", "init_spans" };
+  const std::function<void()> runs[] = { run_index, run_elements, run_spans };
+  for(int r = 0; r < 3; ++r) {
+    // Warm up
+    runs[r]();
+
+    const double start = madness::wall_time();
+    for(long i = 0l; i < repeat; ++i)
+      runs[r]();
+    const double time = (madness::wall_time() - start) / double(repeat);
+
+    if(world.rank() == 0)
+      std::cout << std::setw(16) << std::left << names[r] << std::right
+          << " average time = " << std::setw(10) << time
+          << " s, rate = " << std::setw(10) << volume / time / 1.0e6
+          << " Melements/s\n";
+  }
+
+  TiledArray::finalize();
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  permute.cpp
+ *  Oct 18, 2018
+ *
+ */
+
+#include <tiledarray.h>
+#include <TiledArray/math/simd_transpose.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Benchmark tensor permutation bandwidth against memcpy
+
+template <typename T>
+void run(const std::string& type_name, const std::size_t volume,
+    const std::size_t repeat)
+{
+  const char* isa_names[] = { "scalar", "avx2", "avx512" };
+  std::cout << "\n" << type_name << " (kernel: "
+      << isa_names[TiledArray::math::transpose_isa()] << ")\n";
+
+  const std::vector<std::vector<unsigned int> > perms = {
+      {1, 0}, {0, 2, 1}, {2, 1, 0}, {1, 2, 0}, {0, 1, 3, 2}, {0, 3, 2, 1},
+      {1, 0, 3, 2}, {3, 2, 1, 0}, {2, 3, 0, 1} };
+
+  for(const auto& p : perms) {
+    // Make a tensor of approximately the given volume with equal extents
+    const std::size_t rank = p.size();
+    const std::size_t extent =
+        std::max(std::size_t(std::pow(double(volume), 1.0 / double(rank))), 1ul);
+    const std::vector<std::size_t> extents(rank, extent);
+    TiledArray::Tensor<T> arg(TiledArray::Range(extents), T(1));
+    const TiledArray::Permutation perm(p);
+
+    // Bytes read and written by each copy
+    const double gbytes = 2.0 * double(arg.size() * sizeof(T)) / 1.0e9;
+
+    // memcpy
+    std::vector<T> copy(arg.size());
+    double start = madness::wall_time();
+    for(std::size_t r = 0ul; r < repeat; ++r)
+      std::memcpy(copy.data(), arg.data(), arg.size() * sizeof(T));
+    const double memcpy_time = madness::wall_time() - start;
+
+    // Permutation with the transpose kernels
+    start = madness::wall_time();
+    for(std::size_t r = 0ul; r < repeat; ++r)
+      TiledArray::Tensor<T> result = arg.permute(perm);
+    const double permute_time = madness::wall_time() - start;
+
+    // Permutation with element operations (i.e. the generic kernels)
+    start = madness::wall_time();
+    for(std::size_t r = 0ul; r < repeat; ++r)
+      TiledArray::Tensor<T> result(arg,
+          [] (const T value) -> T { return value; }, perm);
+    const double generic_time = madness::wall_time() - start;
+
+    std::cout << "  perm = " << std::setw(12) << std::left << perm
+        << std::right << std::fixed << std::setprecision(2)
+        << "  memcpy: " << std::setw(7) << gbytes * repeat / memcpy_time
+        << " GB/s  permute: " << std::setw(7) << gbytes * repeat / permute_time
+        << " GB/s (" << std::setw(5) << 100.0 * memcpy_time / permute_time
+        << "%)  generic: " << std::setw(7) << gbytes * repeat / generic_time
+        << " GB/s\n";
+  }
+}
+
+int main(int argc, char** argv) {
+  // Initialize runtime
+  TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+  // Get command line arguments
+  if(argc < 2) {
+    std::cout << "Usage: " << argv[0] << " volume [repetitions = 10]\n";
+    TiledArray::finalize();
+    return 0;
+  }
+  const long volume = atol(argv[1]);
+  if (volume <= 0) {
+    std::cerr << "Error: volume must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  const long repeat = (argc >= 3 ? atol(argv[2]) : 10);
+  if (repeat <= 0) {
+    std::cerr << "Error: number of repetitions must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+
+  if(world.rank() == 0) {
+    std::cout << "Tensor permutation bandwidth (read + write)"
+        << "\nElements:    " << volume
+        << "\nRepetitions: " << repeat << "\n";
+
+    run<float>("float", volume, repeat);
+    run<double>("double", volume, repeat);
+    run<std::complex<float> >("complex<float>", volume, repeat);
+    run<std::complex<double> >("complex<double>", volume, repeat);
+  }
+
+  TiledArray::finalize();
+
+  return 0;
+}
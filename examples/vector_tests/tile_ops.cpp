@@ -0,0 +1,126 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_ops.cpp
+ *  Oct 18, 2018
+ *
+ */
+
+#include <tiledarray.h>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Benchmark the throughput of small tile creation, copy, and permutation
+
+template <typename Op>
+double time_op(const std::size_t repeat, Op&& op) {
+  const double start = madness::wall_time();
+  for(std::size_t r = 0ul; r < repeat; ++r)
+    op();
+  return madness::wall_time() - start;
+}
+
+void run(const std::size_t rank, const std::size_t extent,
+    const std::size_t repeat)
+{
+  const std::vector<std::size_t> lower(rank, 1ul), upper(rank, extent + 1ul);
+  std::vector<unsigned int> p(rank);
+  for(std::size_t i = 0ul; i < rank; ++i)
+    p[i] = rank - i - 1ul;
+  const TiledArray::Permutation perm(p);
+  const TiledArray::Range range(lower, upper);
+  const TiledArray::TensorD tile(range, 1.0);
+
+  // Keep the results alive to prevent the loops from being optimized away
+  std::size_t check = 0ul;
+
+  const double range_create = time_op(repeat, [&] () {
+    TiledArray::Range result(lower, upper);
+    check += result.volume();
+  });
+  const double range_copy = time_op(repeat, [&] () {
+    TiledArray::Range result(range);
+    check += result.volume();
+  });
+  const double range_permute = time_op(repeat, [&] () {
+    TiledArray::Range result = perm * range;
+    check += result.volume();
+  });
+  const double tile_create = time_op(repeat, [&] () {
+    TiledArray::TensorD result(TiledArray::Range(lower, upper));
+    check += result.size();
+  });
+  const double tile_copy = time_op(repeat, [&] () {
+    TiledArray::TensorD result = tile.clone();
+    check += result.size();
+  });
+  const double tile_permute = time_op(repeat, [&] () {
+    TiledArray::TensorD result = tile.permute(perm);
+    check += result.size();
+  });
+
+  const double mops = double(repeat) / 1.0e6;
+  std::cout << std::setw(4) << rank << std::setw(7) << range.volume()
+      << std::fixed << std::setprecision(2)
+      << std::setw(12) << mops / range_create
+      << std::setw(12) << mops / range_copy
+      << std::setw(12) << mops / range_permute
+      << std::setw(12) << mops / tile_create
+      << std::setw(12) << mops / tile_copy
+      << std::setw(12) << mops / tile_permute
+      << (check ? "\n" : " \n");
+}
+
+int main(int argc, char** argv) {
+  // Initialize runtime
+  TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+  // Get command line arguments
+  if(argc < 2) {
+    std::cout << "Usage: " << argv[0] << " extent [repetitions = 100000]\n";
+    TiledArray::finalize();
+    return 0;
+  }
+  const long extent = atol(argv[1]);
+  if (extent <= 0) {
+    std::cerr << "Error: extent must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+  const long repeat = (argc >= 3 ? atol(argv[2]) : 100000);
+  if (repeat <= 0) {
+    std::cerr << "Error: number of repetitions must be greater than zero.\n";
+    TiledArray::finalize();
+    return 1;
+  }
+
+  if(world.rank() == 0) {
+    std::cout << "Small tile operation throughput (millions of operations per second)"
+        << "\nExtent:      " << extent
+        << "\nRepetitions: " << repeat << "\n\n"
+        << "rank volume       range  range copy  range perm"
+        << "        tile   tile copy   tile perm\n";
+
+    for(std::size_t rank = 1ul; rank <= 8ul; ++rank)
+      run(rank, extent, repeat);
+  }
+
+  TiledArray::finalize();
+
+  return 0;
+}
@@ -26,6 +26,8 @@
 #ifndef TILEDARRAY_ALGEBRA_CONJGRAD_H__INCLUDED
 #define TILEDARRAY_ALGEBRA_CONJGRAD_H__INCLUDED
 
+#include <array>
+#include <functional>
 #include <sstream>
 #include <TiledArray/algebra/diis.h>
 #include <TiledArray/algebra/utils.h>
@@ -48,10 +50,22 @@ namespace TiledArray {
   ///   \li <tt> value_type maxabs_value(const D&) </tt>
   ///   \li <tt> void vec_multiply(D& a, const D& b) </tt> (element-wise multiply of \c a by \c b )
   ///   \li <tt> value_type dot_product(const D& a, const D& b) </tt>
-  ///   \li <tt> void scale(D&, value_type) </tt>
+  ///   \li <tt> void zero(D&) </tt>
   ///   \li <tt> void axpy(D& y, value_type a, const D& x) </tt>
   ///   \li <tt> void assign(D&, const D&) </tt>
-  ///   \li <tt> double norm2(const D&) </tt>
+  ///
+  /// The solver combines vectors with \c dot_products and
+  /// \c linear_combination ; the generic versions in algebra/utils.h
+  /// implement them with \c dot_product , \c zero , \c axpy , and
+  /// \c vec_multiply , and \c D may provide faster overloads with the same
+  /// signatures (as \c DistArray does):
+  ///   \li <tt> std::vector<value_type> dot_products(const D& a, InIter first, InIter last) </tt>
+  ///       (dot products of \c a with each object in [ \c first , \c last ),
+  ///       where \c InIter dereferences to an object convertible to <tt> const D& </tt> )
+  ///   \li <tt> void linear_combination(D& x, const std::vector<value_type>& c, InIter first, InIter last) </tt>
+  ///       ( \c x = sum of \c c[k] times the k-th object in [ \c first , \c last ) )
+  ///   \li <tt> void linear_combination(D& x, const std::vector<value_type>& c, InIter first, InIter last, const D& z) </tt>
+  ///       (as above, multiplied element-wise by \c z )
   template <typename D, typename F>
   struct ConjugateGradientSolver {
     typedef typename D::element_type value_type;
@@ -78,7 +92,7 @@ namespace TiledArray {
       // residual vector
       D RR_i = clone(b);
       // preconditioned residual vector
-      D ZZ_i;
+      D ZZ_i = clone(b);
       // direction vector
       D PP_i;
       D APP_i = clone(b);
@@ -110,24 +124,29 @@ namespace TiledArray {
 
       // r_0 = b - a(x)
       a(XX_i, RR_i);  // RR_i = a(XX_i)
-      scale(RR_i, -1.0);
-      axpy(RR_i, 1.0, b); // RR_i = b - a(XX_i)
+      {
+        const std::array<std::reference_wrapper<const D>, 2> terms =
+            {{ std::cref(RR_i), std::cref(b) }};
+        linear_combination(RR_i, {-1.0, 1.0}, terms.begin(), terms.end()); // RR_i = b - a(XX_i)
+      }
 
       if (use_diis)
         diis.extrapolate(XX_i, RR_i, true);
 
-      // z_0 = D^-1 . r_0
-      ZZ_i = copy(RR_i);
-      vec_multiply(ZZ_i, preconditioner);
+      // z_0 = D^-1 . r_0, in a single pass
+      const std::array<std::reference_wrapper<const D>, 1> R_i =
+          {{ std::cref(RR_i) }};
+      linear_combination(ZZ_i, {1.0}, R_i.begin(), R_i.end(), preconditioner);
 
       // p_0 = z_0
       PP_i = copy(ZZ_i);
 
+      value_type rz_norm2 = dot_product(RR_i, ZZ_i);
+
       unsigned int iter = 0;
       while (not converged) {
 
         // alpha_i = (r_i . z_i) / (p_i . A . p_i)
-        value_type rz_norm2 = dot_product(RR_i, ZZ_i);
         a(PP_i,APP_i);
 
         const value_type pAp_i = dot_product(PP_i, APP_i);
@@ -142,25 +161,30 @@ namespace TiledArray {
         if (use_diis)
           diis.extrapolate(XX_i, RR_i, true);
 
-        const value_type r_ip1_norm = norm2(RR_i) / rhs_size;
+        // z_i = D^-1 . r_i, in a single pass
+        linear_combination(ZZ_i, {1.0}, R_i.begin(), R_i.end(), preconditioner);
+
+        // compute r_i . r_i and r_i . z_i with a single reduction
+        const std::array<std::reference_wrapper<const D>, 2> RZ_i =
+            {{ std::cref(RR_i), std::cref(ZZ_i) }};
+        const std::vector<value_type> r_ip1_dots =
+            dot_products(RR_i, RZ_i.begin(), RZ_i.end());
+
+        const value_type r_ip1_norm = std::sqrt(r_ip1_dots[0]) / rhs_size;
         if (r_ip1_norm < convergence_target) {
           converged = true;
           rnorm2 = r_ip1_norm;
         }
 
-        // z_i = D^-1 . r_i
-        ZZ_i = copy(RR_i);
-        vec_multiply(ZZ_i, preconditioner);
-
-        const value_type rz_ip1_norm2 = dot_product(ZZ_i, RR_i);
+        const value_type rz_ip1_norm2 = r_ip1_dots[1];
 
         const value_type beta_i = rz_ip1_norm2 / rz_norm2;
 
-        // p_i = z_i+1 + beta_i p_i
-        // 1) scale p_i by beta_i
-        // 2) add z_i+1 (i.e. current contents of z_i)
-        scale(PP_i, beta_i);
-        axpy(PP_i, 1.0, ZZ_i);
+        // p_i = z_i+1 + beta_i p_i, in a single pass
+        const std::array<std::reference_wrapper<const D>, 2> PZ_i =
+            {{ std::cref(PP_i), std::cref(ZZ_i) }};
+        linear_combination(PP_i, {beta_i, 1.0}, PZ_i.begin(), PZ_i.end());
+        rz_norm2 = rz_ip1_norm2;
 
         ++iter;
         //std::cout << "iter=" << iter << " dnorm=" << r_ip1_norm << std::endl;
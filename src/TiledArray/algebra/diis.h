@@ -26,7 +26,9 @@
 #ifndef TILEDARRAY_ALGEBRA_DIIS_H__INCLUDED
 #define TILEDARRAY_ALGEBRA_DIIS_H__INCLUDED
 
+#include <array>
 #include <deque>
+#include <functional>
 #include <TiledArray/math/eigen.h>
 #include <TiledArray/algebra/utils.h>
 #include "../dist_array.h"
@@ -76,7 +78,13 @@ namespace TiledArray {
   ///
   /// The original DIIS reference: P. Pulay, Chem. Phys. Lett. 73, 393 (1980).
   ///
-  /// \tparam D type of \c x
+  /// \tparam D type of \c x ; \c D::element_type must be defined and \c D
+  /// must provide the stand-alone functions \c zero(D&) ,
+  /// \c axpy(D&,element_type,const D&) , and
+  /// \c dot_product(const D&,const D&) , with which the generic
+  /// \c dot_products and \c linear_combination in algebra/utils.h are
+  /// implemented; \c D may provide faster overloads of the latter two (as
+  /// \c DistArray does).
   template <typename D>
   class DIIS {
     public:
@@ -153,9 +161,13 @@ namespace TiledArray {
 
         // extrapolate the error if needed
         if (extrapolate_error && (mixing_fraction == 0.0 || x_extrap_.empty())) {
+          std::vector<value_type> coeffs(1, value_type(1));
+          std::vector<std::reference_wrapper<const D> > terms(1, std::cref(error));
           for (unsigned int k=nskip_, kk=1; k < nvec; ++k, ++kk) {
-            axpy(error, C_[kk], errors_[k]);
+            coeffs.push_back(C_[kk]);
+            terms.push_back(std::cref(errors_[k]));
           }
+          linear_combination(error, coeffs, terms.begin(), terms.end());
         }
       }
 
@@ -188,9 +200,11 @@ namespace TiledArray {
 
         if (iter == 1) { // the first iteration
           if (not x_extrap_.empty() && do_mixing) {
-            zero(x);
-            axpy(x, (1.0-mixing_fraction), x_[0]);
-            axpy(x, mixing_fraction, x_extrap_[0]);
+            const std::vector<value_type> coeffs = { value_type(1.0-mixing_fraction),
+                value_type(mixing_fraction) };
+            const std::array<std::reference_wrapper<const D>, 2> terms =
+                {{ std::cref(x_[0]), std::cref(x_extrap_[0]) }};
+            linear_combination(x, coeffs, terms.begin(), terms.end());
           }
         }
         else if (iter > start && (((iter - start) % ngroup) < ngroupdiis)) { // not the first iteration and need to extrapolate?
@@ -200,16 +214,22 @@ namespace TiledArray {
 
           TA_USER_ASSERT(c.size() == rank,
                          "DIIS: numbers of coefficients and x's do not match");
-          zero(x);
+          // x = sum_k c_k x_k, evaluated in a single pass
+          std::vector<value_type> coeffs;
+          std::vector<std::reference_wrapper<const D> > terms;
           for (unsigned int k=nskip, kk=1; k < nvec; ++k, ++kk) {
             if (not do_mixing || x_extrap_.empty()) {
               //std::cout << "contrib " << k << " c=" << c[kk] << ":" << std::endl << x_[k] << std::endl;
-              axpy(x, c[kk], x_[k]);
+              coeffs.push_back(c[kk]);
+              terms.push_back(std::cref(x_[k]));
             } else {
-              axpy(x, c[kk] * (1.0 - mixing_fraction), x_[k]);
-              axpy(x, c[kk] * mixing_fraction, x_extrap_[k]);
+              coeffs.push_back(c[kk] * (1.0 - mixing_fraction));
+              terms.push_back(std::cref(x_[k]));
+              coeffs.push_back(c[kk] * mixing_fraction);
+              terms.push_back(std::cref(x_extrap_[k]));
             }
           }
+          linear_combination(x, coeffs, terms.begin(), terms.end());
 
         } // do DIIS
 
@@ -244,10 +264,12 @@ namespace TiledArray {
         errors_.push_back(error);
         const unsigned int nvec = errors_.size();
 
-        // and compute the most recent elements of B, B(i,j) = <ei|ej>
+        // and compute the most recent elements of B, B(i,j) = <ei|ej>, with a
+        // single reduction
+        const auto dots = dot_products(errors_[nvec-1], errors_.begin(), errors_.end());
         for (unsigned int i=0; i < nvec-1; i++)
-          B_(i,nvec-1) = B_(nvec-1,i) = dot_product(errors_[i], errors_[nvec-1]);
-        B_(nvec-1,nvec-1) = dot_product(errors_[nvec-1], errors_[nvec-1]);
+          B_(i,nvec-1) = B_(nvec-1,i) = dots[i];
+        B_(nvec-1,nvec-1) = dots[nvec-1];
 
         // compute extrapolation coefficients C_ and number of skipped vectors nskip_
         if (iter > start && (((iter - start) % ngroup) < ngroupdiis)) { // not the first iteration and need to extrapolate?
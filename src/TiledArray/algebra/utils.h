@@ -26,7 +26,11 @@
 #ifndef TILEDARRAY_ALGEBRA_UTILS_H__INCLUDED
 #define TILEDARRAY_ALGEBRA_UTILS_H__INCLUDED
 
+#include <algorithm>
+#include <functional>
 #include <sstream>
+#include <iterator>
+#include <vector>
 
 #include "../dist_array.h"
 #include "../expressions/expr.h"
@@ -43,6 +47,167 @@ namespace TiledArray {
       return oss.str();
     }
 
+    /// Linear combination of tiles
+
+    /// Generic version, for tiles other than Tensor
+    /// \tparam Tile The tile type
+    /// \tparam Scalar The coefficient type
+    /// \param c The coefficients of the tiles
+    /// \param y The tiles
+    /// \param z If not null, the tile that multiplies the combination
+    /// element-wise
+    /// \return <tt>z * sum_k c[k] * y[k]</tt>
+    template <typename Tile, typename Scalar>
+    inline Tile linear_combination_tiles(const std::vector<Scalar>& c,
+        const std::vector<Future<Tile> >& y, const Tile* z)
+    {
+      using TiledArray::scale;
+      using TiledArray::add_to;
+      using TiledArray::mult_to;
+      Tile result = scale(y.front().get(), c.front());
+      for(std::size_t k = 1ul; k < y.size(); ++k)
+        add_to(result, scale(y[k].get(), c[k]));
+      if(z)
+        mult_to(result, *z);
+      return result;
+    }
+
+    /// Linear combination of tensors
+
+    /// The result is computed in blocks that stay in cache while the
+    /// contributions of all arguments are accumulated, so each argument is
+    /// read, and the result written, once.
+    /// \tparam T The element type of the tensors
+    /// \tparam A The allocator type of the tensors
+    /// \tparam Scalar The coefficient type
+    /// \param c The coefficients of the tensors
+    /// \param y The tensors
+    /// \param z If not null, the tensor that multiplies the combination
+    /// element-wise
+    /// \return <tt>z * sum_k c[k] * y[k]</tt>
+    template <typename T, typename A, typename Scalar,
+        typename std::enable_if<is_numeric<T>::value>::type* = nullptr>
+    inline Tensor<T, A> linear_combination_tiles(const std::vector<Scalar>& c,
+        const std::vector<Future<Tensor<T, A> > >& y, const Tensor<T, A>* z)
+    {
+      constexpr std::size_t block_size = 1024ul;
+
+      const Tensor<T, A>& first = y.front().get();
+      Tensor<T, A> result(first.range());
+      const std::size_t volume = result.size();
+      T* MADNESS_RESTRICT const result_data = result.data();
+
+      for(std::size_t b = 0ul; b < volume; b += block_size) {
+        const std::size_t n = std::min(block_size, volume - b);
+        T* MADNESS_RESTRICT const r = result_data + b;
+
+        const T* MADNESS_RESTRICT y_k = first.data() + b;
+        const Scalar c_0 = c.front();
+        for(std::size_t i = 0ul; i < n; ++i)
+          r[i] = y_k[i] * c_0;
+
+        for(std::size_t k = 1ul; k < y.size(); ++k) {
+          const Tensor<T, A>& tile = y[k].get();
+          TA_ASSERT(tile.range() == result.range());
+          y_k = tile.data() + b;
+          const Scalar c_k = c[k];
+          for(std::size_t i = 0ul; i < n; ++i)
+            r[i] += y_k[i] * c_k;
+        }
+
+        if(z) {
+          TA_ASSERT(z->range() == result.range());
+          const T* MADNESS_RESTRICT const z_b = z->data() + b;
+          for(std::size_t i = 0ul; i < n; ++i)
+            r[i] *= z_b[i];
+        }
+      }
+
+      return result;
+    }
+
+    /// Store a linear combination of arrays in an array
+
+    /// \tparam Tile The tile type of the arrays
+    /// \tparam Policy The policy of the arrays
+    /// \tparam InIter An input iterator type; dereferencing it must yield an
+    /// object that is convertible to <tt>const DistArray<Tile,Policy>&</tt>
+    /// \param x The result array
+    /// \param c The coefficients of the arrays
+    /// \param first An iterator to the first array
+    /// \param last An iterator to the end of the arrays
+    /// \param z If not null, the array that multiplies the combination
+    /// element-wise
+    template <typename Tile, typename Policy, typename InIter>
+    inline void linear_combination(DistArray<Tile,Policy>& x,
+        const std::vector<typename DistArray<Tile,Policy>::element_type>& c,
+        InIter first, InIter last, const DistArray<Tile,Policy>* z)
+    {
+      typedef DistArray<Tile,Policy> array_type;
+      typedef typename array_type::value_type value_type;
+      typedef typename array_type::element_type element_type;
+
+      std::vector<std::reference_wrapper<const array_type> > y;
+      for(; first != last; ++first)
+        y.emplace_back(*first);
+      TA_USER_ASSERT(! y.empty(),
+          "linear_combination(): The sequence of arrays is empty.");
+      TA_USER_ASSERT(y.size() == c.size(),
+          "linear_combination(): The numbers of coefficients and arrays do not match.");
+
+      // Compute the shape of the result
+      const array_type& y_0 = y.front().get();
+      typename array_type::shape_type shape = y_0.shape().scale(c.front());
+      for(std::size_t k = 1ul; k < y.size(); ++k) {
+        TA_USER_ASSERT(y[k].get().trange() == y_0.trange(),
+            "linear_combination(): The tiled ranges of the arrays are not equal.");
+        shape = shape.add(y[k].get().shape().scale(c[k]));
+      }
+      if(z) {
+        TA_USER_ASSERT(z->trange() == y_0.trange(),
+            "linear_combination(): The tiled ranges of the arrays are not equal.");
+        shape = shape.mult(z->shape());
+      }
+
+      World& world = y_0.world();
+      array_type result(world, y_0.trange(), shape, y_0.pmap());
+
+      // Spawn a task for each local tile that combines the non-zero
+      // argument tiles
+      for(const auto index : * result.pmap()) {
+        if(result.is_zero(index))
+          continue;
+
+        std::vector<element_type> c_index;
+        std::vector<Future<value_type> > y_index;
+        for(std::size_t k = 0ul; k < y.size(); ++k) {
+          if(y[k].get().is_zero(index))
+            continue;
+          c_index.push_back(c[k]);
+          y_index.push_back(y[k].get().find(index));
+        }
+
+        if(y_index.empty() || (z && z->is_zero(index))) {
+          // see DistArray::set(ordinal, element_type)
+          result.set(index, element_type(0));
+        } else if(z) {
+          result.set(index, world.taskq.add(
+              [] (const std::vector<element_type>& c, const std::vector<Future<value_type> >& y,
+                  const value_type& z) -> value_type
+              { return linear_combination_tiles(c, y, &z); },
+              c_index, y_index, z->find(index)));
+        } else {
+          result.set(index, world.taskq.add(
+              [] (const std::vector<element_type>& c, const std::vector<Future<value_type> >& y)
+                  -> value_type
+              { return linear_combination_tiles(c, y, static_cast<const value_type*>(nullptr)); },
+              c_index, y_index));
+        }
+      }
+
+      x = result;
+    }
+
   } // namespace detail
 
   template <typename Tile, typename Policy>
@@ -91,6 +256,201 @@ namespace TiledArray {
     return a1(vars).dot(a2(vars)).get();
   }
 
+  /// Dot products of an array with a sequence of arrays
+
+  /// Computes <tt>dot_product(a, *it)</tt> for each array in
+  /// [\c first, \c last) with one pass over the local tiles of \c a and a
+  /// single global sum, instead of one distributed reduction per array.
+  /// \tparam Tile The tile type of the arrays
+  /// \tparam Policy The policy of the arrays
+  /// \tparam InIter An input iterator type; dereferencing it must yield an
+  /// object that is convertible to <tt>const DistArray<Tile,Policy>&</tt>
+  /// \param a The left-hand array of the dot products
+  /// \param first An iterator to the first right-hand array
+  /// \param last An iterator to the end of the right-hand arrays
+  /// \return The dot products of \c a with each array, in sequence order
+  template <typename Tile, typename Policy, typename InIter>
+  inline std::vector<typename DistArray<Tile,Policy>::element_type>
+  dot_products(const DistArray<Tile,Policy>& a, InIter first, InIter last) {
+    typedef typename DistArray<Tile,Policy>::value_type value_type;
+    typedef typename DistArray<Tile,Policy>::element_type element_type;
+
+    std::vector<std::reference_wrapper<const DistArray<Tile,Policy> > > b;
+    for(; first != last; ++first) {
+      b.emplace_back(*first);
+      TA_USER_ASSERT(b.back().get().trange() == a.trange(),
+          "dot_products(): The tiled ranges of the arrays are not equal.");
+    }
+    std::vector<element_type> result(b.size(), element_type(0));
+    if(b.empty())
+      return result;
+
+    // Spawn the tile dot products of the local non-zero tiles of a
+    std::vector<std::pair<std::size_t, Future<element_type> > > dots;
+    for(const auto index : * a.pmap()) {
+      if(a.is_zero(index))
+        continue;
+      const Future<value_type> a_tile = a.find(index);
+      for(std::size_t j = 0ul; j < b.size(); ++j) {
+        if(b[j].get().is_zero(index))
+          continue;
+        dots.emplace_back(j, a.world().taskq.add(
+            [] (const value_type& left, const value_type& right) -> element_type {
+              using TiledArray::dot;
+              return dot(left, right);
+            }, a_tile, b[j].get().find(index)));
+      }
+    }
+
+    // Sum the local and then the global contributions
+    for(auto& d : dots)
+      result[d.first] += d.second.get();
+    a.world().gop.sum(result.data(), result.size());
+
+    return result;
+  }
+
+  /// Linear combination of arrays
+
+  /// Computes <tt>x = sum_k c[k] * y[k]</tt>, where \c y[k] are the arrays in
+  /// [\c first, \c last), with one task per local tile that reads each
+  /// argument tile once. This replaces chains of \c scale and \c axpy calls,
+  /// which evaluate one expression, and allocate one array, per term. The
+  /// arrays may include \c x .
+  /// \tparam Tile The tile type of the arrays
+  /// \tparam Policy The policy of the arrays
+  /// \tparam InIter An input iterator type; dereferencing it must yield an
+  /// object that is convertible to <tt>const DistArray<Tile,Policy>&</tt>
+  /// \param x The result array
+  /// \param c The coefficients of the arrays
+  /// \param first An iterator to the first array
+  /// \param last An iterator to the end of the arrays
+  template <typename Tile, typename Policy, typename InIter>
+  inline void linear_combination(DistArray<Tile,Policy>& x,
+      const std::vector<typename DistArray<Tile,Policy>::element_type>& c,
+      InIter first, InIter last)
+  {
+    detail::linear_combination(x, c, first, last,
+        static_cast<const DistArray<Tile,Policy>*>(nullptr));
+  }
+
+  /// Element-wise product of an array with a linear combination of arrays
+
+  /// Computes <tt>x = z * sum_k c[k] * y[k]</tt>, where the product with \c z
+  /// is element-wise, in the same pass as the linear combination.
+  /// \tparam Tile The tile type of the arrays
+  /// \tparam Policy The policy of the arrays
+  /// \tparam InIter An input iterator type; dereferencing it must yield an
+  /// object that is convertible to <tt>const DistArray<Tile,Policy>&</tt>
+  /// \param x The result array
+  /// \param c The coefficients of the arrays
+  /// \param first An iterator to the first array
+  /// \param last An iterator to the end of the arrays
+  /// \param z The array that multiplies the combination element-wise
+  template <typename Tile, typename Policy, typename InIter>
+  inline void linear_combination(DistArray<Tile,Policy>& x,
+      const std::vector<typename DistArray<Tile,Policy>::element_type>& c,
+      InIter first, InIter last, const DistArray<Tile,Policy>& z)
+  {
+    detail::linear_combination(x, c, first, last, &z);
+  }
+
+  /// Dot products of an object with a sequence of objects
+
+  /// Generic version, for types other than \c DistArray ; computes
+  /// <tt>dot_product(a, *it)</tt> for each object in [\c first, \c last).
+  /// \tparam D The object type
+  /// \tparam InIter An input iterator type; dereferencing it must yield an
+  /// object that is convertible to <tt>const D&</tt>
+  /// \param a The left-hand object of the dot products
+  /// \param first An iterator to the first right-hand object
+  /// \param last An iterator to the end of the right-hand objects
+  /// \return The dot products of \c a with each object, in sequence order
+  template <typename D, typename InIter>
+  inline std::vector<typename D::element_type>
+  dot_products(const D& a, InIter first, InIter last) {
+    std::vector<typename D::element_type> result;
+    for(; first != last; ++first) {
+      const D& b = *first;
+      result.push_back(dot_product(a, b));
+    }
+    return result;
+  }
+
+  /// Linear combination of objects
+
+  /// Generic version, for types other than \c DistArray ; computes
+  /// <tt>x = sum_k c[k] * y[k]</tt> with \c zero and \c axpy . The objects
+  /// may include \c x , in which case \c x is scaled in place (with
+  /// <tt>axpy(x, c - 1, x)</tt>) instead of zeroed before the other terms are
+  /// accumulated.
+  /// \tparam D The object type
+  /// \tparam InIter A forward iterator type; dereferencing it must yield an
+  /// object that is convertible to <tt>const D&</tt>
+  /// \param x The result object
+  /// \param c The coefficients of the objects
+  /// \param first An iterator to the first object
+  /// \param last An iterator to the end of the objects
+  template <typename D, typename InIter>
+  inline void linear_combination(D& x,
+      const std::vector<typename D::element_type>& c,
+      InIter first, InIter last)
+  {
+    typedef typename D::element_type element_type;
+
+    TA_USER_ASSERT(std::size_t(std::distance(first, last)) == c.size(),
+        "linear_combination(): The numbers of coefficients and objects do not match.");
+
+    // Collect the coefficient of x, if it is one of the terms
+    bool aliased = false;
+    element_type cx(0);
+    std::size_t k = 0ul;
+    for(InIter it = first; it != last; ++it, ++k) {
+      const D& y = *it;
+      if(&y == &x) {
+        aliased = true;
+        cx += c[k];
+      }
+    }
+
+    if(aliased) {
+      if(cx != element_type(1))
+        axpy(x, cx - element_type(1), x);
+    } else {
+      zero(x);
+    }
+
+    k = 0ul;
+    for(; first != last; ++first, ++k) {
+      const D& y = *first;
+      if(&y != &x)
+        axpy(x, c[k], y);
+    }
+  }
+
+  /// Element-wise product of an object with a linear combination of objects
+
+  /// Generic version, for types other than \c DistArray ; computes
+  /// <tt>x = z * sum_k c[k] * y[k]</tt> with \c zero , \c axpy , and
+  /// \c vec_multiply .
+  /// \tparam D The object type
+  /// \tparam InIter A forward iterator type; dereferencing it must yield an
+  /// object that is convertible to <tt>const D&</tt>
+  /// \param x The result object
+  /// \param c The coefficients of the objects
+  /// \param first An iterator to the first object
+  /// \param last An iterator to the end of the objects
+  /// \param z The object that multiplies the combination element-wise; it
+  /// must not be \c x
+  template <typename D, typename InIter>
+  inline void linear_combination(D& x,
+      const std::vector<typename D::element_type>& c,
+      InIter first, InIter last, const D& z)
+  {
+    linear_combination(x, c, first, last);
+    vec_multiply(x, z);
+  }
+
   template <typename Left, typename Right>
   inline typename TiledArray::expressions::ExprTrait<Left>::scalar_type
   dot(const TiledArray::expressions::Expr<Left>& a1,
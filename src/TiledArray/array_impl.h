@@ -30,6 +30,8 @@
 #include <TiledArray/distributed_storage.h>
 #include <TiledArray/transform_iterator.h>
 #include <TiledArray/type_traits.h>
+#include <TiledArray/symm/tile_symmetry.h>
+#include <TiledArray/tile_op/tile_interface.h>
 
 namespace TiledArray {
   namespace detail {
@@ -441,9 +443,28 @@ namespace TiledArray {
       typedef ArrayIterator<ArrayImpl_, reference> iterator; ///< Iterator type
       typedef ArrayIterator<const ArrayImpl_, const_reference> const_iterator; ///< Constant iterator type
 
+      typedef value_type (*image_op_type)(const value_type&,
+          const Permutation&, const int); ///< Tile image operation type
+
     private:
 
       storage_type data_; ///< Tile container
+      std::shared_ptr<const symmetry::TileSymmetry> symmetry_; ///< Tile symmetry (null if not symmetric)
+      image_op_type image_op_; ///< Operation that generates non-unique tiles
+
+      /// Generate a non-unique tile from its unique tile
+
+      /// \param tile The unique tile
+      /// \param perm The permutation that maps \c tile to the result
+      /// \param sign The sign of the result
+      /// \return <tt>sign * (perm ^ tile)</tt>
+      static value_type make_image(const value_type& tile,
+          const Permutation& perm, const int sign)
+      {
+        if(sign < 0)
+          return TiledArray::scale(tile, numeric_type(-1), perm);
+        return TiledArray::permute(tile, perm);
+      }
 
     public:
 
@@ -459,14 +480,50 @@ namespace TiledArray {
       ArrayImpl(World& world, const trange_type& trange, const shape_type& shape,
           const std::shared_ptr<pmap_interface>& pmap) :
         TensorImpl_(world, trange, shape, pmap),
-        data_(world, trange.tiles_range().volume(), pmap)
+        data_(world, trange.tiles_range().volume(), pmap),
+        symmetry_(), image_op_(nullptr)
       { }
 
       /// Virtual destructor
       virtual ~ArrayImpl() { }
 
+      /// Tile symmetry accessor
+
+      /// \return The tile symmetry of this array, or null if it is not
+      /// symmetric
+      const std::shared_ptr<const symmetry::TileSymmetry>& symmetry() const {
+        return symmetry_;
+      }
+
+      /// Set the tile symmetry
+
+      /// Only the unique tiles of a symmetric array are stored; the other
+      /// tiles are generated from the unique tiles when they are accessed.
+      /// \param symmetry The tile symmetry, or null to remove it
+      void set_symmetry(const std::shared_ptr<const symmetry::TileSymmetry>& symmetry) {
+        TA_ASSERT(! symmetry || symmetry->is_compatible(TensorImpl_::trange()));
+        symmetry_ = symmetry;
+        image_op_ = & ArrayImpl_::make_image;
+      }
+
+      /// Check for a unique tile
+
+      /// \tparam Index The index type
+      /// \param i The tile index
+      /// \return \c true if tile \c i is stored by this array, i.e. the array
+      /// is not symmetric or \c i is the unique tile of its orbit
+      template <typename Index>
+      bool is_unique(const Index& i) const {
+        if(! symmetry_)
+          return true;
+        const range_type& tiles_range = TensorImpl_::trange().tiles_range();
+        return symmetry_->is_unique(tiles_range.idx(tiles_range.ordinal(i)));
+      }
+
       /// Tile future accessor
 
+      /// When this array is symmetric and \c i is not a unique tile, the tile
+      /// is generated by a task from the unique tile of its orbit.
       /// \tparam Index The index type
       /// \param i The tile index
       /// \return A \c future to tile \c i
@@ -474,7 +531,17 @@ namespace TiledArray {
       template <typename Index>
       future get(const Index& i) const {
         TA_ASSERT(! TensorImpl_::is_zero(i));
-        return data_.get(TensorImpl_::trange().tiles_range().ordinal(i));
+        const range_type& tiles_range = TensorImpl_::trange().tiles_range();
+        if(symmetry_) {
+          const symmetry::TileSymmetry::Image image =
+              symmetry_->image(tiles_range.idx(tiles_range.ordinal(i)));
+          future tile = data_.get(tiles_range.ordinal(image.index));
+          if(! image.perm)
+            return tile;
+          return TensorImpl_::world().taskq.add(image_op_, tile, image.perm,
+              image.sign);
+        }
+        return data_.get(tiles_range.ordinal(i));
       }
 
       /// Tile future accessor
@@ -500,6 +567,7 @@ namespace TiledArray {
       template <typename Index, typename Value>
       void set(const Index& i, const Value& value) {
         TA_ASSERT(! TensorImpl_::is_zero(i));
+        TA_ASSERT(is_unique(i));
         data_.set(TensorImpl_::trange().tiles_range().ordinal(i), value);
       }
 
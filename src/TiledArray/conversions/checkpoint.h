@@ -0,0 +1,467 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  checkpoint.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_CHECKPOINT_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_CHECKPOINT_H__INCLUDED
+
+#include <tiledarray_fwd.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <TiledArray/type_traits.h>
+#include <TiledArray/tiled_range.h>
+#include <TiledArray/tensor.h>
+#include <TiledArray/tile_op/tile_interface.h>
+#include "TiledArray/dist_array.h"
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Checkpoint file header
+
+    /// A checkpoint file starts with a header that describes the array, and is
+    /// followed by the element data of each non-zero tile. The header layout
+    /// (all integers are \c std::uint64_t ) is:
+    /// \li the magic string \c "TACKPT" , the format version, and the byte
+    ///     order marker \c 0x0102030405060708 in the byte order of the writer
+    /// \li the size of the array elements in bytes
+    /// \li the rank of the tiled range, then for each dimension the number of
+    ///     tiles followed by the tile boundaries
+    /// \li the Frobenius norm of each tile, stored as \c double
+    /// \li the file offset of each tile, plus the end-of-file offset
+    ///
+    /// The data of tile \c i starts at <tt>offset[i]</tt>, and
+    /// <tt>offset[i] == offset[i + 1]</tt> marks a zero tile. Tile data is
+    /// stored in the row-major order of the tile range, and each tile starts
+    /// on a \c alignment() byte boundary so that it may be memory-mapped.
+    /// Since the offsets only depend on the tiled range and the set of zero
+    /// tiles, every process can compute them independently and read or write
+    /// its tiles without communication.
+    class CheckpointHeader {
+    public:
+      typedef std::uint64_t size_type; ///< On-disk integer type
+
+    private:
+      size_type element_size_; ///< The size of each array element
+      TiledRange trange_; ///< The tiled range of the array
+      std::vector<double> norms_; ///< Tile norms
+      std::vector<size_type> offsets_; ///< Tile offsets
+
+      /// The file signature
+      static const char* magic() { return "TACKPT"; }
+
+      /// The size of the file signature
+      static constexpr std::size_t magic_size() { return 6ul; }
+
+      /// The file format version
+      static constexpr size_type version() { return 2ul; }
+
+      /// The byte order marker
+      static constexpr size_type byte_order() { return 0x0102030405060708ul; }
+
+      /// Round \c n up to a multiple of \c alignment()
+      static size_type align(const size_type n) {
+        return (n + alignment() - 1ul) / alignment() * alignment();
+      }
+
+      template <typename T>
+      static void write_value(std::ostream& os, const T& value) {
+        os.write(reinterpret_cast<const char*>(& value), sizeof(T));
+      }
+
+      template <typename T>
+      static void read_value(std::istream& is, T& value) {
+        is.read(reinterpret_cast<char*>(& value), sizeof(T));
+      }
+
+    public:
+
+      /// The alignment of tile data in the file
+      static constexpr size_type alignment() { return 64ul; }
+
+      CheckpointHeader() = default;
+
+      /// Construct a checkpoint header
+
+      /// \param element_size The size of array elements in bytes
+      /// \param trange The tiled range of the array
+      /// \param norms The Frobenius norm of each tile, where a zero norm marks a
+      /// zero tile
+      CheckpointHeader(const size_type element_size, const TiledRange& trange,
+          std::vector<double> norms) :
+        element_size_(element_size), trange_(trange), norms_(std::move(norms)),
+        offsets_(norms_.size() + 1ul)
+      {
+        TA_ASSERT(norms_.size() == trange_.tiles_range().volume());
+
+        // Compute the offset of each tile from the size of the header
+        size_type offset = magic_size() + sizeof(size_type) * 4ul;
+        for(const auto& trange1 : trange_.data())
+          offset += sizeof(size_type) * (trange1.tiles_range().second -
+              trange1.tiles_range().first + 2ul);
+        offset += (sizeof(double) + sizeof(size_type)) * norms_.size() +
+            sizeof(size_type);
+
+        offset = align(offset);
+
+        for(size_type i = 0ul; i < norms_.size(); ++i) {
+          offsets_[i] = offset;
+          if(norms_[i] > 0.0)
+            offset += align(element_size_ * trange_.make_tile_range(i).volume());
+        }
+        offsets_.back() = offset;
+      }
+
+      /// Element size accessor
+
+      /// \return The size of array elements in bytes
+      size_type element_size() const { return element_size_; }
+
+      /// Tiled range accessor
+
+      /// \return The tiled range of the array
+      const TiledRange& trange() const { return trange_; }
+
+      /// Tile norm accessor
+
+      /// \return The Frobenius norm of each tile
+      const std::vector<double>& norms() const { return norms_; }
+
+      /// Tile offset accessor
+
+      /// \param i The ordinal index of a tile
+      /// \return The file offset of tile \c i
+      size_type offset(const size_type i) const { return offsets_[i]; }
+
+      /// Tile size accessor
+
+      /// \param i The ordinal index of a tile
+      /// \return The number of bytes of tile \c i , which is zero for zero tiles
+      size_type bytes(const size_type i) const {
+        return (offsets_[i + 1ul] > offsets_[i] ?
+            element_size_ * trange_.make_tile_range(i).volume() : 0ul);
+      }
+
+      /// Write the header to a stream
+
+      /// \param os The output stream, which must be positioned at the
+      /// beginning of the file
+      void write(std::ostream& os) const {
+        os.write(magic(), magic_size());
+        write_value(os, version());
+        write_value(os, byte_order());
+        write_value(os, element_size_);
+        write_value(os, size_type(trange_.rank()));
+        for(const auto& trange1 : trange_.data()) {
+          write_value(os, size_type(trange1.tiles_range().second -
+              trange1.tiles_range().first));
+          for(const auto& tile : trange1)
+            write_value(os, size_type(tile.first));
+          write_value(os, size_type(trange1.elements_range().second));
+        }
+        os.write(reinterpret_cast<const char*>(norms_.data()),
+            sizeof(double) * norms_.size());
+        os.write(reinterpret_cast<const char*>(offsets_.data()),
+            sizeof(size_type) * offsets_.size());
+      }
+
+      /// Read the header from a stream
+
+      /// \param is The input stream, which must be positioned at the beginning
+      /// of the file
+      /// \throw TiledArray::Exception When the stream does not contain a
+      /// checkpoint file, or the file was written with a different byte order
+      void read(std::istream& is) {
+        char signature[magic_size()];
+        is.read(signature, magic_size());
+        size_type file_version = 0ul;
+        read_value(is, file_version);
+        if(! is || std::memcmp(signature, magic(), magic_size()) ||
+            (file_version != version()))
+          TA_EXCEPTION("Invalid checkpoint file.");
+
+        size_type file_byte_order = 0ul;
+        read_value(is, file_byte_order);
+        if(file_byte_order != byte_order())
+          TA_EXCEPTION("The checkpoint file was written with a different byte order.");
+
+        read_value(is, element_size_);
+        size_type rank = 0ul;
+        read_value(is, rank);
+        std::vector<TiledRange1> ranges;
+        ranges.reserve(rank);
+        for(size_type d = 0ul; d < rank; ++d) {
+          size_type tiles = 0ul;
+          read_value(is, tiles);
+          std::vector<size_type> boundaries(tiles + 1ul);
+          is.read(reinterpret_cast<char*>(boundaries.data()),
+              sizeof(size_type) * boundaries.size());
+          ranges.emplace_back(boundaries.begin(), boundaries.end());
+        }
+        trange_ = TiledRange(ranges.begin(), ranges.end());
+
+        norms_.resize(trange_.tiles_range().volume());
+        is.read(reinterpret_cast<char*>(norms_.data()),
+            sizeof(double) * norms_.size());
+        offsets_.resize(norms_.size() + 1ul);
+        is.read(reinterpret_cast<char*>(offsets_.data()),
+            sizeof(size_type) * offsets_.size());
+        if(! is)
+          TA_EXCEPTION("Truncated checkpoint file header.");
+      }
+
+    }; // class CheckpointHeader
+
+    /// Collect the tile norms of a dense array
+
+    /// \tparam Array The array type
+    /// \param array The array
+    /// \return The Frobenius norm of each tile, summed over all processes
+    template <typename Array,
+        typename std::enable_if<is_dense<Array>::value>::type* = nullptr>
+    inline std::vector<double> checkpoint_norms(const Array& array) {
+      std::vector<double> norms(array.trange().tiles_range().volume(), 0.0);
+      for(const auto index : * array.pmap())
+        norms[index] = norm(array.find(index).get());
+      array.world().gop.sum(norms.data(), norms.size());
+      return norms;
+    }
+
+    /// Collect the tile norms of a sparse array
+
+    /// The norms are computed from the array shape, so no communication is
+    /// needed.
+    /// \tparam Array The array type
+    /// \param array The array
+    /// \return The Frobenius norm of each tile
+    template <typename Array,
+        typename std::enable_if<! is_dense<Array>::value>::type* = nullptr>
+    inline std::vector<double> checkpoint_norms(const Array& array) {
+      const auto& trange = array.trange();
+      const auto& shape_norms = array.shape().data();
+      std::vector<double> norms(trange.tiles_range().volume(), 0.0);
+      for(std::size_t i = 0ul; i < norms.size(); ++i)
+        if(! array.is_zero(i))
+          norms[i] = double(shape_norms[i]) * double(trange.make_tile_range(i).volume());
+      return norms;
+    }
+
+    /// Construct the shape of a dense array from checkpoint data
+
+    /// \return A dense shape
+    template <typename Array,
+        typename std::enable_if<is_dense<Array>::value>::type* = nullptr>
+    inline shape_t<Array> checkpoint_shape(const CheckpointHeader&) {
+      return shape_t<Array>();
+    }
+
+    /// Construct the shape of a sparse array from checkpoint data
+
+    /// \param header The checkpoint header
+    /// \return A sparse shape with the tile norms stored in the checkpoint
+    template <typename Array,
+        typename std::enable_if<! is_dense<Array>::value>::type* = nullptr>
+    inline shape_t<Array> checkpoint_shape(const CheckpointHeader& header) {
+      typedef typename shape_t<Array>::value_type value_type;
+      Tensor<value_type> norms(header.trange().tiles_range());
+      std::copy(header.norms().begin(), header.norms().end(), norms.data());
+      return shape_t<Array>(norms, header.trange());
+    }
+
+    /// Read the checkpoint header on every process
+
+    /// This collective function reads the header on every process, and the
+    /// processes agree on the result before they return, so an error on any
+    /// process is thrown by all processes.
+    /// \tparam Array The `DistArray` type
+    /// \param world The world of the array
+    /// \param filename The name of the checkpoint file
+    /// \return The checkpoint header
+    /// \throw TiledArray::Exception When the file cannot be opened on any
+    /// process, it is not a valid checkpoint file, or it was saved with a
+    /// different element type
+    template <typename Array>
+    inline CheckpointHeader read_checkpoint_header(World& world,
+        const std::string& filename)
+    {
+      CheckpointHeader header;
+      std::exception_ptr error;
+      try {
+        std::ifstream file(filename, std::ios::binary);
+        if(! file)
+          TA_EXCEPTION("Unable to open the checkpoint file.");
+        header.read(file);
+        if(header.element_size() != sizeof(typename Array::element_type))
+          TA_EXCEPTION("The checkpoint file element size does not match the array element type.");
+      } catch(...) {
+        error = std::current_exception();
+      }
+
+      int failed = (error ? 1 : 0);
+      world.gop.sum(failed);
+      if(error)
+        std::rethrow_exception(error);
+      if(failed)
+        TA_EXCEPTION("Unable to read the checkpoint file header on another process.");
+
+      return header;
+    }
+
+  } // namespace detail
+
+  /// Save an array to a checkpoint file
+
+  /// This collective function writes \c array to a binary file that stores
+  /// the tiled range, the tile norms, the offset of each tile, and the
+  /// element data of the non-zero tiles (see \c detail::CheckpointHeader ).
+  /// The header is written by process 0, then each process writes its local
+  /// tiles directly to their offsets in the file, so no tile data is
+  /// gathered. The file must be on a file system that is shared by all
+  /// processes. Tiles must store their elements contiguously, in the order of
+  /// the tile range, and the elements must be trivially copyable.
+  /// \code
+  /// TiledArray::save_array(array, "t2.tackpt");
+  /// \endcode
+  /// \tparam Tile The array tile type
+  /// \tparam Policy The array policy type
+  /// \param array The array to be saved
+  /// \param filename The name of the checkpoint file
+  /// \throw TiledArray::Exception On all processes, when the file cannot be
+  /// written
+  template <typename Tile, typename Policy>
+  inline void save_array(const DistArray<Tile, Policy>& array,
+      const std::string& filename)
+  {
+    typedef typename DistArray<Tile, Policy>::element_type element_type;
+    static_assert(std::is_trivially_copyable<element_type>::value,
+        "TiledArray::save_array() requires trivially copyable array elements.");
+
+    World& world = array.world();
+    const detail::CheckpointHeader header(sizeof(element_type), array.trange(),
+        detail::checkpoint_norms(array));
+
+    // Create the file and write the header. All processes wait for the
+    // header, and throw together if it cannot be written.
+    int failed = 0;
+    if(world.rank() == 0) {
+      std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+      header.write(file);
+      failed = (file ? 0 : 1);
+    }
+    world.gop.sum(failed);
+    if(failed)
+      TA_EXCEPTION("Unable to write the checkpoint file header.");
+
+    // Write local tiles
+    if(array.pmap()->local_size()) {
+      std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+      for(const auto index : * array.pmap()) {
+        const auto bytes = header.bytes(index);
+        if(bytes == 0ul)
+          continue;
+
+        const Tile tile = array.find(index).get();
+        TA_ASSERT(tile.range().volume() * sizeof(element_type) == bytes);
+        file.seekp(header.offset(index));
+        file.write(reinterpret_cast<const char*>(tile.data()), bytes);
+      }
+      failed = (file ? 0 : 1);
+    }
+
+    world.gop.sum(failed);
+    if(failed)
+      TA_EXCEPTION("Unable to write tiles to the checkpoint file.");
+  }
+
+  /// Load an array from a checkpoint file
+
+  /// This collective function reads an array that was written by
+  /// \c save_array . The number of processes and the process map do not
+  /// need to match those used to save the array; each process reads the
+  /// header and its local tiles directly from the file. A dense array may be
+  /// loaded from a checkpoint of a sparse array, in which case the zero tiles
+  /// are zero-filled.
+  /// \code
+  /// auto t2 = TiledArray::load_array<TiledArray::TSpArrayD>(world, "t2.tackpt");
+  /// \endcode
+  /// \tparam Array The `DistArray` type
+  /// \param world The world where the array will live
+  /// \param filename The name of the checkpoint file
+  /// \param pmap The process map of the result array; if null, the default
+  /// process map is used
+  /// \return The loaded array
+  /// \throw TiledArray::Exception On all processes, when the file is not a
+  /// valid checkpoint file, it was saved with a different element type or
+  /// byte order, or it cannot be read
+  template <typename Array>
+  inline Array load_array(World& world, const std::string& filename,
+      const std::shared_ptr<detail::pmap_t<Array> >& pmap =
+          std::shared_ptr<detail::pmap_t<Array> >())
+  {
+    typedef typename Array::value_type value_type;
+    typedef typename Array::element_type element_type;
+    static_assert(std::is_trivially_copyable<element_type>::value,
+        "TiledArray::load_array() requires trivially copyable array elements.");
+
+    const detail::CheckpointHeader header =
+        detail::read_checkpoint_header<Array>(world, filename);
+
+    Array result(world, header.trange(),
+        detail::checkpoint_shape<Array>(header), pmap);
+
+    // Read local tiles
+    std::ifstream file(filename, std::ios::binary);
+    for(const auto index : * result.pmap()) {
+      if(result.is_zero(index))
+        continue;
+
+      const auto bytes = header.bytes(index);
+      if(bytes == 0ul) {
+        result.set(index, element_type(0));
+        continue;
+      }
+
+      value_type tile(header.trange().make_tile_range(index));
+      TA_ASSERT(tile.range().volume() * sizeof(element_type) == bytes);
+      file.seekg(header.offset(index));
+      file.read(reinterpret_cast<char*>(tile.data()), bytes);
+      if(! file)
+        break;
+      result.set(index, tile);
+    }
+
+    int failed = (file ? 0 : 1);
+    world.gop.sum(failed);
+    if(failed)
+      TA_EXCEPTION("Unable to read tiles from the checkpoint file.");
+
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_CHECKPOINT_H__INCLUDED
@@ -0,0 +1,178 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  mapped_array.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_MAPPED_ARRAY_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_MAPPED_ARRAY_H__INCLUDED
+
+#include <TiledArray/conversions/checkpoint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Read-only memory mapping of a file
+
+    /// Pages are loaded from the file on first access and may be evicted by
+    /// the operating system without writing them to swap. The mapped memory
+    /// is read-only, so writing to it raises a segmentation fault.
+    class MappedFile {
+      char* data_; ///< The mapped memory
+      std::size_t size_; ///< The size of the mapping in bytes
+
+      // Not allowed
+      MappedFile(const MappedFile&);
+      MappedFile& operator=(const MappedFile&);
+
+    public:
+
+      /// Map a file into memory
+
+      /// \param filename The name of the file to be mapped
+      /// \throw TiledArray::Exception When the file cannot be mapped
+      explicit MappedFile(const std::string& filename) :
+        data_(NULL), size_(0ul)
+      {
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if(fd < 0)
+          TA_EXCEPTION("Unable to open the file to be mapped.");
+
+        struct stat file_stat;
+        if(::fstat(fd, & file_stat) == 0) {
+          size_ = file_stat.st_size;
+          void* data = ::mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+          if(data != MAP_FAILED)
+            data_ = static_cast<char*>(data);
+        }
+        ::close(fd);
+
+        if(! data_)
+          TA_EXCEPTION("Unable to map the file into memory.");
+      }
+
+      ~MappedFile() { ::munmap(data_, size_); }
+
+      /// Data accessor
+
+      /// \return A pointer to the beginning of the mapped file, which must
+      /// not be written to
+      char* data() const { return data_; }
+
+      /// Size accessor
+
+      /// \return The size of the mapped file in bytes
+      std::size_t size() const { return size_; }
+
+    }; // class MappedFile
+
+  } // namespace detail
+
+  /// Map a checkpoint file into a read-only array
+
+  /// This collective function constructs an array whose local tiles refer
+  /// directly to the memory-mapped data of a checkpoint file written by
+  /// \c save_array . No tile data is copied or read when the array is
+  /// constructed; pages are loaded from the file when the tile elements are
+  /// first accessed, and, since they are backed by the file, they can be
+  /// dropped from memory without being written to swap. Requests for remote
+  /// tiles are served by the owning process, which sends the mapped tile
+  /// data, as for any other array.
+  ///
+  /// The array is intended to hold constant data (e.g. integrals). The
+  /// mapping is read-only, so the tiles must not be modified in place;
+  /// doing so raises a segmentation fault. Expressions that use the array
+  /// as an argument construct new result tiles and are not affected.
+  /// \code
+  /// auto v = TiledArray::map_array<TiledArray::TArrayD>(world, "v_abij.tackpt");
+  /// \endcode
+  /// \tparam Array The `DistArray` type, where the tile type must be
+  /// constructible from a range, a pointer to its elements, and a
+  /// \c std::shared_ptr<void> that owns the elements (e.g. \c Tensor )
+  /// \param world The world where the array will live
+  /// \param filename The name of the checkpoint file
+  /// \param pmap The process map of the result array; if null, the default
+  /// process map is used
+  /// \return The mapped array
+  /// \throw TiledArray::Exception On all processes, when the file is not a
+  /// valid checkpoint file, it was saved with a different element type or
+  /// byte order, or it cannot be mapped
+  template <typename Array>
+  inline Array map_array(World& world, const std::string& filename,
+      const std::shared_ptr<detail::pmap_t<Array> >& pmap =
+          std::shared_ptr<detail::pmap_t<Array> >())
+  {
+    typedef typename Array::value_type value_type;
+    typedef typename Array::element_type element_type;
+    static_assert(std::is_constructible<value_type, const Range&,
+        element_type*, std::shared_ptr<void> >::value,
+        "TiledArray::map_array() requires a tile type that can wrap external data.");
+
+    const detail::CheckpointHeader header =
+        detail::read_checkpoint_header<Array>(world, filename);
+
+    Array result(world, header.trange(),
+        detail::checkpoint_shape<Array>(header), pmap);
+
+    // Map local tiles
+    std::exception_ptr error;
+    try {
+      std::shared_ptr<detail::MappedFile> mapped_file;
+      for(const auto index : * result.pmap()) {
+        if(result.is_zero(index))
+          continue;
+
+        const auto bytes = header.bytes(index);
+        if(bytes == 0ul) {
+          result.set(index, element_type(0));
+          continue;
+        }
+
+        if(! mapped_file)
+          mapped_file = std::make_shared<detail::MappedFile>(filename);
+        if(header.offset(index) + bytes > mapped_file->size())
+          TA_EXCEPTION("Truncated checkpoint file.");
+
+        element_type* const data = reinterpret_cast<element_type*>(
+            mapped_file->data() + header.offset(index));
+        result.set(index, value_type(header.trange().make_tile_range(index),
+            data, mapped_file));
+      }
+    } catch(...) {
+      error = std::current_exception();
+    }
+
+    // Throw on all processes together
+    int failed = (error ? 1 : 0);
+    world.gop.sum(failed);
+    if(error)
+      std::rethrow_exception(error);
+    if(failed)
+      TA_EXCEPTION("Unable to map the checkpoint file on another process.");
+
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_MAPPED_ARRAY_H__INCLUDED
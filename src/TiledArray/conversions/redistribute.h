@@ -0,0 +1,82 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  redistribute.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_REDISTRIBUTE_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_REDISTRIBUTE_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/pmap/balanced_pmap.h>
+
+namespace TiledArray {
+
+  /// Move the tiles of an array to a new process map
+
+  /// Each process requests the non-zero tiles that it owns in the new map
+  /// from their owners in the old map. Tiles that stay on the same process
+  /// are shallow copies of the tiles of \c arg .
+  /// \tparam Tile The tile type of the array
+  /// \tparam Policy The policy of the array
+  /// \param arg The array to be redistributed
+  /// \param pmap The process map of the result array
+  /// \return A copy of \c arg with the tiles distributed by \c pmap
+  template <typename Tile, typename Policy>
+  inline DistArray<Tile, Policy>
+  redistribute(const DistArray<Tile, Policy>& arg,
+      const std::shared_ptr<typename DistArray<Tile, Policy>::pmap_interface>& pmap)
+  {
+    TA_USER_ASSERT(pmap, "redistribute(): The process map is null.");
+    TA_USER_ASSERT(pmap->size() == arg.trange().tiles_range().volume(),
+        "redistribute(): The size of the process map does not match the number of tiles.");
+
+    // Make an empty result array
+    DistArray<Tile, Policy> result(arg.world(), arg.trange(), arg.shape(), pmap);
+
+    // Fetch the local tiles of the result
+    for(auto index : * pmap) {
+      if(arg.is_zero(index))
+        continue;
+      result.set(index, arg.find(index));
+    }
+
+    return result;
+  }
+
+  /// Balance the tiles of an array by their estimated cost
+
+  /// Redistribute \c arg with a detail::BalancedPmap constructed from its
+  /// tiled range and shape.
+  /// \tparam Tile The tile type of the array
+  /// \tparam Policy The policy of the array
+  /// \param arg The array to be balanced
+  /// \param compute_weight The weight of the compute work in the tile cost
+  /// (see detail::BalancedPmap)
+  /// \return A copy of \c arg with the tiles distributed by cost
+  template <typename Tile, typename Policy>
+  inline DistArray<Tile, Policy>
+  balance(const DistArray<Tile, Policy>& arg, const double compute_weight = 0.5) {
+    return redistribute(arg, std::make_shared<detail::BalancedPmap>(arg.world(),
+        arg.trange(), arg.shape(), compute_weight));
+  }
+
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_REDISTRIBUTE_H__INCLUDED
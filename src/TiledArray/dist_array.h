@@ -451,14 +451,15 @@ namespace TiledArray {
     void fill_random(bool skip_set = false) {
       init_elements([](const auto &) {
         return (element_type)std::rand() / RAND_MAX;
-      });
+      }, skip_set);
     }
 
     /// Initialize (local) tiles with a user provided functor
 
     /// This function is used to initialize tiles of the array via a function
     /// (or functor). The work is done in parallel, therefore \c op must be a
-    /// thread safe function/functor. The signature of the functor should be:
+    /// thread safe function/functor. Only the unique tiles of a symmetric
+    /// array are initialized. The signature of the functor should be:
     /// \code
     /// value_type op(const range_type&)
     /// \endcode
@@ -492,7 +493,7 @@ namespace TiledArray {
       const auto end = pimpl_->pmap()->end();
       for(; it != end; ++it) {
         const auto index = *it;
-        if(! pimpl_->is_zero(index)) {
+        if(! pimpl_->is_zero(index) && pimpl_->is_unique(index)) {
           if (skip_set) {
             auto fut = find(index);
             if (fut.probe())
@@ -513,7 +514,7 @@ namespace TiledArray {
     /// (or functor). The work is done in parallel, therefore \c op must be a
     /// thread safe function/functor. The signature of the functor should be:
     /// \code
-    /// value_type op(const index&)
+    /// element_type op(const index&)
     /// \endcode
     /// For example, in the following code, the array elements are initialized with
     /// random numbers from 0 to 1:
@@ -523,6 +524,8 @@ namespace TiledArray {
     ///        return (double)std::rand() / RAND_MAX;
     ///     });
     /// \endcode
+    /// The tiles are constructed with \c value_type(range) and must store
+    /// their elements contiguously, in row-major order, at \c tile.data() .
     /// \tparam Op Element generator type
     /// \param op The operation used to generate elements
     /// \param skip_set If false, will throw if any tiles are already set
@@ -531,14 +534,58 @@ namespace TiledArray {
       init_tiles([op] (const TiledArray::Range& range) -> value_type
       {
         // Initialize the tile with the given range object
-        TiledArray::Tensor<double> tile(range);
+        value_type tile(range);
+        auto* const MADNESS_RESTRICT data = tile.data();
 
         // Initialize tile elements
-        for(auto& idx: range)
-          tile[idx] = op(idx);
+        for_each_span(range, [&] (index& idx, const size_type offset,
+            const size_type n)
+        {
+          auto& i = idx.back();
+          for(size_type j = 0ul; j < n; ++j, ++i)
+            data[offset + j] = op(idx);
+        });
+
+        return tile;
+      }, skip_set);
+    }
 
+    /// Initialize (local) elements with a user provided span functor
+
+    /// This function is the same as \c init_elements , except that \c op
+    /// initializes a contiguous span of elements along the last dimension
+    /// of a tile in each call, so the per element index arithmetic and
+    /// function call overhead is avoided. The signature of the functor should
+    /// be:
+    /// \code
+    /// void op(const index& first, element_type* data, size_type n)
+    /// \endcode
+    /// where \c first is the index of the first element of the span, and
+    /// \c data points to the \c n elements of the span. For example, in the
+    /// following code, each element is initialized with its last coordinate:
+    /// \code
+    /// array.init_spans([] (const auto& first, double* data, std::size_t n)
+    ///     {
+    ///        for(std::size_t j = 0ul; j < n; ++j)
+    ///          data[j] = first.back() + j;
+    ///     });
+    /// \endcode
+    /// The tiles are constructed with \c value_type(range) and must store
+    /// their elements contiguously, in row-major order, at \c tile.data() .
+    /// \tparam Op Span generator type
+    /// \param op The operation used to generate spans of elements
+    /// \param skip_set If false, will throw if any tiles are already set
+    template <typename Op>
+    void init_spans(Op&& op, bool skip_set = false) {
+      init_tiles([op] (const TiledArray::Range& range) -> value_type
+      {
+        value_type tile(range);
+        auto* const data = tile.data();
+        for_each_span(range, [&] (const index& first, const size_type offset,
+            const size_type n)
+        { op(first, data + offset, n); });
         return tile;
-       });
+      }, skip_set);
     }
 
     /// Tiled range accessor
@@ -667,6 +714,62 @@ namespace TiledArray {
     /// \throw TiledArray::Exception When the Array is dense.
     inline const shape_type& shape() const {  return pimpl_->shape(); }
 
+    /// Set the permutational symmetry of the tiles
+
+    /// A symmetric array stores only the unique tile of each orbit of the
+    /// symmetry group; the other tiles are generated from the unique tiles,
+    /// by permutation and sign, when they are accessed with \c find() .
+    /// Only unique tiles may be set, and the tiles of a symmetric array that
+    /// is the target of an expression are evaluated only for the unique
+    /// tiles, so the expression must have the symmetry of the array. The
+    /// symmetry must be set on all processes before any tile is set.
+    /// \code
+    /// TiledArray::TArrayD t(world, trange);
+    /// t.set_symmetry(TiledArray::symmetry::TileSymmetry(4,
+    ///     { {TiledArray::symmetry::Permutation{1,0}, -1},
+    ///       {TiledArray::symmetry::Permutation{0,1,3,2}, -1} }));
+    /// t("a,b,i,j") = g("a,b,k,l") * u("k,l,i,j");
+    /// \endcode
+    /// \param symmetry The tile symmetry
+    /// \throw TiledArray::Exception When the permuted dimensions of the
+    /// array do not have the same tiling.
+    void set_symmetry(const symmetry::TileSymmetry& symmetry) {
+      set_symmetry(std::make_shared<const symmetry::TileSymmetry>(symmetry));
+    }
+
+    /// Set the permutational symmetry of the tiles
+
+    /// \param symmetry The tile symmetry, or null to remove it
+    /// \throw TiledArray::Exception When the permuted dimensions of the
+    /// array do not have the same tiling.
+    void set_symmetry(const std::shared_ptr<const symmetry::TileSymmetry>& symmetry) {
+      check_pimpl();
+      TA_USER_ASSERT(! symmetry || symmetry->is_compatible(pimpl_->trange()),
+          "The tile symmetry permutes dimensions of the array that are not tiled equally.");
+      pimpl_->set_symmetry(symmetry);
+    }
+
+    /// Tile symmetry accessor
+
+    /// \return The tile symmetry of this array, or null if it is not
+    /// symmetric
+    std::shared_ptr<const symmetry::TileSymmetry> symmetry() const {
+      check_pimpl();
+      return pimpl_->symmetry();
+    }
+
+    /// Check for a unique tile
+
+    /// \tparam Index A coordinate or ordinal index type
+    /// \param i The coordinate or ordinal index of a tile
+    /// \return \c true if tile \c i is stored by this array, i.e. the array
+    /// is not symmetric or \c i is the unique tile of its orbit
+    template <typename Index>
+    bool is_unique(const Index& i) const {
+      check_index(i);
+      return pimpl_->is_unique(i);
+    }
+
     /// Tile ownership
 
     /// \tparam Index An index type
@@ -739,23 +842,96 @@ namespace TiledArray {
     /// \param other The array to be swapped with this array.
     void swap(DistArray_& other) { std::swap(pimpl_, other.pimpl_); }
 
+  private:
+
+    /// Visit the spans of elements along the last dimension of a range
+
+    /// \c op is called, in row-major order, for each span with the
+    /// signature:
+    /// \code
+    /// void op(index& first, size_type offset, size_type n)
+    /// \endcode
+    /// where \c first is the index of the first element of the span,
+    /// \c offset is its ordinal offset in \c range , and \c n is the
+    /// extent of the last dimension. \c op may change the last coordinate
+    /// of \c first .
+    /// \tparam Op The span operation type
+    /// \param range The range to visit
+    /// \param op The span operation
+    template <typename Op>
+    static void for_each_span(const TiledArray::Range& range, Op&& op) {
+      const size_type volume = range.volume();
+      if(volume == 0ul)
+        return;
+
+      const int last = int(range.rank()) - 1;
+      const auto* MADNESS_RESTRICT const lower = range.lobound_data();
+      const auto* MADNESS_RESTRICT const upper = range.upbound_data();
+      const size_type n = range.extent_data()[last];
+
+      index first(lower, lower + last + 1);
+      for(size_type offset = 0ul; offset < volume; offset += n) {
+        op(first, offset, n);
+        first[last] = lower[last];
+
+        // Increment the outer coordinates
+        for(int d = last - 1; d >= 0; --d) {
+          if(++first[d] < upper[d])
+            break;
+          first[d] = lower[d];
+        }
+      }
+    }
+
+    /// Replicate the tiles of this array with the shared memory replicator
+    void replicate_shared(DistArray_& result, std::true_type) {
+      auto replicator =
+          std::make_shared<detail::SharedReplicator<DistArray_>>(*this, result);
+      TA_ASSERT(replicator.unique()); // Required for deferred_cleanup
+      madness::detail::deferred_cleanup(world(), replicator);
+    }
+
+    /// Replicate the tiles of this array with the ring replicator
+
+    /// This is used when the tiles cannot be stored in shared memory.
+    void replicate_shared(DistArray_& result, std::false_type) {
+      auto replicator =
+          std::make_shared<detail::Replicator<DistArray_>>(*this, result, true);
+      TA_ASSERT(replicator.unique()); // Required for deferred_cleanup
+      madness::detail::deferred_cleanup(world(), replicator);
+    }
+
+  public:
+
     /// Convert a distributed array into a replicated array
-    void make_replicated() {
+
+    /// \param mode The replication algorithm (see ReplicationMode), which is
+    /// \c direct unless \c TA_REPLICATION selects another mode. In the
+    /// \c shared mode, the processes on a host share one read-only copy of
+    /// the tiles, which must not be modified in place, and the world is
+    /// fenced; tile types that cannot wrap external memory are replicated
+    /// with the \c ring mode.
+    void make_replicated(const ReplicationMode mode = detail::replication_mode()) {
       check_pimpl();
       if((! pimpl_->pmap()->is_replicated()) && (world().size() > 1)) {
         // Construct a replicated array
         auto pmap = std::make_shared<detail::ReplicatedPmap>(world(), size());
         DistArray_ result = DistArray_(world(), trange(), shape(), pmap);
 
-        // Create the replicator object that will do an all-to-all broadcast of
-        // the local tile data.
-        auto replicator =
-            std::make_shared<detail::Replicator<DistArray_>>(*this, result);
-
-        // Put the replicator pointer in the deferred cleanup object so it will
-        // be deleted at the end of the next fence.
-        TA_ASSERT(replicator.unique()); // Required for deferred_cleanup
-        madness::detail::deferred_cleanup(world(), replicator);
+        if(mode == ReplicationMode::shared) {
+          replicate_shared(result, std::integral_constant<bool,
+              detail::SharedReplicator<DistArray_>::is_supported>());
+        } else {
+          // Create the replicator object that will broadcast the local tile
+          // data.
+          auto replicator = std::make_shared<detail::Replicator<DistArray_>>(
+              *this, result, mode == ReplicationMode::ring);
+
+          // Put the replicator pointer in the deferred cleanup object so it
+          // will be deleted at the end of the next fence.
+          TA_ASSERT(replicator.unique()); // Required for deferred_cleanup
+          madness::detail::deferred_cleanup(world(), replicator);
+        }
 
         DistArray_::operator=(result);
       }
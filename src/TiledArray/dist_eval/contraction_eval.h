@@ -24,10 +24,15 @@
 
 #include <TiledArray/config.h>
 #include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/dist_eval/summa_epilogue.h>
+#include <TiledArray/dist_eval/summa_sparse_index.h>
+#include <TiledArray/dist_eval/summa_stats.h>
+#include <TiledArray/math/batched_gemm.h>
 #include <TiledArray/proc_grid.h>
 #include <TiledArray/reduce_task.h>
 #include <TiledArray/type_traits.h>
 #include <TiledArray/shape.h>
+#include <TiledArray/symm/tile_symmetry.h>
 
 //#define TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL 1
 //#define TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE 1
@@ -48,7 +53,12 @@ namespace TiledArray {
     /// dimensional cyclic distribution, and that the row phase of the left-hand
     /// argument and the column phase of the right-hand argument are equal to
     /// the number of rows and columns, respectively, in the \c ProcGrid object
-    /// passed to the constructor.
+    /// passed to the constructor. When the process grid has more than one
+    /// layer (2.5D SUMMA), the inner dimension of the arguments is
+    /// partitioned among the layers, as by \c ProcGrid::make_row_phase_pmap
+    /// and \c ProcGrid::make_col_phase_pmap . Each layer performs the SUMMA
+    /// iterations for its block of the inner dimension, and the partial
+    /// results are reduced onto layer 0, which holds the result tiles.
     template <typename Left, typename Right, typename Op, typename Policy>
     class Summa :
         public DistEvalImpl<typename Op::result_type, Policy>,
@@ -68,15 +78,19 @@ namespace TiledArray {
       typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
       typedef typename DistEvalImpl_::eval_type eval_type; ///< Tile evaluation type
       typedef Op op_type; ///< Tile evaluation operator type
+      typedef TimedContractOp<op_type> contract_op_type; ///< Tile contraction operator type
 
     private:
       static size_type max_memory_; ///< Maximum memory used per node
       static size_type max_depth_; ///< Maximum number of concurrent SUMMA iterations
+      static size_type max_layers_; ///< Maximum number of process layers
+      static bool adaptive_depth_; ///< Adapt the number of concurrent SUMMA iterations at runtime
 
       // Arguments and operation
       left_type left_; ///< The left-hand argument
       right_type right_; /// < The right-hand argument
-      op_type op_; /// < The operation used to evaluate tile-tile contractions
+      std::shared_ptr<SummaCounters> counters_; ///< Runtime measurements (null if not adaptive or traced)
+      contract_op_type op_; /// < The operation used to evaluate tile-tile contractions
 
       // Broadcast groups for dense arguments (empty for non-dense arguments)
       madness::Group row_group_; ///< The row process group for this rank
@@ -85,9 +99,15 @@ namespace TiledArray {
       // Dimension information
       const size_type k_; ///< Number of tiles in the inner dimension
       const ProcGrid proc_grid_; ///< Process grid for this contraction
+      const size_type k_begin_; ///< The first inner tile evaluated by this process's layer
+      const size_type k_end_; ///< The end of the inner tiles evaluated by this process's layer
 
       // Contraction results
-      ReducePairTask<op_type>* reduce_tasks_; ///< A pointer to the reduction tasks
+      ReducePairTask<contract_op_type>* reduce_tasks_; ///< A pointer to the reduction tasks
+      const bool batch_; ///< Contract the tile pairs of each result tile in batches
+
+      // Index of the non-zero tiles (null for dense results)
+      std::shared_ptr<const SummaSparseIndex> sparse_index_; ///< The non-zero argument and result tiles used by this process
 
       // Constants used to iterate over columns and rows of left_ and right_, respectively.
       const size_type left_start_local_; ///< The starting point of left column iterator ranges (just add k for specific columns)
@@ -97,6 +117,18 @@ namespace TiledArray {
       const size_type right_stride_; ///< Stride for right row iterators
       const size_type right_stride_local_; ///< stride for local right row iterators
 
+      // Iteration depth control
+      size_type depth_; ///< The current number of concurrent SUMMA iterations
+      size_type depth_limit_; ///< The maximum number of concurrent SUMMA iterations
+      bool memory_bound_; ///< The depth limit is set by the memory limit
+      SummaStats stats_; ///< Statistics of this evaluation
+
+      // Result symmetry
+      const std::shared_ptr<const symmetry::TileSymmetry> symmetry_; ///< Symmetry of the result tiles (null if not symmetric)
+
+      // Fused additive terms
+      const std::shared_ptr<SummaEpilogue<value_type> > epilogue_; ///< Terms added to the result tiles (null if not fused)
+
 
       typedef Future<typename right_type::eval_type> right_future; ///< Future to a right-hand argument tile
       typedef Future<typename left_type::eval_type> left_future; ///< Future to a left-hand argument tile
@@ -165,63 +197,95 @@ namespace TiledArray {
       }
 
 
+      /// Initialize max_layers_ limit for SUMMA
+
+      /// Process layers are opt-in: the default is a single layer (2D SUMMA),
+      /// and \c TA_SUMMA_MAX_LAYERS may be set to a larger limit, or to 0 for
+      /// no limit.
+      static size_type init_max_layers() {
+        const char* max_layers = getenv("TA_SUMMA_MAX_LAYERS");
+        if(max_layers)
+          return std::stoul(max_layers);
+        return 1ul;
+      }
+
+
+      static bool init_adaptive_depth() {
+        const char* adaptive_depth = getenv("TA_SUMMA_ADAPTIVE_DEPTH");
+        if(adaptive_depth)
+          return std::stoi(adaptive_depth) != 0;
+        return false;
+      }
+
+
+      /// Check if the tile pairs are contracted in batches
+
+      /// The tile pairs of each result tile are contracted in batches when
+      /// the average tile GEMM is smaller than
+      /// \c math::batched_contraction_threshold() . The average \c m*n*k is
+      /// estimated from the average tile volumes of the arguments and the
+      /// result, \f$ \sqrt{(mk)(kn)(mn)} \f$ .
+      /// \param left The left-hand argument
+      /// \param right The right-hand argument
+      /// \param trange The tiled range of the result
+      /// \return \c true if the tile pairs are contracted in batches
+      static bool use_batched_contraction(const left_type& left,
+          const right_type& right, const trange_type& trange)
+      {
+        const double threshold = math::batched_contraction_threshold();
+        const double left_volume = average_tile_volume(left.trange());
+        const double right_volume = average_tile_volume(right.trange());
+        const double result_volume = average_tile_volume(trange);
+        return (threshold > 0.0) && (left_volume > 0.0) && (right_volume > 0.0)
+            && (result_volume > 0.0)
+            && (std::sqrt(left_volume * right_volume * result_volume) < threshold);
+      }
+
+      /// The average number of elements in the tiles of a tiled range
+      template <typename TRange>
+      static double average_tile_volume(const TRange& trange) {
+        const double tiles = trange.tiles_range().volume();
+        return (tiles > 0.0 ? double(trange.elements_range().volume()) / tiles : 0.0);
+      }
+
+
       // Process groups --------------------------------------------------------
 
       /// Process group factory function
 
       /// This function generates a sparse process group.
-      /// \tparam Shape The shape type
+      /// \tparam NonZero The non-zero process predicate type
       /// \tparam ProcMap The process map operation type
-      /// \param shape The shape that will be used to select processes that are
-      /// included in the process group
+      /// \param is_nonzero A predicate that returns \c true if the process
+      /// with the given row/column index in this process's row/column owns
+      /// non-zero tiles that are broadcast
       /// \param process_mask the process mask, if
-      ///        \code process_mask[p] == true \endcode,
+      ///        \code process_mask[p] == false \endcode,
       ///        process \c p will not be included in the result (p is row/col index
       ///        in this process's row/column)
-      /// \param index The first index of the row or column range
-      /// \param end The end of the row or column range
-      /// \param stride The row or column index stride
-      /// \param k The broadcast group index
       /// \param max_group_size The maximum number of processes in the result
       /// group, which is equal to the number of process in this process row or
       /// column as defined by \c proc_grid_.
+      /// \param k The broadcast group index
       /// \param key_offset The key that will be used to identify the process group
       /// \param proc_map The operator that will convert a process row/column
       /// index into the absolute process index (ProcessID)
       /// \return A sparse process group that includes process in the row or
       /// column of this process as defined by \c proc_grid_.
-      template <typename Shape, typename ProcMap>
-      madness::Group make_group(const Shape& shape, const std::vector<bool>& process_mask, size_type index,
-          const size_type end, const size_type stride, const size_type max_group_size,
+      template <typename NonZero, typename ProcMap>
+      madness::Group make_group(const NonZero& is_nonzero,
+          const std::vector<bool>& process_mask, const size_type max_group_size,
           const size_type k, const size_type key_offset, const ProcMap& proc_map) const
       {
-        // Generate the list of processes in rank_row
-        std::vector<ProcessID> proc_list(max_group_size, -1);
-
-        // Flag the root processes of the broadcast, which may not be included
-        // by shape.
-        size_type p = k % max_group_size;
-        proc_list[p] = proc_map(p);
-        size_type count = 1ul;
-
-        // Flag all processes that have non-zero tiles
-        for(p = 0ul; (index < end) && (count < max_group_size); index += stride,
-            p = (p + 1u) % max_group_size)
-        {
-          if((proc_list[p] != -1) || (shape.is_zero(index)) || !process_mask.at(p)) continue;
-
-          proc_list[p] = proc_map(p);
-          ++count;
-        }
-
-        // Remove processes from the list that will not be in the group
-        for(size_type x = 0ul, p = 0ul; x < count; ++p) {
-          if(proc_list[p] == -1) continue;
-          proc_list[x++] = proc_list[p];
-        }
-
-        // Truncate invalid process id's
-        proc_list.resize(count);
+        // Generate the list of processes in rank_row, which includes the root
+        // process of the broadcast, that may not be included by the shape,
+        // and all processes that have non-zero tiles.
+        const size_type root = k % max_group_size;
+        std::vector<ProcessID> proc_list;
+        proc_list.reserve(max_group_size);
+        for(size_type p = 0ul; p < max_group_size; ++p)
+          if((p == root) || (process_mask.at(p) && is_nonzero(p)))
+            proc_list.push_back(proc_map(p));
 
         return madness::Group(TensorImpl_::world(), proc_list,
             madness::DistributedID(DistEvalImpl_::id(), k + key_offset));
@@ -232,18 +296,18 @@ namespace TiledArray {
       /// \param k The broadcast group index
       /// \return A row process group
       madness::Group make_row_group(const size_type k) const {
-        // Construct the sparse broadcast group
-        const size_type right_begin_k = k * proc_grid_.cols();
-        const size_type right_end_k = right_begin_k + proc_grid_.cols();
+        TA_ASSERT(sparse_index_);
+
         // make the row mask; using the same mask for all tiles avoids having to compute mask
         // for every tile and use of masked broadcasts
         auto result_row_mask_k = make_row_mask(k);
 
         // return empty group if I am not in this group, otherwise make a group
         if (result_row_mask_k[proc_grid_.rank_col()])
-          return make_group(right_.shape(), result_row_mask_k, right_begin_k, right_end_k,
-                            right_stride_, proc_grid_.proc_cols(), k, k_,
-                            [&](const ProcGrid::size_type col) { return proc_grid_.map_col(col); });
+          return make_group(
+              [&](const size_type col) { return sparse_index_->row_nonzero(k, col); },
+              result_row_mask_k, proc_grid_.proc_cols(), k, k_,
+              [&](const ProcGrid::size_type col) { return proc_grid_.map_col(col); });
         else
           return madness::Group();
       }
@@ -254,6 +318,7 @@ namespace TiledArray {
       /// \param k The broadcast group index
       /// \return A column process group
       madness::Group make_col_group(const size_type k) const {
+        TA_ASSERT(sparse_index_);
 
         // make the column mask; using the same mask for all tiles avoids having to compute mask
         // for every tile and use of masked broadcasts
@@ -261,9 +326,10 @@ namespace TiledArray {
 
         // return empty group if I am not in this group, otherwise make a group
         if (result_col_mask_k[proc_grid_.rank_row()])
-          return make_group(left_.shape(), result_col_mask_k, k, left_end_, left_stride_,
-                            proc_grid_.proc_rows(), k, 0ul,
-                            [&](const ProcGrid::size_type row) { return proc_grid_.map_row(row); });
+          return make_group(
+              [&](const size_type row) { return sparse_index_->col_nonzero(k, row); },
+              result_col_mask_k, proc_grid_.proc_rows(), k, 0ul,
+              [&](const ProcGrid::size_type row) { return proc_grid_.map_row(row); });
         else
           return madness::Group();
       }
@@ -280,7 +346,6 @@ namespace TiledArray {
         // nonzero C[i][*] located on that node
 
         const auto nproc_cols = proc_grid_.proc_cols();
-        const auto my_proc_row = proc_grid_.rank_row();
 
         // result shape
         const auto& result_shape = TensorImpl_::shape();
@@ -292,44 +357,19 @@ namespace TiledArray {
         // initialize the mask
         std::vector<bool> mask(nproc_cols, false);
 
-        // number of tiles in the col dimension of the result
-        const auto nj = proc_grid_.cols();
-        // number of tiles in contraction dim
-        const auto nk = k_;
-
-        // for each i assigned to my row of processes ...
-        size_type i_start, i_fence, i_stride;
-        std::tie(i_start, i_fence, i_stride) =
-            result_row_range(my_proc_row);
-        const auto ik_stride = i_stride * nk;
-        for (size_type i = i_start, ik = i_start * nk + k; i < i_fence;
-             i += i_stride, ik += ik_stride) {
-          // ... such that A[i][k] exists ...
-          if (!left_.shape().is_zero(ik)) {
-            // ... the owner of А[i][k] is always in the group ...
-            const auto k_proc_col = k % nproc_cols;
-            mask[k_proc_col] = true;
-            // ... loop over processes in my row ...
-            for (size_type proc_col = 0; proc_col != nproc_cols; ++proc_col) {
-              // ... that are not the owner of A[i][k] ...
-              if (proc_col != k_proc_col) {
-                // ... loop over all C[i][j] tiles that belong to this process ...
-                size_type j_start, j_fence, j_stride;
-                std::tie(j_start, j_fence, j_stride) =
-                    result_col_range(proc_col);
-                const auto ij_stride = j_stride;
-                for (size_type j = j_start, ij = i * nj + j_start; j < j_fence;
-                     j += j_stride, ij += ij_stride) {
-                  // ... if any such C[i][j] exists, update the mask, and move
-                  // on to next process
-                  if (!result_shape.is_zero(DistEvalImpl_::perm_index_to_target(ij))) {
-                    mask[proc_col] = true;
-                    break;
-                  }
-                }
-              }
-            }
-          }
+        // for each local i (i.e. assigned to my row of processes) such that
+        // A[i][k] exists ...
+        const auto k_proc_col = k % nproc_cols;
+        for (const size_type* it = sparse_index_->col_begin(k),
+             *const end = sparse_index_->col_end(k); it != end; ++it) {
+          // ... the owner of А[i][k] is always in the group ...
+          mask[k_proc_col] = true;
+          // ... and the processes in my row that are not the owner of A[i][k]
+          // are included if they hold any C[i][j] that exists
+          for (size_type proc_col = 0; proc_col != nproc_cols; ++proc_col)
+            if (proc_col != k_proc_col &&
+                sparse_index_->result_row_nonzero(*it, proc_col))
+              mask[proc_col] = true;
         }
 
         return mask;
@@ -349,7 +389,6 @@ namespace TiledArray {
         // nonzero C[*][j] located on that node
 
         const auto nproc_rows = proc_grid_.proc_rows();
-        const auto my_proc_col = proc_grid_.rank_col();
 
         // result shape
         const auto& result_shape = TensorImpl_::shape();
@@ -361,75 +400,24 @@ namespace TiledArray {
         // initialize the mask
         std::vector<bool> mask(nproc_rows, false);
 
-        // number of tiles in col dim of the result
-        const auto nj = proc_grid_.cols();
-
-        // for each j assigned to my column of processes ...
-        size_type j_start, j_fence, j_stride;
-        std::tie(j_start, j_fence, j_stride) = result_col_range(my_proc_col);
-        const auto kj_stride = j_stride;
-        for (size_type j = j_start, kj = k * nj + j_start; j < j_fence;
-             j += j_stride, kj += kj_stride) {
-          // ... such that B[k][j] exists ...
-          if (!right_.shape().is_zero(kj)) {
-            // ... the owner of B[k][j] is always in the group ...
-            auto k_proc_row = k % nproc_rows;
-            mask[k_proc_row] = true;
-            // ... loop over processes in my col ...
-            for (size_type proc_row = 0; proc_row != nproc_rows; ++proc_row) {
-              // ... that are not the owner of B[k][j] ...
-              if (proc_row != k_proc_row) {
-                // ... loop over all C[i][j] tiles that belong to this process
-                size_type i_start, i_fence, i_stride;
-                std::tie(i_start, i_fence, i_stride) =
-                    result_row_range(proc_row);
-                const auto ij_stride = i_stride * nj;
-                for (size_type i = i_start, ij = i_start * nj + j; i < i_fence;
-                     i += i_stride, ij += ij_stride) {
-                  // ... if any such C[i][j] exists, update the mask, and move
-                  // on to next process
-                  if (!result_shape.is_zero(
-                          DistEvalImpl_::perm_index_to_target(ij))) {
-                    mask[proc_row] = true;
-                    break;
-                  }
-                }
-              }
-            }
-          }
+        // for each local j (i.e. assigned to my column of processes) such
+        // that B[k][j] exists ...
+        const auto k_proc_row = k % nproc_rows;
+        for (const size_type* it = sparse_index_->row_begin(k),
+             *const end = sparse_index_->row_end(k); it != end; ++it) {
+          // ... the owner of B[k][j] is always in the group ...
+          mask[k_proc_row] = true;
+          // ... and the processes in my col that are not the owner of B[k][j]
+          // are included if they hold any C[i][j] that exists
+          for (size_type proc_row = 0; proc_row != nproc_rows; ++proc_row)
+            if (proc_row != k_proc_row &&
+                sparse_index_->result_col_nonzero(*it, proc_row))
+              mask[proc_row] = true;
         }
 
         return mask;
       }
 
-      /// computes the result row iteration range for a particular processor
-
-      /// \param proc_row the process row in \c this->proc_grid_
-      /// \return the {start,fence,stride} tuple which defines the iteration
-      ///         range for the row indices of the result tiles residing on
-      ///         process in row \c proc_row
-      inline std::tuple<size_type, size_type, size_type> result_row_range(
-          size_type proc_row) const {
-        const size_type start = proc_row;
-        const size_type fence = proc_grid_.rows();
-        const size_type stride = proc_grid_.proc_rows();
-        return std::make_tuple(start, fence, stride);
-      }
-
-      /// computes the result column iteration range for a particular processor
-
-      /// \param proc_col the process column in \c this->proc_grid_
-      /// \return the {start,fence,stride} tuple which defines the iteration
-      ///         range for the column indices of the result tiles residing on
-      ///         process in column \c proc_col
-      std::tuple<size_type, size_type, size_type> result_col_range(
-          size_type proc_col) const {
-        const size_type start = proc_col;
-        const size_type fence = proc_grid_.cols();
-        const size_type stride = proc_grid_.proc_cols();
-        return std::make_tuple(start, fence, stride);
-      }
-
       // Broadcast kernels -----------------------------------------------------
 
       /// Tile conversion task function
@@ -508,13 +496,50 @@ namespace TiledArray {
         TA_ASSERT(vec.size() > 0ul);
       }
 
+      /// Collect the non-zero tiles of \c arg listed by the sparse index
+
+      /// \tparam Arg The argument type
+      /// \tparam Datum The vector datum type
+      /// \param[in] arg The owner of the input tiles
+      /// \param[in] start The index of the first tile of the row or column
+      /// \param[in] stride The stride between tile indices of the row or column
+      /// \param[in] first A pointer to the first local offset of the non-zero
+      /// tiles
+      /// \param[in] last A pointer to the end of the local offsets of the
+      /// non-zero tiles
+      /// \param[out] vec The vector that will hold broadcast tiles
+      template <typename Arg, typename Datum>
+      void get_vector(Arg& arg, const size_type start, const size_type stride,
+          const size_type* first, const size_type* const last,
+          std::vector<Datum>& vec) const
+      {
+        TA_ASSERT(vec.size() == 0ul);
+
+        // Iterate over the non-zero tiles
+        if(arg.is_local(start)) {
+          for(; first != last; ++first)
+            vec.emplace_back(*first, get_tile(arg, start + *first * stride));
+        } else {
+          for(; first != last; ++first)
+            vec.emplace_back(*first, Future<typename Arg::eval_type>());
+        }
+
+        TA_ASSERT(vec.size() > 0ul);
+      }
+
       /// Collect non-zero tiles from column \c k of \c left_
 
       /// \param[in] k The column to be retrieved
       /// \param[out] col The column vector that will hold the tiles
       void get_col(const size_type k, std::vector<col_datum>& col) const {
-        col.reserve(proc_grid_.local_rows());
-        get_vector(left_, left_start_local_ + k, left_end_, left_stride_local_, col);
+        if(sparse_index_) {
+          col.reserve(sparse_index_->col_size(k));
+          get_vector(left_, left_start_local_ + k, left_stride_local_,
+              sparse_index_->col_begin(k), sparse_index_->col_end(k), col);
+        } else {
+          col.reserve(proc_grid_.local_rows());
+          get_vector(left_, left_start_local_ + k, left_end_, left_stride_local_, col);
+        }
       }
 
       /// Collect non-zero tiles from row \c k of \c right_
@@ -522,14 +547,37 @@ namespace TiledArray {
       /// \param[in] k The row to be retrieved
       /// \param[out] row The row vector that will hold the tiles
       void get_row(const size_type k, std::vector<row_datum>& row) const {
-        row.reserve(proc_grid_.local_cols());
-
         // Compute local iteration limits for row k of right_.
         size_type begin = k * proc_grid_.cols();
         const size_type end = begin + proc_grid_.cols();
         begin += proc_grid_.rank_col();
 
-        get_vector(right_, begin, end, right_stride_local_, row);
+        if(sparse_index_) {
+          row.reserve(sparse_index_->row_size(k));
+          get_vector(right_, begin, right_stride_local_,
+              sparse_index_->row_begin(k), sparse_index_->row_end(k), row);
+        } else {
+          row.reserve(proc_grid_.local_cols());
+          get_vector(right_, begin, end, right_stride_local_, row);
+        }
+      }
+
+      /// Check that the tiles of column \c k of \c left_ are local
+
+      /// \param k The column of \c left_
+      /// \return \c true if the tiles of column \c k that are used by this
+      /// process are owned by this process
+      bool is_local_col(const size_type k) const {
+        return left_.is_local(left_start_local_ + k);
+      }
+
+      /// Check that the tiles of row \c k of \c right_ are local
+
+      /// \param k The row of \c right_
+      /// \return \c true if the tiles of row \c k that are used by this
+      /// process are owned by this process
+      bool is_local_row(const size_type k) const {
+        return right_.is_local(k * proc_grid_.cols() + proc_grid_.rank_col());
       }
 
       /// Broadcast tiles from \c arg
@@ -587,7 +635,7 @@ namespace TiledArray {
       ProcessID get_row_group_root(const size_type k, const madness::Group& row_group) const {
         ProcessID group_root = k % proc_grid_.proc_cols();
         if(! right_.shape().is_dense() && row_group.size() < static_cast<ProcessID>(proc_grid_.proc_cols())) {
-          const ProcessID world_root = proc_grid_.rank_row() * proc_grid_.proc_cols() + group_root;
+          const ProcessID world_root = proc_grid_.map_col(group_root);
           group_root = row_group.rank(world_root);
         }
         return group_root;
@@ -596,7 +644,7 @@ namespace TiledArray {
       ProcessID get_col_group_root(const size_type k, const madness::Group& col_group) const {
         ProcessID group_root = k % proc_grid_.proc_rows();
         if(! left_.shape().is_dense() && col_group.size() < static_cast<ProcessID>(proc_grid_.proc_rows())) {
-          const ProcessID world_root = group_root * proc_grid_.proc_cols() + proc_grid_.rank_col();
+          const ProcessID world_root = proc_grid_.map_row(group_root);
           group_root = col_group.rank(world_root);
         }
         return group_root;
@@ -632,14 +680,16 @@ namespace TiledArray {
       }
 
       void bcast_col_range_task(size_type k, const size_type end) const {
-        // Compute the first local row of right
+        TA_ASSERT(sparse_index_);
+
+        // Compute the first local column of left
         const size_type Pcols = proc_grid_.proc_cols();
         k += (Pcols - ((k + Pcols - proc_grid_.rank_col()) % Pcols)) % Pcols;
 
         for(; k < end; k += Pcols) {
 
           // Compute local iteration limits for column k of left_.
-          size_type index = left_start_local_ + k;
+          const size_type start = left_start_local_ + k;
 
           // will create broadcast group only if needed
           bool have_group = false;
@@ -647,9 +697,10 @@ namespace TiledArray {
           ProcessID group_root;
           bool do_broadcast;
 
-          // Search column k of left for non-zero tiles
-          for(; index < left_end_; index += left_stride_local_) {
-            if(left_.shape().is_zero(index)) continue;
+          // Iterate over the non-zero tiles of column k of left
+          for(const size_type* it = sparse_index_->col_begin(k),
+              *const it_end = sparse_index_->col_end(k); it != it_end; ++it) {
+            const size_type index = start + *it * left_stride_local_;
 
             // Construct broadcast group, if needed
             if (!have_group) {
@@ -675,6 +726,8 @@ namespace TiledArray {
       }
 
       void bcast_row_range_task(size_type k, const size_type end) const {
+        TA_ASSERT(sparse_index_);
+
         // Compute the first local row of right
         const size_type Prows = proc_grid_.proc_rows();
         k += (Prows - ((k + Prows - proc_grid_.rank_row()) % Prows)) % Prows;
@@ -682,9 +735,7 @@ namespace TiledArray {
         for(; k < end; k += Prows) {
 
           // Compute local iteration limits for row k of right_.
-          size_type index = k * proc_grid_.cols();
-          const size_type row_end = index + proc_grid_.cols();
-          index += proc_grid_.rank_col();
+          const size_type start = k * proc_grid_.cols() + proc_grid_.rank_col();
 
           // will create broadcast group only if needed
           bool have_group = false;
@@ -692,9 +743,10 @@ namespace TiledArray {
           ProcessID group_root;
           bool do_broadcast;
 
-          // Search for and broadcast non-zero row
-          for(; index < row_end; index += right_stride_local_) {
-            if(right_.shape().is_zero(index)) continue;
+          // Iterate over the non-zero tiles of row k of right and broadcast
+          for(const size_type* it = sparse_index_->row_begin(k),
+              *const it_end = sparse_index_->row_end(k); it != it_end; ++it) {
+            const size_type index = start + *it * right_stride_local_;
 
             // Construct broadcast group
             if (!have_group) {
@@ -729,19 +781,15 @@ namespace TiledArray {
       /// non-zero tiles in this processes column.
       /// \param k The first row to search
       /// \return The first row, greater than or equal to \c k with non-zero
-      /// tiles, or \c k_ if none is found.
+      /// tiles, or \c k_end_ if none is found.
       size_type iterate_row(size_type k) const {
+        TA_ASSERT(sparse_index_);
+
         // Iterate over k's until a non-zero tile is found or the end of the
         // matrix is reached.
-        size_type end = k * proc_grid_.cols();
-        for(; k < k_; ++k) {
-          // Search for non-zero tiles in row k of right
-          size_type i = end + proc_grid_.rank_col();
-          end += proc_grid_.cols();
-          for(; i < end; i += right_stride_local_)
-            if(! right_.shape().is_zero(i))
-              return k;
-        }
+        for(; k < k_end_; ++k)
+          if(sparse_index_->row_size(k))
+            return k;
 
         return k;
       }
@@ -753,15 +801,15 @@ namespace TiledArray {
       /// checks for non-zero tiles in this process's row.
       /// \param k The first column to test for non-zero tiles
       /// \return The first column, greater than or equal to \c k, that contains
-      /// a non-zero tile. If no non-zero tile is not found, return \c k_.
+      /// a non-zero tile. If no non-zero tile is not found, return \c k_end_.
       size_type iterate_col(size_type k) const {
+        TA_ASSERT(sparse_index_);
+
         // Iterate over k's until a non-zero tile is found or the end of the
         // matrix is reached.
-        for(; k < k_; ++k)
-          // Search row k for non-zero tiles
-          for(size_type i = left_start_local_ + k; i < left_end_; i += left_stride_local_)
-            if(! left_.shape().is_zero(i))
-              return k;
+        for(; k < k_end_; ++k)
+          if(sparse_index_->col_size(k))
+            return k;
 
         return k;
       }
@@ -825,12 +873,25 @@ namespace TiledArray {
 
       // Initialization functions ----------------------------------------------
 
+      /// Check for a result tile that is not evaluated
+
+      /// \tparam Shape The shape type
+      /// \param shape The result shape
+      /// \param perm_index The result tile index, in the target index space
+      /// \return \c true if the result tile is zero or, when the result is
+      /// symmetric, not a unique tile
+      template <typename Shape>
+      bool is_skipped(const Shape& shape, const size_type perm_index) const {
+        return shape.is_zero(perm_index) || (symmetry_ && ! symmetry_->is_unique(
+            TensorImpl_::trange().tiles_range().idx(perm_index)));
+      }
+
       /// Initialize reduce tasks and construct broadcast groups
-      size_type initialize(const DenseShape&) {
+      size_type initialize(const DenseShape& shape) {
         // Construct static broadcast groups for dense arguments
-        const madness::DistributedID col_did(DistEvalImpl_::id(), 0ul);
+        const madness::DistributedID col_did(DistEvalImpl_::id(), k_begin_);
         col_group_ = proc_grid_.make_col_group(col_did);
-        const madness::DistributedID row_did(DistEvalImpl_::id(), k_);
+        const madness::DistributedID row_did(DistEvalImpl_::id(), k_ + k_begin_);
         row_group_ = proc_grid_.make_row_group(row_did);
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
@@ -846,16 +907,21 @@ namespace TiledArray {
         printf(ss.str().c_str());
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
 
+        // Skip the non-unique tiles of a symmetric result
+        if(symmetry_)
+          return initialize<DenseShape>(shape);
+
         // Allocate memory for the reduce pair tasks.
-        std::allocator<ReducePairTask<op_type> > alloc;
+        std::allocator<ReducePairTask<contract_op_type> > alloc;
         reduce_tasks_ = alloc.allocate(proc_grid_.local_size());
 
         // Iterate over all local tiles
         const size_type n = proc_grid_.local_size();
         for(size_type t = 0ul; t < n; ++t) {
           // Initialize the reduction task
-          ReducePairTask<op_type>* MADNESS_RESTRICT const reduce_task = reduce_tasks_ + t;
-          new(reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+          ReducePairTask<contract_op_type>* MADNESS_RESTRICT const reduce_task = reduce_tasks_ + t;
+          new(reduce_task) ReducePairTask<contract_op_type>(TensorImpl_::world(),
+              op_, nullptr, batch_);
         }
 
         return proc_grid_.local_size();
@@ -871,7 +937,7 @@ namespace TiledArray {
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
 
         // Allocate memory for the reduce pair tasks.
-        std::allocator<ReducePairTask<op_type> > alloc;
+        std::allocator<ReducePairTask<contract_op_type> > alloc;
         reduce_tasks_ = alloc.allocate(proc_grid_.local_size());
 
         // Initialize iteration variables
@@ -886,7 +952,7 @@ namespace TiledArray {
 
         // Iterate over all local tiles
         size_type tile_count = 0ul;
-        ReducePairTask<op_type>* MADNESS_RESTRICT reduce_task = reduce_tasks_;
+        ReducePairTask<contract_op_type>* MADNESS_RESTRICT reduce_task = reduce_tasks_;
         // this loops over result tiles arranged in block-cyclic order
         // index = tile index (row major)
         for(; row_start < end; row_start += col_stride, row_end += col_stride) {
@@ -894,18 +960,19 @@ namespace TiledArray {
 
             // Initialize the reduction task
 
-            // Skip zero tiles
-            if(! shape.is_zero(DistEvalImpl_::perm_index_to_target(index))) {
+            // Skip zero and non-unique tiles
+            if(! is_skipped(shape, DistEvalImpl_::perm_index_to_target(index))) {
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
               ss << index << " ";
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
 
-              new(reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+              new(reduce_task) ReducePairTask<contract_op_type>(TensorImpl_::world(),
+                  op_, nullptr, batch_);
               ++tile_count;
             } else {
               // Construct an empty task to represent zero tiles.
-              new(reduce_task) ReducePairTask<op_type>();
+              new(reduce_task) ReducePairTask<contract_op_type>();
             }
           }
         }
@@ -935,8 +1002,88 @@ namespace TiledArray {
 
       // Finalize functions ----------------------------------------------------
 
+      /// Layer reduction key factory function
+
+      /// \param layer The layer that holds the partial result
+      /// \param index The result tile index
+      /// \return The key used to send the partial result tile of \c layer to
+      /// layer 0, which does not overlap with the keys used for broadcasts or
+      /// result tiles
+      madness::DistributedID layer_key(const size_type layer, const size_type index) const {
+        return madness::DistributedID(DistEvalImpl_::id(), left_.size() +
+            right_.size() + layer * TensorImpl_::size() + index);
+      }
+
+      /// Add two partial result tiles
+
+      /// \param left The first partial result tile
+      /// \param right The second partial result tile
+      /// \return The sum of \c left and \c right , where empty tiles are
+      /// treated as zero
+      static value_type reduce_layer(const value_type& left, const value_type& right) {
+        using TiledArray::empty;
+        if(empty(right))
+          return left;
+        if(empty(left))
+          return right;
+
+        using TiledArray::add;
+        return add(left, right);
+      }
+
+      /// Set a result tile
+
+      /// With a single process layer, the result of \c reduce_task is the
+      /// result tile. Otherwise, layer 0 sets the sum of the partial results
+      /// of all layers, and the other layers send their partial results to
+      /// layer 0. Reduce tasks without arguments, which occur when a layer has
+      /// no non-zero contributions to a tile, are not submitted and yield an
+      /// empty partial result. When additive terms are fused with this
+      /// contraction, which requires a single layer, the tile is passed to
+      /// the epilogue before it is set.
+      /// \param index The result tile index
+      /// \param perm_index The permuted result tile index
+      /// \param reduce_task The reduce task of the tile
+      void finalize_tile(const size_type index, const size_type perm_index,
+          ReducePairTask<contract_op_type>& reduce_task)
+      {
+        if(proc_grid_.proc_layers() == 1u) {
+          if(epilogue_)
+            DistEvalImpl_::set_tile(perm_index, (*epilogue_)(perm_index,
+                reduce_task.count() ? reduce_task.submit() :
+                Future<value_type>(value_type())));
+          else
+            DistEvalImpl_::set_tile(perm_index, reduce_task.submit());
+          return;
+        }
+
+        World& world = TensorImpl_::world();
+        Future<value_type> tile = (reduce_task.count() ? reduce_task.submit() :
+            Future<value_type>(value_type()));
+
+        if(proc_grid_.rank_layer() == 0) {
+          // Reduce the partial results of the other layers
+          for(size_type layer = 1ul; layer < proc_grid_.proc_layers(); ++layer) {
+            Future<value_type> partial = world.gop.template recv<value_type>(
+                proc_grid_.map_layer(layer), layer_key(layer, index));
+            tile = world.taskq.add(& Summa_::reduce_layer, tile, partial,
+                madness::TaskAttributes::hipri());
+          }
+
+          DistEvalImpl_::set_tile(perm_index, tile);
+        } else {
+          world.gop.send(proc_grid_.map_layer(0), layer_key(proc_grid_.rank_layer(), index), tile);
+        }
+      }
+
       /// Set the result tiles, destroy reduce tasks, and destroy broadcast groups
-      void finalize(const DenseShape&) {
+      void finalize(const DenseShape& shape) {
+        // Skip the non-unique tiles of a symmetric result
+        if(symmetry_) {
+          finalize<DenseShape>(shape);
+          return;
+        }
+
         // Initialize iteration variables
         size_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
         size_type row_end = row_start + proc_grid_.cols();
@@ -948,22 +1095,22 @@ namespace TiledArray {
         const size_type end = TensorImpl_::size();
 
         // Iterate over all local tiles
-        for(ReducePairTask<op_type>* reduce_task = reduce_tasks_;
+        for(ReducePairTask<contract_op_type>* reduce_task = reduce_tasks_;
             row_start < end; row_start += col_stride, row_end += col_stride) {
           for(size_type index = row_start; index < row_end; index += row_stride, ++reduce_task) {
 
 
             // Set the result tile
-            DistEvalImpl_::set_tile(DistEvalImpl_::perm_index_to_target(index),
-                reduce_task->submit());
+            finalize_tile(index, DistEvalImpl_::perm_index_to_target(index),
+                *reduce_task);
 
             // Destroy the reduce task
-            reduce_task->~ReducePairTask<op_type>();
+            reduce_task->~ReducePairTask<contract_op_type>();
           }
         }
 
         // Deallocate the memory for the reduce pair tasks.
-        std::allocator<ReducePairTask<op_type> >().deallocate(reduce_tasks_,
+        std::allocator<ReducePairTask<contract_op_type> >().deallocate(reduce_tasks_,
             proc_grid_.local_size());
       }
 
@@ -987,30 +1134,33 @@ namespace TiledArray {
         const size_type end = TensorImpl_::size();
 
         // Iterate over all local tiles
-        for(ReducePairTask<op_type>* reduce_task = reduce_tasks_;
+        for(ReducePairTask<contract_op_type>* reduce_task = reduce_tasks_;
             row_start < end; row_start += col_stride, row_end += col_stride) {
           for(size_type index = row_start; index < row_end; index += row_stride, ++reduce_task) {
             // Compute the permuted index
             const size_type perm_index = DistEvalImpl_::perm_index_to_target(index);
 
-            // Skip zero tiles
-            if(! shape.is_zero(perm_index)) {
+            // Skip zero and non-unique tiles
+            if(! is_skipped(shape, perm_index)) {
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
               ss << index << " ";
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
 
               // Set the result tile
-              DistEvalImpl_::set_tile(perm_index, reduce_task->submit());
+              finalize_tile(index, perm_index, *reduce_task);
+            } else if(epilogue_) {
+              // Cleanup unused tiles of the fused terms
+              epilogue_->discard(perm_index);
             }
 
             // Destroy the reduce task
-            reduce_task->~ReducePairTask<op_type>();
+            reduce_task->~ReducePairTask<contract_op_type>();
           }
         }
 
         // Deallocate the memory for the reduce pair tasks.
-        std::allocator<ReducePairTask<op_type> >().deallocate(reduce_tasks_,
+        std::allocator<ReducePairTask<contract_op_type> >().deallocate(reduce_tasks_,
             proc_grid_.local_size());
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
@@ -1019,12 +1169,49 @@ namespace TiledArray {
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
       }
 
+      /// Classify the performance regime and record the statistics and trace
+
+      /// The evaluation is memory bound when the largest depth reached the
+      /// depth limit set by the memory limit. Otherwise, it is communication
+      /// bound when the broadcast latency of an iteration is longer than the
+      /// local contractions of the other iterations in flight can hide, and
+      /// compute bound when it is not.
+      void finalize_stats() {
+        stats_.layers = proc_grid_.proc_layers();
+        stats_.depth_limit = depth_limit_;
+        stats_.final_depth = depth_;
+        stats_.adaptive = adaptive_depth_;
+        stats_.regime = SummaStats::unknown;
+        if(counters_ && stats_.iterations) {
+          stats_.bcast_latency = counters_->latency();
+          stats_.gemm_time = double(counters_->gemm_ns.load()) * 1.0e-9 /
+              double(stats_.iterations * std::max(madness::ThreadPool::size(), 1));
+          if(counters_->latency_count.load() && counters_->gemm_count.load())
+            stats_.regime = (stats_.bcast_latency >
+                double(stats_.final_depth - 1ul) * stats_.gemm_time ?
+                SummaStats::communication_bound : SummaStats::compute_bound);
+        }
+        if(memory_bound_ && (stats_.max_depth >= depth_limit_))
+          stats_.regime = SummaStats::memory_bound;
+
+        set_summa_stats(stats_);
+
+        // Set the contraction profile data, which is stored when all tile
+        // operations are finished
+        if(counters_) {
+          counters_->rank = TensorImpl_::world().rank();
+          counters_->layers = stats_.layers;
+          counters_->iterations = stats_.iterations;
+        }
+      }
+
       void finalize() {
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
         printf("finalize: start rank=%i\n", TensorImpl_::world().rank());
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
 
         finalize(TensorImpl_::shape());
+        finalize_stats();
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
         printf("finalize: finish rank=%i\n", TensorImpl_::world().rank());
@@ -1061,10 +1248,16 @@ namespace TiledArray {
       /// \param col A column of tiles from the left-hand argument
       /// \param row A row of tiles from the right-hand argument
       /// \param task The task that depends on tile contraction tasks
-      void contract(const DenseShape&, const size_type,
+      void contract(const DenseShape& shape, const size_type k,
           const std::vector<col_datum>& col, const std::vector<row_datum>& row,
           madness::TaskInterface* const task)
       {
+        // Skip the non-unique tiles of a symmetric result
+        if(symmetry_) {
+          contract<DenseShape>(shape, k, col, row, task);
+          return;
+        }
+
         // Iterate over the row
         for(size_type i = 0ul; i < col.size(); ++i) {
           // Compute the local, result-tile offset
@@ -1186,6 +1379,60 @@ namespace TiledArray {
       { contract(TensorImpl_::shape(), k, col, row, task); }
 
 
+      // Iteration depth control ----------------------------------------------
+
+      /// Adapt the number of concurrent SUMMA iterations
+
+      /// When the adaptive depth controller is enabled, the number of
+      /// iterations needed to hide the broadcast latency is estimated from the
+      /// average broadcast latency of an iteration and the average time of the
+      /// local contractions of an iteration, which are measured while the
+      /// contraction is evaluated. The depth is increased when it is smaller
+      /// than the estimate, and decreased when it is larger than the estimate
+      /// by more than one, so that fewer argument tiles are held in memory.
+      /// The depth never exceeds the depth limit. This function is called
+      /// once by each SUMMA iteration, in order.
+      /// \param pairs The number of tile pairs contracted in this iteration
+      /// \return 1 if the depth should be increased, -1 if it should be
+      /// decreased, or 0 if it should not change
+      int adapt_depth(const size_type pairs) {
+        ++stats_.iterations;
+        if(! adaptive_depth_)
+          return 0;
+
+        const std::uint64_t latency_count = counters_->latency_count.load();
+        const std::uint64_t gemm_count = counters_->gemm_count.load();
+        if((latency_count == 0ul) || (gemm_count == 0ul) || (pairs == 0ul))
+          return 0;
+
+        // Estimate the time of the local contractions of this iteration
+        const double latency = counters_->latency();
+        const double gemm_iter = counters_->gemm_time() * double(pairs) /
+            double(std::max(madness::ThreadPool::size(), 1));
+
+        // Compute the number of iterations needed to hide the broadcasts
+        size_type target = (gemm_iter > 0.0 ?
+            size_type(std::min(std::ceil(latency / gemm_iter), double(depth_limit_))) :
+            depth_limit_) + 1ul;
+        target = std::max(size_type(1), std::min(target, depth_limit_));
+
+        int result = 0;
+        if(target > depth_) {
+          ++depth_;
+          ++stats_.grow_count;
+          stats_.max_depth = std::max(stats_.max_depth, depth_);
+          result = 1;
+        } else if((target + 1ul < depth_) && (depth_ >= 2ul)) {
+          --depth_;
+          ++stats_.shrink_count;
+          stats_.min_depth = std::min(stats_.min_depth, depth_);
+          result = -1;
+        }
+
+        return result;
+      }
+
+
       // SUMMA step task -------------------------------------------------------
 
 
@@ -1274,8 +1521,8 @@ namespace TiledArray {
         void make_next_step_tasks(Derived* task, size_type depth) {
           TA_ASSERT(depth > 0);
           // Set the depth to be no greater than the maximum number steps
-          if(depth > owner_->k_)
-            depth = owner_->k_;
+          if(depth > (owner_->k_end_ - owner_->k_begin_))
+            depth = owner_->k_end_ - owner_->k_begin_;
 
           // Spawn n=depth step tasks
           for(; depth > 0ul; --depth) {
@@ -1294,16 +1541,39 @@ namespace TiledArray {
           printf("step:  start rank=%i k=%lu\n", owner_->world().rank(), k);
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
 
-          if(k < owner_->k_) {
+          if(k < owner_->k_end_) {
+            // Adjust the number of concurrent iterations
+            const int adapt = owner_->adapt_depth(col_.size() * row_.size());
+
             // Initialize next tail task and submit next task
             TA_ASSERT(next_step_task_);
-            next_step_task_->tail_step_task_ =
-                new Derived(static_cast<Derived*>(tail_step_task_), 1);  // <- ndep=1, will control its scheduling by this task
-            // submit next step task ... even if it's same as tail_step_task_ it is safe to submit
-            // because its ndep > 0 (see StepTask::make_next_step_tasks)
-            TA_ASSERT(tail_step_task_->ndep() > 0);
-            world_.taskq.add(next_step_task_);
-            next_step_task_ = nullptr;
+            if(adapt < 0) {
+              // Shrink: the current tail task also waits for the next step,
+              // which takes ownership of it.
+              next_step_task_->tail_step_task_ = tail_step_task_;
+            } else {
+              Derived* tail = static_cast<Derived*>(tail_step_task_);
+              if(adapt > 0) {
+                // Grow: insert a step task that waits only for its parent
+                tail = new Derived(tail, 1);
+                if (trace_tasks)
+                  tail->notify_debug("StepTask nth ctor");
+                else
+                  tail->notify();
+              }
+              next_step_task_->tail_step_task_ =
+                  new Derived(tail, 1);  // <- ndep=1, will control its scheduling by this task
+              // submit next step task ... even if it's same as tail_step_task_ it is safe to submit
+              // because its ndep > 0 (see StepTask::make_next_step_tasks)
+              TA_ASSERT(tail_step_task_->ndep() > 0);
+              world_.taskq.add(next_step_task_);
+              next_step_task_ = nullptr;
+            }
+
+            // Measure the broadcast latency of this step
+            if(owner_->counters_)
+              LatencyProbe<col_datum, row_datum>::start(owner_->counters_, k,
+                  col_, ! owner_->is_local_col(k), row_, ! owner_->is_local_row(k));
 
             // Start broadcast of column and row tiles for this step
             world_.taskq.add(owner_, & Summa_::bcast_col, k, col_, row_group,
@@ -1314,12 +1584,19 @@ namespace TiledArray {
             // Submit tasks for the contraction of col and row tiles.
             owner_->contract(k, col_, row_, tail_step_task_);
 
-            // Notify task dependencies
-            TA_ASSERT(tail_step_task_);
-            if (trace_tasks)
-              tail_step_task_->notify_debug("StepTask nth ctor");
-            else
-              tail_step_task_->notify();
+            if(adapt < 0) {
+              // The next step task notifies the tail task, so it must not be
+              // submitted before the contraction tasks depend on the tail.
+              world_.taskq.add(next_step_task_);
+              next_step_task_ = nullptr;
+            } else {
+              // Notify task dependencies
+              TA_ASSERT(tail_step_task_);
+              if (trace_tasks)
+                tail_step_task_->notify_debug("StepTask nth ctor");
+              else
+                tail_step_task_->notify();
+            }
             finalize_task_->notify();
 
           } else if(finalize_task_) {
@@ -1357,7 +1634,7 @@ namespace TiledArray {
 
       public:
         DenseStepTask(const std::shared_ptr<Summa_>& owner, const size_type depth) :
-          StepTask(owner, owner->k_ + 1ul), k_(0)
+          StepTask(owner, owner->k_end_ - owner->k_begin_ + 1ul), k_(owner->k_begin_)
         {
           StepTask::make_next_step_tasks(this, depth);
           StepTask::spawn_get_row_col_tasks(k_);
@@ -1367,7 +1644,7 @@ namespace TiledArray {
           StepTask(parent, ndep), k_(parent->k_ + 1ul)
         {
           // Spawn tasks to get k-th row and column tiles
-          if(k_ < owner_->k_)
+          if(k_ < owner_->k_end_)
             StepTask::spawn_get_row_col_tasks(k_);
         }
 
@@ -1396,7 +1673,7 @@ namespace TiledArray {
           k = owner_->iterate_sparse(k + offset);
           k_.set(k);
 
-          if(k < owner_->k_) {
+          if(k < owner_->k_end_) {
             // NOTE: The order of task submissions is dependent on the order in
             // which we want the tasks to complete.
 
@@ -1434,13 +1711,13 @@ namespace TiledArray {
           else
             madness::DependencyInterface::inc();
           world_.taskq.add(this, & SparseStepTask::iterate_task,
-              0ul, 0ul, madness::TaskAttributes::hipri());
+              owner->k_begin_, 0ul, madness::TaskAttributes::hipri());
         }
 
         SparseStepTask(SparseStepTask* const parent, const int ndep) :
           StepTask(parent, ndep)
         {
-          if(parent->k_.probe() && (parent->k_.get() >= owner_->k_)) {
+          if(parent->k_.probe() && (parent->k_.get() >= owner_->k_end_)) {
             // Avoid running extra tasks if not needed.
             k_.set(parent->k_.get());
             MADNESS_ASSERT(ndep == 1);  // ensure that this does not get executed immediately
@@ -1477,28 +1754,109 @@ namespace TiledArray {
       /// \param k The number of tiles in the inner dimension
       /// \param proc_grid The process grid that defines the layout of the tiles
       ///                  during the contraction evaluation
+      /// \param symmetry The symmetry of the result tiles; when it is given,
+      ///                 only the unique result tiles are evaluated and the
+      ///                 other tiles may not be retrieved
+      /// \param epilogue The additive terms that are fused with the result
+      ///                 tiles; it requires a single process layer, no
+      ///                 symmetry, and a process map that places each result
+      ///                 tile on its process in \c proc_grid
       /// \note The trange, shape, and pmap refer to the final,
       ///       permuted, state for the result, NOT to the result during
       ///       the SUMMA evaluation.
       Summa(const left_type& left, const right_type& right,
           World& world, const trange_type trange, const shape_type& shape,
           const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
-          const op_type& op, const size_type k, const ProcGrid& proc_grid) :
+          const op_type& op, const size_type k, const ProcGrid& proc_grid,
+          const std::shared_ptr<const symmetry::TileSymmetry>& symmetry = nullptr,
+          const std::shared_ptr<SummaEpilogue<value_type> >& epilogue = nullptr) :
         DistEvalImpl_(world, trange, shape, pmap, perm),
-        left_(left), right_(right), op_(op),
+        left_(left), right_(right),
+        counters_(adaptive_depth_ || ContractionTrace::enabled() ?
+            std::make_shared<SummaCounters>(ContractionTrace::enabled()) : nullptr),
+        op_(op, counters_),
         row_group_(), col_group_(),
         k_(k), proc_grid_(proc_grid),
+        k_begin_(proc_grid.local_size() ?
+            proc_grid.layer_begin(k, proc_grid.rank_layer()) : 0ul),
+        k_end_(proc_grid.local_size() ?
+            proc_grid.layer_begin(k, proc_grid.rank_layer() + 1) : 0ul),
         reduce_tasks_(NULL),
+        batch_(use_batched_contraction(left, right, trange)),
+        sparse_index_(),
         left_start_local_(proc_grid_.rank_row() * k),
         left_end_(left.size()),
         left_stride_(k),
         left_stride_local_(proc_grid.proc_rows() * k),
         right_stride_(1ul),
-        right_stride_local_(proc_grid.proc_cols())
-      { }
+        right_stride_local_(proc_grid.proc_cols()),
+        depth_(0ul), depth_limit_(0ul), memory_bound_(false), stats_(),
+        symmetry_(symmetry), epilogue_(epilogue)
+      {
+        TA_ASSERT(! epilogue || ((proc_grid.proc_layers() == 1u) && ! symmetry));
+      }
 
       virtual ~Summa() { }
 
+      /// Select the number of process layers for a contraction
+
+      /// With \c c process layers (2.5D SUMMA), each layer of \c P/c
+      /// processes performs the SUMMA iterations for \c 1/c of the inner
+      /// dimension, and the partial results are reduced onto layer 0. This
+      /// reduces the broadcast volume by a factor of \f$\sqrt{c}\f$ at the
+      /// cost of \c c copies of the result. The number of layers is chosen to
+      /// minimize the estimated communication volume per process,
+      /// \f[
+      ///   W(c) = \frac{Kk(Mm + Nn)}{\sqrt{cP}} + \frac{c(c-1)MmNn}{P},
+      /// \f]
+      /// subject to \f$c^3 \le P\f$, \f$c \le K\f$, the memory limit set by
+      /// \c TA_SUMMA_MAX_MEMORY , and the layer limit set by
+      /// \c TA_SUMMA_MAX_LAYERS , which is 1 by default, so multiple layers
+      /// are only used when they are enabled explicitly. The estimated memory
+      /// requirement per process is that of the arguments plus \c c copies of
+      /// the partial results held by layer 0.
+      /// \param nprocs The number of processes
+      /// \param k The number of tiles in the inner dimension
+      /// \param row_size The number of element rows of the result (\f$Mm\f$)
+      /// \param col_size The number of element columns of the result (\f$Nn\f$)
+      /// \param inner_size The number of elements in the inner dimension (\f$Kk\f$)
+      /// \return The number of process layers
+      static size_type layers(const size_type nprocs, const size_type k,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size)
+      {
+        // Compute the maximum number of layers
+        size_type max_layers = std::cbrt(double(nprocs)) + 1.0e-6;
+        max_layers = std::min(max_layers, k);
+        if(max_layers_)
+          max_layers = std::min(max_layers, max_layers_);
+
+        const double P = nprocs;
+        const double Mm = row_size;
+        const double Nn = col_size;
+        const double Kk = inner_size;
+        const double element_size =
+            sizeof(typename numeric_type<value_type>::type);
+
+        size_type result = 1ul;
+        double min_cost = Kk * (Mm + Nn) / std::sqrt(P);
+        for(size_type c = 2ul; c <= max_layers; ++c) {
+          // Check that the replicated result fits in memory
+          if(max_memory_ && ((element_size * (Kk * (Mm + Nn) + double(c * c) * Mm * Nn) / P)
+              > double(max_memory_)))
+            break;
+
+          const double cost = Kk * (Mm + Nn) / std::sqrt(double(c) * P)
+              + double(c * (c - 1ul)) * Mm * Nn / P;
+          if(cost < min_cost) {
+            result = c;
+            min_cost = cost;
+          }
+        }
+
+        return result;
+      }
+
       /// Get tile at index \c i
 
       /// \param i The index of the tile
@@ -1508,6 +1866,7 @@ namespace TiledArray {
       virtual Future<value_type> get_tile(size_type i) const {
         TA_ASSERT(TensorImpl_::is_local(i));
         TA_ASSERT(! TensorImpl_::is_zero(i));
+        TA_ASSERT(! is_skipped(TensorImpl_::shape(), i));
 
         const size_type source_index = DistEvalImpl_::perm_index_to_source(i);
 
@@ -1559,9 +1918,10 @@ namespace TiledArray {
               proc_grid_.local_cols() * (1.0f - right_sparsity);
 
           // Compute the maximum number of iterations based on available memory
-          const size_type mem_bound_depth =
-              ((local_memory_per_iter_left + local_memory_per_iter_right) /
-              available_memory);
+          const std::size_t local_memory_per_iter =
+              local_memory_per_iter_left + local_memory_per_iter_right;
+          const size_type mem_bound_depth = (local_memory_per_iter ?
+              available_memory / local_memory_per_iter : depth);
 
           // Check if the memory bounded depth is less than the optimal depth
           if(depth > mem_bound_depth) {
@@ -1578,6 +1938,7 @@ namespace TiledArray {
                          "!! WARNING TiledArray: Performance may be slow.\n");
               default:
                 depth = mem_bound_depth;
+                memory_bound_ = true;
             }
           }
         }
@@ -1585,6 +1946,34 @@ namespace TiledArray {
         return depth;
       }
 
+      /// Initialize the iteration depth limit
+
+      /// The number of concurrent iterations is limited by the number of
+      /// blocks in the k dimension of this layer, the available memory, and
+      /// the user defined depth bound, \c TA_SUMMA_MAX_DEPTH .
+      /// \param left_sparsity The fraction of zero tiles in the left-hand matrix
+      /// \param right_sparsity The fraction of zero tiles in the right-hand matrix
+      void init_depth_limit(const float left_sparsity, const float right_sparsity) {
+        depth_limit_ = mem_bound_depth(k_end_ - k_begin_, left_sparsity, right_sparsity);
+        if(max_depth_ && (max_depth_ < depth_limit_)) {
+          depth_limit_ = max_depth_;
+          memory_bound_ = false;
+        }
+      }
+
+      /// Initialize the iteration depth
+
+      /// \param depth The unbounded iteration depth
+      /// \return The initial iteration depth
+      size_type init_depth(size_type depth) {
+        depth = std::max(size_type(1), std::min(depth, depth_limit_));
+        depth_ = depth;
+        stats_.initial_depth = depth;
+        stats_.min_depth = depth;
+        stats_.max_depth = depth;
+        return depth;
+      }
+
       /// Evaluate the tiles of this tensor
 
       /// This function will evaluate the children of this distributed evaluator
@@ -1600,6 +1989,8 @@ namespace TiledArray {
         // Start evaluate child tensors
         left_.eval();
         right_.eval();
+        if(epilogue_)
+          epilogue_->eval();
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
         printf("eval: finished eval children rank=%i\n", TensorImpl_::world().rank());
@@ -1609,6 +2000,11 @@ namespace TiledArray {
         if(proc_grid_.local_size() > 0ul) {
           tile_count = initialize();
 
+          // Only layer 0 sets result tiles, the other layers send their
+          // partial results to layer 0.
+          if(proc_grid_.rank_layer() != 0)
+            tile_count = 0ul;
+
           // depth controls the number of simultaneous SUMMA iterations
           // that are scheduled.
 
@@ -1619,20 +2015,25 @@ namespace TiledArray {
 
           // Construct the first SUMMA iteration task
           if(TensorImpl_::shape().is_dense()) {
-            // We cannot have more iterations than there are blocks in the k
-            // dimension
-            if(depth > k_) depth = k_;
-
-            // Modify the number of concurrent iterations based on the available
-            // memory.
-            depth = mem_bound_depth(depth, 0.0f, 0.0f);
-
-            // Enforce user defined depth bound
-            if(max_depth_) std::min(depth, max_depth_);
+            // Bound the number of concurrent iterations by the number of
+            // blocks in the k dimension of this layer, the available memory,
+            // and the user defined depth bound.
+            init_depth_limit(0.0f, 0.0f);
+            depth = init_depth(depth);
 
             TensorImpl_::world().taskq.add(new DenseStepTask(shared_from_this(),
                                                              depth));
           } else {
+            // Index the non-zero argument and result tiles of this process,
+            // which are used to enumerate the contributing tile pairs and the
+            // sparse broadcast groups of each iteration.
+            const auto& result_shape = TensorImpl_::shape();
+            sparse_index_ = std::make_shared<const SummaSparseIndex>(
+                proc_grid_, k_, k_begin_, k_end_, left_.shape(), right_.shape(),
+                result_shape.is_dense(), [&](const size_type ij) {
+                  return result_shape.is_zero(DistEvalImpl_::perm_index_to_target(ij));
+                });
+
             // Increase the depth based on the amount of sparsity in an iteration.
 
             // Get the sparsity fractions for the left- and right-hand arguments.
@@ -1646,16 +2047,12 @@ namespace TiledArray {
             // Compute the new depth based on sparsity of the arguments
             depth = float(depth) * (1.0f - 1.35638f * std::log2(frac_non_zero)) + 0.5f;
 
-            // We cannot have more iterations than there are blocks in the k
-            // dimension
-            if(depth > k_) depth = k_;
-
-            // Modify the number of concurrent iterations based on the available
-            // memory and sparsity of the argument tensors.
-            depth = mem_bound_depth(depth, left_sparsity, right_sparsity);
-
-            // Enforce user defined depth bound
-            if(max_depth_) std::min(depth, max_depth_);
+            // Bound the number of concurrent iterations by the number of
+            // blocks in the k dimension of this layer, the available memory
+            // and sparsity of the argument tensors, and the user defined depth
+            // bound.
+            init_depth_limit(left_sparsity, right_sparsity);
+            depth = init_depth(depth);
 
             TensorImpl_::world().taskq.add(new SparseStepTask(shared_from_this(),
                                                               depth));
@@ -1669,6 +2066,8 @@ namespace TiledArray {
         // Wait for child tensors to be evaluated, and process tasks while waiting.
         left_.wait();
         right_.wait();
+        if(epilogue_)
+          epilogue_->wait();
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
         printf("eval: finished wait children rank=%i\n", TensorImpl_::world().rank());
@@ -1691,6 +2090,15 @@ namespace TiledArray {
     typename Summa<Left, Right, Op, Policy>::size_type
     Summa<Left, Right, Op, Policy>::max_memory_ =
         Summa<Left, Right, Op, Policy>::init_max_memory();
+
+    template <typename Left, typename Right, typename Op, typename Policy>
+    typename Summa<Left, Right, Op, Policy>::size_type
+    Summa<Left, Right, Op, Policy>::max_layers_ =
+        Summa<Left, Right, Op, Policy>::init_max_layers();
+
+    template <typename Left, typename Right, typename Op, typename Policy>
+    bool Summa<Left, Right, Op, Policy>::adaptive_depth_ =
+        Summa<Left, Right, Op, Policy>::init_adaptive_depth();
   } // namespace detail
 }  // namespace TiledArray
 
@@ -0,0 +1,280 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  contraction_trace.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_CONTRACTION_TRACE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_CONTRACTION_TRACE_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+
+  /// A timed event of a traced contraction
+  struct ContractionEvent {
+
+    /// The phase of a contraction event
+    typedef enum {
+      bcast, ///< Wait for the argument tiles of a SUMMA iteration
+      gemm, ///< Contraction of a pair of tiles
+      reduce, ///< Reduction of two partial results of a tile
+      permute ///< Post-processing (permutation) of a result tile
+    } phase_type;
+
+    phase_type phase; ///< The phase of this event
+    std::uint64_t start; ///< Start time in nanoseconds since the trace epoch
+    std::uint64_t duration; ///< Duration in nanoseconds
+    unsigned int thread; ///< The index of the thread that recorded the event
+    std::uint64_t k; ///< The SUMMA iteration (bcast events only)
+
+    /// Phase name accessor
+
+    /// \param phase The event phase
+    /// \return The name of \c phase
+    static const char* name(const phase_type phase) {
+      switch(phase) {
+        case bcast: return "bcast";
+        case gemm: return "gemm";
+        case reduce: return "reduce";
+        default: return "permute";
+      }
+    }
+
+  }; // struct ContractionEvent
+
+  /// The measurements of a traced contraction on one process
+
+  /// Phase times are the sums of the durations of the events of that phase,
+  /// so they may exceed the wall time of the contraction when the events are
+  /// executed concurrently by several threads.
+  struct ContractionProfile {
+    std::size_t id; ///< The sequence number of the contraction on this process
+    ProcessID rank; ///< The rank of this process
+    std::size_t layers; ///< The number of process layers
+    std::size_t iterations; ///< The number of SUMMA iterations of this process
+    std::uint64_t start; ///< Start time in nanoseconds since the trace epoch
+    std::uint64_t duration; ///< Wall time in nanoseconds
+    double bcast_wait; ///< Total broadcast wait time (s)
+    double gemm_time; ///< Total tile contraction time (s)
+    double reduce_time; ///< Total partial result reduction time (s)
+    double permute_time; ///< Total result tile post-processing time (s)
+    std::uint64_t bytes; ///< Bytes of argument tiles received from other processes
+    std::uint64_t flops; ///< Floating point operations of the tile contractions
+    std::vector<ContractionEvent> events; ///< The events of this contraction
+
+    /// Wall time accessor
+
+    /// \return The wall time of the contraction (s)
+    double wall_time() const { return double(duration) * 1.0e-9; }
+
+    /// Contraction rate accessor
+
+    /// \return The rate of the contraction (GFLOP/s), based on wall time
+    double gflops() const {
+      return (duration ? double(flops) / double(duration) : 0.0);
+    }
+
+  }; // struct ContractionProfile
+
+  /// Contraction trace
+
+  /// When tracing is enabled, each distributed contraction (SUMMA) records
+  /// the time spent waiting for broadcast tiles, contracting tile pairs,
+  /// reducing partial results, and post-processing (permuting) result tiles,
+  /// as well as the number of bytes received and the number of floating point
+  /// operations. A \c ContractionProfile is stored for each contraction on
+  /// this process when all of its tile operations have finished and its
+  /// evaluator has been destroyed, which is the case after the next fence.
+  /// Tracing is enabled by setting the
+  /// \c TA_CONTRACTION_TRACE environment variable to a non-zero value, or by
+  /// calling \c enable() .
+  /// \code
+  /// TiledArray::ContractionTrace::enable();
+  /// c("i,j") = a("i,k") * b("k,j");
+  /// world.gop.fence();
+  /// for(const auto& profile : TiledArray::ContractionTrace::profiles())
+  ///   std::cout << profile.gflops() << " GFLOP/s\n";
+  /// TiledArray::ContractionTrace::write_chrome_trace("trace."
+  ///     + std::to_string(world.rank()) + ".json");
+  /// \endcode
+  class ContractionTrace {
+    std::atomic<bool> enabled_; ///< Tracing flag
+    std::atomic<std::size_t> next_id_; ///< Next contraction sequence number
+    std::atomic<unsigned int> next_thread_; ///< Next thread index
+    const std::chrono::steady_clock::time_point epoch_; ///< Trace epoch
+    std::vector<ContractionProfile> profiles_; ///< Profiles of finalized contractions
+    madness::Spinlock lock_; ///< Lock that protects \c profiles_
+
+    static bool init_enabled() {
+      const char* trace = getenv("TA_CONTRACTION_TRACE");
+      if(trace)
+        return std::atoi(trace) != 0;
+      return false;
+    }
+
+    ContractionTrace() :
+      enabled_(init_enabled()), next_id_(0ul), next_thread_(0u),
+      epoch_(std::chrono::steady_clock::now()), profiles_(), lock_()
+    { }
+
+    static ContractionTrace& instance() {
+      static ContractionTrace trace;
+      return trace;
+    }
+
+  public:
+
+    /// Enable or disable tracing
+
+    /// Only contractions that are constructed while tracing is enabled are
+    /// traced.
+    /// \param enabled The tracing flag
+    static void enable(const bool enabled = true) { instance().enabled_ = enabled; }
+
+    /// Tracing flag accessor
+
+    /// \return \c true if tracing is enabled
+    static bool enabled() { return instance().enabled_; }
+
+    /// Trace clock
+
+    /// \return The time elapsed since the trace epoch in nanoseconds
+    static std::uint64_t now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - instance().epoch_).count();
+    }
+
+    /// Thread index accessor
+
+    /// \return A small integer that identifies the calling thread
+    static unsigned int thread() {
+      static thread_local const unsigned int index = instance().next_thread_++;
+      return index;
+    }
+
+    /// Store the profile of a completed contraction
+
+    /// \param profile The contraction profile
+    static void record(ContractionProfile&& profile) {
+      ContractionTrace& trace = instance();
+      profile.id = trace.next_id_++;
+      madness::ScopedMutex<madness::Spinlock> locker(& trace.lock_);
+      trace.profiles_.push_back(std::move(profile));
+    }
+
+    /// Profiles accessor
+
+    /// \return The profiles of the contractions that were completed on this
+    /// process, in order of completion
+    static std::vector<ContractionProfile> profiles() {
+      ContractionTrace& trace = instance();
+      madness::ScopedMutex<madness::Spinlock> locker(& trace.lock_);
+      return trace.profiles_;
+    }
+
+    /// Discard all stored profiles
+    static void clear() {
+      ContractionTrace& trace = instance();
+      madness::ScopedMutex<madness::Spinlock> locker(& trace.lock_);
+      trace.profiles_.clear();
+    }
+
+    /// Format a time in microseconds
+
+    /// The time is written exactly, with three decimal places, so the
+    /// resolution of the trace does not depend on the stream precision or the
+    /// length of the run.
+    /// \param ns The time in nanoseconds
+    /// \return The time in microseconds
+    static std::string microseconds(const std::uint64_t ns) {
+      const std::string fraction = std::to_string(1000ul + ns % 1000ul);
+      return std::to_string(ns / 1000ul) + "." + fraction.substr(1);
+    }
+
+    /// Write the stored profiles in the Chrome trace event format
+
+    /// The output may be loaded by \c chrome://tracing or Perfetto. Each
+    /// contraction is a complete event of the \c contraction category, with
+    /// the phase totals as arguments, and the events of each phase are
+    /// complete events of the \c summa category. The process id of the
+    /// events is the rank of the process, so the files written by all
+    /// processes may be merged into a single trace.
+    /// \param os The output stream
+    static void write_chrome_trace(std::ostream& os) {
+      const std::vector<ContractionProfile> profiles = ContractionTrace::profiles();
+
+      os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+      bool first = true;
+      for(const ContractionProfile& profile : profiles) {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << "{\"name\":\"contraction " << profile.id
+           << "\",\"cat\":\"contraction\",\"ph\":\"X\",\"pid\":" << profile.rank
+           << ",\"tid\":0,\"ts\":" << microseconds(profile.start)
+           << ",\"dur\":" << microseconds(profile.duration)
+           << ",\"args\":{\"layers\":" << profile.layers
+           << ",\"iterations\":" << profile.iterations
+           << ",\"bcast_wait\":" << profile.bcast_wait
+           << ",\"gemm\":" << profile.gemm_time
+           << ",\"reduce\":" << profile.reduce_time
+           << ",\"permute\":" << profile.permute_time
+           << ",\"bytes\":" << profile.bytes
+           << ",\"flops\":" << profile.flops
+           << ",\"gflops\":" << profile.gflops() << "}}";
+
+        for(const ContractionEvent& event : profile.events) {
+          os << ",\n{\"name\":\"" << ContractionEvent::name(event.phase)
+             << "\",\"cat\":\"summa\",\"ph\":\"X\",\"pid\":" << profile.rank
+             << ",\"tid\":" << event.thread + 1u
+             << ",\"ts\":" << microseconds(event.start)
+             << ",\"dur\":" << microseconds(event.duration)
+             << ",\"args\":{\"contraction\":" << profile.id;
+          if(event.phase == ContractionEvent::bcast)
+            os << ",\"k\":" << event.k;
+          os << "}}";
+        }
+      }
+      os << "\n]}\n";
+    }
+
+    /// Write the stored profiles to a Chrome trace file
+
+    /// \param filename The name of the output file
+    /// \throw TiledArray::Exception When the file cannot be opened
+    static void write_chrome_trace(const std::string& filename) {
+      std::ofstream file(filename);
+      if(! file)
+        TA_EXCEPTION("Unable to open the contraction trace file.");
+      write_chrome_trace(file);
+    }
+
+  }; // class ContractionTrace
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_CONTRACTION_TRACE_H__INCLUDED
@@ -0,0 +1,194 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  summa_epilogue.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_EPILOGUE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_EPILOGUE_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/zero_tensor.h>
+#include <memory>
+#include <type_traits>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Additive terms that are fused with a contraction
+
+    /// An epilogue combines each result tile of a contraction, as soon as its
+    /// reduction is submitted, with the tiles of other distributed evaluators
+    /// that have the same tiled range and process map, e.g. the tiles of
+    /// \c D*E and \c F in \c A=B*C+D*E+F . This avoids the construction of
+    /// the intermediate result of the contraction. Empty tiles are used for
+    /// the contraction tiles that have no contributions, and for the results
+    /// that are zero.
+    /// \tparam Tile The result tile type
+    template <typename Tile>
+    class SummaEpilogue {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+      virtual ~SummaEpilogue() { }
+
+      /// Start the evaluation of the additive terms
+      virtual void eval() = 0;
+
+      /// Wait for the evaluation of the additive terms
+      virtual void wait() = 0;
+
+      /// Combine a contraction tile with the additive terms
+
+      /// \param index The result tile index, which must be local
+      /// \param tile The contraction tile, or an empty tile
+      /// \return The result tile
+      virtual Future<Tile> operator()(const size_type index,
+          const Future<Tile>& tile) = 0;
+
+      /// Discard the tiles of the additive terms that are not needed
+
+      /// \param index The index of a zero result tile
+      virtual void discard(const size_type index) = 0;
+
+    }; // class SummaEpilogue
+
+
+    /// An additive term of a fused contraction
+
+    /// The term is combined with the accumulated result with the tile
+    /// operation of a binary expression, e.g. an addition or a subtraction,
+    /// and the result is passed to the next term.
+    /// \tparam Arg The distributed evaluator type of the term
+    /// \tparam Op The binary tile operation type
+    /// \tparam Left \c true if the accumulated result is the left-hand
+    /// argument of \c Op
+    template <typename Arg, typename Op, bool Left>
+    class BinaryEpilogue :
+        public SummaEpilogue<typename Op::result_type>,
+        public std::enable_shared_from_this<BinaryEpilogue<Arg, Op, Left> >
+    {
+    public:
+      typedef BinaryEpilogue<Arg, Op, Left> BinaryEpilogue_; ///< This object type
+      typedef SummaEpilogue<typename Op::result_type> SummaEpilogue_; ///< The base class type
+      typedef typename SummaEpilogue_::size_type size_type; ///< Size type
+      typedef typename Op::result_type value_type; ///< Tile type
+      typedef Arg arg_type; ///< The term distributed evaluator type
+      typedef Op op_type; ///< Tile operation type
+
+    private:
+
+      arg_type arg_; ///< The term
+      op_type op_; ///< The tile operation
+      std::shared_ptr<SummaEpilogue_> next_; ///< The next term (may be null)
+
+      // Task function argument types
+      typedef typename std::conditional<Left ? op_type::left_is_consumable :
+          op_type::right_is_consumable, value_type, const value_type>::type &
+              tile_argument_type;
+      typedef typename std::conditional<Left ? op_type::right_is_consumable :
+          op_type::left_is_consumable, typename arg_type::value_type,
+          const typename arg_type::value_type>::type & arg_argument_type;
+
+      template <typename T, typename A>
+      value_type apply(T&& tile, A&& arg, std::true_type) const {
+        return op_(std::forward<T>(tile), std::forward<A>(arg));
+      }
+
+      template <typename T, typename A>
+      value_type apply(T&& tile, A&& arg, std::false_type) const {
+        return op_(std::forward<A>(arg), std::forward<T>(tile));
+      }
+
+      /// Task function that adds a non-zero term
+
+      /// \param tile The accumulated result tile, or an empty tile
+      /// \param arg The term tile
+      /// \return The combined tile
+      value_type eval_tile(tile_argument_type tile, arg_argument_type arg) {
+        using TiledArray::empty;
+        if(empty(tile))
+          return apply(ZeroTensor(), arg, std::integral_constant<bool, Left>());
+        return apply(tile, arg, std::integral_constant<bool, Left>());
+      }
+
+      /// Task function that adds a zero term
+
+      /// \param tile The accumulated result tile, or an empty tile
+      /// \return The combined tile, or an empty tile if \c tile is empty
+      value_type eval_zero(tile_argument_type tile) {
+        using TiledArray::empty;
+        if(empty(tile))
+          return value_type();
+        return apply(tile, ZeroTensor(), std::integral_constant<bool, Left>());
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param arg The distributed evaluator of the term
+      /// \param op The tile operation
+      /// \param next The next term (may be null)
+      BinaryEpilogue(const arg_type& arg, const op_type& op,
+          const std::shared_ptr<SummaEpilogue_>& next) :
+        arg_(arg), op_(op), next_(next)
+      { }
+
+      virtual ~BinaryEpilogue() { }
+
+      virtual void eval() {
+        arg_.eval();
+        if(next_)
+          next_->eval();
+      }
+
+      virtual void wait() {
+        arg_.wait();
+        if(next_)
+          next_->wait();
+      }
+
+      virtual Future<value_type> operator()(const size_type index,
+          const Future<value_type>& tile)
+      {
+        World& world = arg_.world();
+        std::shared_ptr<BinaryEpilogue_> self = this->shared_from_this();
+
+        const Future<value_type> result = (arg_.is_zero(index) ?
+            world.taskq.add(self, & BinaryEpilogue_::eval_zero, tile) :
+            world.taskq.add(self, & BinaryEpilogue_::eval_tile, tile, arg_.get(index)));
+
+        return (next_ ? (*next_)(index, result) : result);
+      }
+
+      virtual void discard(const size_type index) {
+        if(! arg_.is_zero(index))
+          arg_.discard(index);
+        if(next_)
+          next_->discard(index);
+      }
+
+    }; // class BinaryEpilogue
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_EPILOGUE_H__INCLUDED
@@ -0,0 +1,275 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  summa_sparse_index.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_SPARSE_INDEX_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_SPARSE_INDEX_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/proc_grid.h>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Index of the non-zero tiles used by the SUMMA iterations of a process
+
+    /// The index is built once from the argument and result shapes, and holds
+    /// (for each inner tile index \c k of the process layer):
+    /// - the local rows of column \c k of the left-hand argument and the
+    ///   local columns of row \c k of the right-hand argument that contain
+    ///   non-zero tiles, in compressed sparse column and row format;
+    /// - the process rows (columns) that own non-zero tiles of column (row)
+    ///   \c k of the left-hand (right-hand) argument, which are the members
+    ///   of the sparse broadcast groups.
+    ///
+    /// It also holds the process columns (rows) that own non-zero result
+    /// tiles of each local result row (column), which are used to restrict
+    /// the broadcast groups to processes that have result tiles. This
+    /// replaces the \c is_zero tests of every candidate tile in each SUMMA
+    /// iteration with a walk over the non-zero tiles.
+    /// Local row and column indices are the ordinals of the rows and columns
+    /// in the process grid, i.e. local row \c t of process row \c r is row
+    /// \c r+t*proc_rows .
+    class SummaSparseIndex {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      size_type k_begin_; ///< The first inner tile index of the index
+      size_type proc_rows_; ///< The number of process rows
+      size_type proc_cols_; ///< The number of process columns
+      std::vector<size_type> col_ptr_; ///< Offsets of the columns of the left-hand argument in col_idx_
+      std::vector<size_type> col_idx_; ///< Local rows of the non-zero tiles of the left-hand argument
+      std::vector<size_type> row_ptr_; ///< Offsets of the rows of the right-hand argument in row_idx_
+      std::vector<size_type> row_idx_; ///< Local columns of the non-zero tiles of the right-hand argument
+      std::vector<bool> col_procs_; ///< Process rows with non-zero tiles in each column of the left-hand argument
+      std::vector<bool> row_procs_; ///< Process columns with non-zero tiles in each row of the right-hand argument
+      std::vector<bool> result_row_procs_; ///< Process columns with non-zero tiles in each local result row
+      std::vector<bool> result_col_procs_; ///< Process rows with non-zero tiles in each local result column
+
+    public:
+
+      SummaSparseIndex() = delete;
+
+      /// Constructor
+
+      /// \tparam LeftShape The shape type of the left-hand argument
+      /// \tparam RightShape The shape type of the right-hand argument
+      /// \tparam ResultZero The result zero tile predicate type
+      /// \param proc_grid The process grid of the contraction
+      /// \param k The number of tiles in the inner dimension
+      /// \param k_begin The first inner tile index evaluated by this process
+      /// \param k_end The end of the inner tile indices evaluated by this
+      /// process
+      /// \param left The shape of the left-hand argument (a \c rows x \c k
+      /// matrix of tiles)
+      /// \param right The shape of the right-hand argument (a \c k x \c cols
+      /// matrix of tiles)
+      /// \param result_dense \c true if all result tiles are non-zero
+      /// \param result_is_zero A predicate that returns \c true if the result
+      /// tile with ordinal index \c i*cols+j is zero
+      template <typename LeftShape, typename RightShape, typename ResultZero>
+      SummaSparseIndex(const ProcGrid& proc_grid, const size_type k,
+          const size_type k_begin, const size_type k_end,
+          const LeftShape& left, const RightShape& right,
+          const bool result_dense, const ResultZero& result_is_zero) :
+        k_begin_(k_begin), proc_rows_(proc_grid.proc_rows()),
+        proc_cols_(proc_grid.proc_cols()), col_ptr_(k_end - k_begin + 1ul, 0ul),
+        col_idx_(), row_ptr_(1ul, 0ul), row_idx_(),
+        col_procs_((k_end - k_begin) * proc_rows_, false),
+        row_procs_((k_end - k_begin) * proc_cols_, false),
+        result_row_procs_(), result_col_procs_()
+      {
+        TA_ASSERT(k_begin <= k_end);
+        TA_ASSERT(k_end <= k);
+
+        const size_type rows = proc_grid.rows();
+        const size_type cols = proc_grid.cols();
+        const size_type rank_row = proc_grid.rank_row();
+        const size_type rank_col = proc_grid.rank_col();
+        const size_type nk = k_end - k_begin;
+
+        // Scan the left-hand argument by row, count the non-zero tiles of
+        // the local rows in each column, and flag the process rows with
+        // non-zero tiles.
+        for(size_type i = 0ul; i < rows; ++i) {
+          const size_type p = i % proc_rows_;
+          const bool local = (p == rank_row);
+          for(size_type kk = 0ul, ik = i * k + k_begin; kk < nk; ++kk, ++ik) {
+            if(left.is_zero(ik)) continue;
+            col_procs_[kk * proc_rows_ + p] = true;
+            if(local)
+              ++col_ptr_[kk + 1ul];
+          }
+        }
+
+        // Fill the columns of the local rows
+        for(size_type kk = 0ul; kk < nk; ++kk)
+          col_ptr_[kk + 1ul] += col_ptr_[kk];
+        col_idx_.resize(col_ptr_.back());
+        std::vector<size_type> offset(col_ptr_.begin(), col_ptr_.end() - 1l);
+        for(size_type i = rank_row, t = 0ul; i < rows; i += proc_rows_, ++t)
+          for(size_type kk = 0ul, ik = i * k + k_begin; kk < nk; ++kk, ++ik)
+            if(! left.is_zero(ik))
+              col_idx_[offset[kk]++] = t;
+
+        // Scan the rows of the right-hand argument
+        row_ptr_.reserve(nk + 1ul);
+        for(size_type kk = 0ul; kk < nk; ++kk) {
+          for(size_type j = 0ul, kj = (kk + k_begin) * cols; j < cols; ++j, ++kj) {
+            if(right.is_zero(kj)) continue;
+            const size_type p = j % proc_cols_;
+            row_procs_[kk * proc_cols_ + p] = true;
+            if(p == rank_col)
+              row_idx_.push_back(j / proc_cols_);
+          }
+          row_ptr_.push_back(row_idx_.size());
+        }
+
+        // Scan the result tiles of the local rows and columns
+        if(! result_dense) {
+          result_row_procs_.assign(proc_grid.local_rows() * proc_cols_, false);
+          result_col_procs_.assign(proc_grid.local_cols() * proc_rows_, false);
+          for(size_type i = 0ul; i < rows; ++i) {
+            const size_type p_row = i % proc_rows_;
+            if(p_row == rank_row) {
+              const size_type t = i / proc_rows_;
+              for(size_type j = 0ul, ij = i * cols; j < cols; ++j, ++ij) {
+                if(result_is_zero(ij)) continue;
+                const size_type p_col = j % proc_cols_;
+                result_row_procs_[t * proc_cols_ + p_col] = true;
+                if(p_col == rank_col)
+                  result_col_procs_[(j / proc_cols_) * proc_rows_ + p_row] = true;
+              }
+            } else {
+              for(size_type j = rank_col, ij = i * cols + rank_col; j < cols;
+                  j += proc_cols_, ij += proc_cols_)
+                if(! result_is_zero(ij))
+                  result_col_procs_[(j / proc_cols_) * proc_rows_ + p_row] = true;
+            }
+          }
+        }
+      }
+
+      SummaSparseIndex(const SummaSparseIndex&) = default;
+      SummaSparseIndex(SummaSparseIndex&&) = default;
+      SummaSparseIndex& operator=(const SummaSparseIndex&) = default;
+      SummaSparseIndex& operator=(SummaSparseIndex&&) = default;
+
+      /// The first local row of the non-zero tiles of a left-hand column
+
+      /// \param k The column of the left-hand argument
+      /// \return A pointer to the first local row with a non-zero tile
+      const size_type* col_begin(const size_type k) const {
+        return col_idx_.data() + col_ptr_[k - k_begin_];
+      }
+
+      /// The end of the local rows of the non-zero tiles of a left-hand column
+
+      /// \param k The column of the left-hand argument
+      /// \return A pointer to the end of the local rows with non-zero tiles
+      const size_type* col_end(const size_type k) const {
+        return col_idx_.data() + col_ptr_[k - k_begin_ + 1ul];
+      }
+
+      /// The number of local non-zero tiles in a left-hand column
+
+      /// \param k The column of the left-hand argument
+      /// \return The number of non-zero tiles in the local rows of column \c k
+      size_type col_size(const size_type k) const {
+        return col_ptr_[k - k_begin_ + 1ul] - col_ptr_[k - k_begin_];
+      }
+
+      /// The first local column of the non-zero tiles of a right-hand row
+
+      /// \param k The row of the right-hand argument
+      /// \return A pointer to the first local column with a non-zero tile
+      const size_type* row_begin(const size_type k) const {
+        return row_idx_.data() + row_ptr_[k - k_begin_];
+      }
+
+      /// The end of the local columns of the non-zero tiles of a right-hand row
+
+      /// \param k The row of the right-hand argument
+      /// \return A pointer to the end of the local columns with non-zero tiles
+      const size_type* row_end(const size_type k) const {
+        return row_idx_.data() + row_ptr_[k - k_begin_ + 1ul];
+      }
+
+      /// The number of local non-zero tiles in a right-hand row
+
+      /// \param k The row of the right-hand argument
+      /// \return The number of non-zero tiles in the local columns of row \c k
+      size_type row_size(const size_type k) const {
+        return row_ptr_[k - k_begin_ + 1ul] - row_ptr_[k - k_begin_];
+      }
+
+      /// Check for non-zero tiles of a left-hand column in a process row
+
+      /// \param k The column of the left-hand argument
+      /// \param proc_row The process row
+      /// \return \c true if process row \c proc_row owns non-zero tiles of
+      /// column \c k
+      bool col_nonzero(const size_type k, const size_type proc_row) const {
+        return col_procs_[(k - k_begin_) * proc_rows_ + proc_row];
+      }
+
+      /// Check for non-zero tiles of a right-hand row in a process column
+
+      /// \param k The row of the right-hand argument
+      /// \param proc_col The process column
+      /// \return \c true if process column \c proc_col owns non-zero tiles of
+      /// row \c k
+      bool row_nonzero(const size_type k, const size_type proc_col) const {
+        return row_procs_[(k - k_begin_) * proc_cols_ + proc_col];
+      }
+
+      /// Check for non-zero tiles of a local result row in a process column
+
+      /// \param t The local result row
+      /// \param proc_col The process column
+      /// \return \c true if process column \c proc_col owns non-zero result
+      /// tiles of local row \c t
+      /// \note The result tiles are only indexed if the result is not dense.
+      bool result_row_nonzero(const size_type t, const size_type proc_col) const {
+        TA_ASSERT(! result_row_procs_.empty());
+        return result_row_procs_[t * proc_cols_ + proc_col];
+      }
+
+      /// Check for non-zero tiles of a local result column in a process row
+
+      /// \param t The local result column
+      /// \param proc_row The process row
+      /// \return \c true if process row \c proc_row owns non-zero result
+      /// tiles of local column \c t
+      /// \note The result tiles are only indexed if the result is not dense.
+      bool result_col_nonzero(const size_type t, const size_type proc_row) const {
+        TA_ASSERT(! result_col_procs_.empty());
+        return result_col_procs_[t * proc_rows_ + proc_row];
+      }
+
+    }; // class SummaSparseIndex
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_SPARSE_INDEX_H__INCLUDED
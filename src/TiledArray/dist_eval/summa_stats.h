@@ -0,0 +1,446 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  summa_stats.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_STATS_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_STATS_H__INCLUDED
+
+#include <TiledArray/dist_eval/contraction_trace.h>
+#include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/type_traits.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+
+  /// SUMMA evaluation statistics
+
+  /// The statistics of the SUMMA evaluation of a contraction on this process.
+  /// The broadcast latency and contraction times are only measured when the
+  /// adaptive depth controller (see \c TA_SUMMA_ADAPTIVE_DEPTH ) or the
+  /// contraction trace (see \c ContractionTrace ) is enabled, otherwise they
+  /// are zero.
+  struct SummaStats {
+
+    /// The performance regime of a SUMMA evaluation
+    typedef enum {
+      unknown, ///< No timings were measured
+      compute_bound, ///< Broadcasts were hidden by local contractions
+      communication_bound, ///< Local contractions waited for broadcasts
+      memory_bound ///< The depth was limited by \c TA_SUMMA_MAX_MEMORY
+    } regime_type;
+
+    std::size_t iterations; ///< Number of SUMMA iterations performed
+    std::size_t layers; ///< Number of process layers
+    std::size_t depth_limit; ///< Maximum number of concurrent iterations
+    std::size_t initial_depth; ///< Initial number of concurrent iterations
+    std::size_t min_depth; ///< Smallest number of concurrent iterations
+    std::size_t max_depth; ///< Largest number of concurrent iterations
+    std::size_t final_depth; ///< Number of concurrent iterations at the end
+    std::size_t grow_count; ///< Number of times the depth was increased
+    std::size_t shrink_count; ///< Number of times the depth was decreased
+    double bcast_latency; ///< Average time (s) from the start of the broadcasts of an iteration until all its tiles were available
+    double gemm_time; ///< Average wall time (s) of the local tile contractions of an iteration
+    bool adaptive; ///< The adaptive depth controller was enabled
+    regime_type regime; ///< The performance regime
+
+  }; // struct SummaStats
+
+  namespace detail {
+
+    /// SUMMA runtime measurement counters
+
+    /// The counters are updated by the tasks of a SUMMA evaluation, so they
+    /// may be updated concurrently. Events are only stored when the
+    /// contraction is traced. The tile operations of a contraction may finish
+    /// after the SUMMA is finalized, so the profile of a traced contraction
+    /// is stored when the counters are destroyed, which happens when the
+    /// SUMMA and all of its tasks have been destroyed.
+    struct SummaCounters {
+      const bool trace; ///< Store the events of the contraction
+      const std::uint64_t start; ///< The construction time (see \c ContractionTrace::now() )
+      std::atomic<std::uint64_t> gemm_ns; ///< Total tile contraction time in nanoseconds
+      std::atomic<std::uint64_t> gemm_count; ///< Number of tile contractions
+      std::atomic<std::uint64_t> latency_ns; ///< Total broadcast latency in nanoseconds
+      std::atomic<std::uint64_t> latency_count; ///< Number of measured iterations
+      std::atomic<std::uint64_t> reduce_ns; ///< Total partial result reduction time in nanoseconds
+      std::atomic<std::uint64_t> permute_ns; ///< Total result post-processing time in nanoseconds
+      std::atomic<std::uint64_t> bytes; ///< Bytes of argument tiles received from other processes
+      std::atomic<std::uint64_t> flops; ///< Floating point operations of tile contractions
+      std::vector<ContractionEvent> events; ///< The events of a traced contraction
+      madness::Spinlock lock; ///< The lock that protects \c events
+      ProcessID rank; ///< The rank of this process
+      std::size_t layers; ///< The number of process layers
+      std::size_t iterations; ///< The number of SUMMA iterations of this process
+
+      /// Constructor
+
+      /// \param trace Store the events of the contraction
+      explicit SummaCounters(const bool trace) :
+        trace(trace), start(ContractionTrace::now()), gemm_ns(0ul),
+        gemm_count(0ul), latency_ns(0ul), latency_count(0ul), reduce_ns(0ul),
+        permute_ns(0ul), bytes(0ul), flops(0ul), events(), lock(), rank(0),
+        layers(1ul), iterations(0ul)
+      { }
+
+      ~SummaCounters() {
+        if(trace)
+          ContractionTrace::record(profile());
+      }
+
+      /// Store an event of a traced contraction
+
+      /// \param phase The phase of the event
+      /// \param start The start time of the event
+      /// \param duration The duration of the event
+      /// \param k The SUMMA iteration of the event
+      void record(const ContractionEvent::phase_type phase,
+          const std::uint64_t start, const std::uint64_t duration,
+          const std::uint64_t k = 0ul)
+      {
+        if(! trace)
+          return;
+        const ContractionEvent event = { phase, start, duration,
+            ContractionTrace::thread(), k };
+        madness::ScopedMutex<madness::Spinlock> locker(& lock);
+        events.push_back(event);
+      }
+
+      /// Average tile contraction time accessor
+
+      /// \return The average time (s) of a tile contraction, or zero if none
+      /// were measured
+      double gemm_time() const {
+        const std::uint64_t count = gemm_count.load();
+        return (count ? double(gemm_ns.load()) * 1.0e-9 / double(count) : 0.0);
+      }
+
+      /// Average broadcast latency accessor
+
+      /// \return The average broadcast latency (s) of an iteration, or zero if
+      /// none were measured
+      double latency() const {
+        const std::uint64_t count = latency_count.load();
+        return (count ? double(latency_ns.load()) * 1.0e-9 / double(count) : 0.0);
+      }
+
+      /// Construct the profile of a traced contraction
+
+      /// This moves the stored events into the profile. The duration of the
+      /// contraction is the time from the construction of the counters to the
+      /// end of the last event.
+      /// \return The contraction profile
+      ContractionProfile profile() {
+        ContractionProfile result;
+        result.id = 0ul;
+        result.rank = rank;
+        result.layers = layers;
+        result.iterations = iterations;
+        result.start = start;
+        result.bcast_wait = double(latency_ns.load()) * 1.0e-9;
+        result.gemm_time = double(gemm_ns.load()) * 1.0e-9;
+        result.reduce_time = double(reduce_ns.load()) * 1.0e-9;
+        result.permute_time = double(permute_ns.load()) * 1.0e-9;
+        result.bytes = bytes.load();
+        result.flops = flops.load();
+        madness::ScopedMutex<madness::Spinlock> locker(& lock);
+        std::uint64_t finish = start;
+        for(const ContractionEvent& event : events)
+          finish = std::max(finish, event.start + event.duration);
+        result.duration = finish - start;
+        result.events = std::move(events);
+        return result;
+      }
+
+    }; // struct SummaCounters
+
+    /// Contraction operation that measures its tile operations
+
+    /// When measurement counters are given, the time of tile contractions,
+    /// partial result reductions, and result post-processing, and the number
+    /// of floating point operations of the tile contractions are added to the
+    /// counters.
+    /// \tparam Op The contraction/reduction operation type, which must
+    /// provide \c gemm_helper() , \c left_perm() , and \c right_perm()
+    /// accessors (e.g. \c ContractReduce )
+    template <typename Op>
+    class TimedContractOp : public Op {
+      std::shared_ptr<SummaCounters> counters_; ///< The measurement counters
+
+      /// Count the floating point operations of a tile contraction
+
+      /// The matrix sizes are computed from the argument ranges permuted by
+      /// the argument permutations of \c Op , as by the contraction itself.
+      /// \tparam LeftRange The left-hand tile range type
+      /// \tparam RightRange The right-hand tile range type
+      /// \param left The left-hand tile range
+      /// \param right The right-hand tile range
+      /// \return The number of floating point operations
+      template <typename LeftRange, typename RightRange>
+      std::uint64_t flops(const LeftRange& left, const RightRange& right) const {
+        const Permutation& left_perm = Op::left_perm();
+        const Permutation& right_perm = Op::right_perm();
+        integer m = 1, n = 1, k = 1;
+        Op::gemm_helper().compute_matrix_sizes(m, n, k,
+            (left_perm ? left_perm * left : left),
+            (right_perm ? right_perm * right : right));
+        return 2ul * std::uint64_t(m) * std::uint64_t(n) * std::uint64_t(k);
+      }
+
+    public:
+      typedef typename Op::result_type result_type; ///< The result tile type
+      typedef typename Op::first_argument_type first_argument_type; ///< The left tile type
+      typedef typename Op::second_argument_type second_argument_type; ///< The right tile type
+
+      TimedContractOp() : Op(), counters_() { }
+
+      /// Constructor
+
+      /// \param op The contraction operation
+      /// \param counters The measurement counters; if null, no measurements
+      /// are made
+      TimedContractOp(const Op& op, const std::shared_ptr<SummaCounters>& counters) :
+        Op(op), counters_(counters)
+      { }
+
+      using Op::operator();
+
+      /// Post processing step
+
+      /// \param temp The reduced result tile
+      /// \return The post-processed (permuted) result tile
+      result_type operator()(result_type& temp) const {
+        if(counters_) {
+          const std::uint64_t start = ContractionTrace::now();
+          result_type result = Op::operator()(temp);
+          const std::uint64_t duration = ContractionTrace::now() - start;
+          counters_->permute_ns += duration;
+          counters_->record(ContractionEvent::permute, start, duration);
+          return result;
+        }
+
+        return Op::operator()(temp);
+      }
+
+      /// Reduce two result objects
+
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] arg The argument that will be added to \c result
+      void operator()(result_type& result, const result_type& arg) const {
+        if(counters_) {
+          const std::uint64_t start = ContractionTrace::now();
+          Op::operator()(result, arg);
+          const std::uint64_t duration = ContractionTrace::now() - start;
+          counters_->reduce_ns += duration;
+          counters_->record(ContractionEvent::reduce, start, duration);
+        } else {
+          Op::operator()(result, arg);
+        }
+      }
+
+      /// Contract a pair of tiles and add to a target tile
+
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] right The right-hand tile to be contracted
+      void operator()(result_type& result, first_argument_type left,
+          second_argument_type right) const
+      {
+        if(counters_) {
+          const std::uint64_t start = ContractionTrace::now();
+          Op::operator()(result, left, right);
+          const std::uint64_t duration = ContractionTrace::now() - start;
+          counters_->gemm_ns += duration;
+          ++counters_->gemm_count;
+          counters_->flops += flops(left.range(), right.range());
+          counters_->record(ContractionEvent::gemm, start, duration);
+        } else {
+          Op::operator()(result, left, right);
+        }
+      }
+
+      /// Contract a batch of tile pairs and add to a target tile
+
+      /// This function is only defined if \c Op contracts batches of tile
+      /// pairs.
+      /// \tparam L The left tile type
+      /// \tparam R The right tile type
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tiles to be contracted
+      /// \param[in] right The right-hand tiles to be contracted
+      template <typename L, typename R>
+      auto operator()(result_type& result, const std::vector<const L*>& left,
+          const std::vector<const R*>& right) const ->
+          decltype(std::declval<const Op&>()(result, left, right))
+      {
+        if(counters_) {
+          const std::uint64_t start = ContractionTrace::now();
+          Op::operator()(result, left, right);
+          const std::uint64_t duration = ContractionTrace::now() - start;
+          counters_->gemm_ns += duration;
+          counters_->gemm_count += left.size();
+          for(std::size_t p = 0ul; p < left.size(); ++p)
+            counters_->flops += flops(left[p]->range(), right[p]->range());
+          counters_->record(ContractionEvent::gemm, start, duration);
+        } else {
+          Op::operator()(result, left, right);
+        }
+      }
+
+    }; // class TimedContractOp
+
+    /// Broadcast latency probe
+
+    /// This object measures the time from its construction until all the
+    /// tiles of a SUMMA iteration are available, and the size of the tiles
+    /// that are received from other processes, and then deletes itself.
+    /// \tparam Col The column datum type, a pair of an index and a tile future
+    /// \tparam Row The row datum type, a pair of an index and a tile future
+    template <typename Col, typename Row>
+    class LatencyProbe : public madness::CallbackInterface {
+      std::shared_ptr<SummaCounters> counters_; ///< The measurement counters
+      const std::uint64_t start_; ///< The start time
+      const std::uint64_t k_; ///< The SUMMA iteration
+      madness::AtomicInt count_; ///< The number of unset futures plus one
+      std::vector<Col> col_; ///< Column tiles received from other processes
+      std::vector<Row> row_; ///< Row tiles received from other processes
+
+      LatencyProbe(const std::shared_ptr<SummaCounters>& counters,
+          const std::uint64_t k) :
+        counters_(counters), start_(ContractionTrace::now()), k_(k),
+        col_(), row_()
+      { count_ = 1; }
+
+      /// Register the futures of a vector of tiles
+
+      /// \tparam Datum The datum type, a pair of an index and a tile future
+      /// \param vec The vector of tiles
+      template <typename Datum>
+      void add(const std::vector<Datum>& vec) {
+        count_ += vec.size();
+        for(const auto& datum : vec) {
+          auto future = datum.second;
+          future.register_callback(this);
+        }
+      }
+
+      /// Tile size in bytes
+
+      /// \tparam Datum The datum type, a pair of an index and a tile future
+      /// \param vec A vector of set tile futures
+      /// \return The total size of the elements of the tiles in \c vec
+      template <typename Datum>
+      static std::uint64_t bytes(const std::vector<Datum>& vec) {
+        using TiledArray::empty;
+        std::uint64_t result = 0ul;
+        for(const auto& datum : vec) {
+          const auto& tile = datum.second.get();
+          if(! empty(tile))
+            result += tile.range().volume() *
+                sizeof(typename numeric_type<typename std::decay<decltype(tile)>::type>::type);
+        }
+        return result;
+      }
+
+    public:
+
+      virtual ~LatencyProbe() { }
+
+      /// Start a latency measurement
+
+      /// \param counters The measurement counters
+      /// \param k The SUMMA iteration
+      /// \param col The column of left-hand tiles of an iteration
+      /// \param col_remote The column tiles are received from another process
+      /// \param row The row of right-hand tiles of an iteration
+      /// \param row_remote The row tiles are received from another process
+      static void start(const std::shared_ptr<SummaCounters>& counters,
+          const std::uint64_t k, const std::vector<Col>& col, const bool col_remote,
+          const std::vector<Row>& row, const bool row_remote)
+      {
+        LatencyProbe* probe = new LatencyProbe(counters, k);
+        if(col_remote)
+          probe->col_ = col;
+        if(row_remote)
+          probe->row_ = row;
+        probe->add(col);
+        probe->add(row);
+        probe->notify();
+      }
+
+      /// Future set notification
+      virtual void notify() {
+        if((--count_) == 0) {
+          const std::uint64_t duration = ContractionTrace::now() - start_;
+          counters_->latency_ns += duration;
+          ++counters_->latency_count;
+          counters_->bytes += bytes(col_) + bytes(row_);
+          counters_->record(ContractionEvent::bcast, start_, duration, k_);
+          delete this;
+        }
+      }
+
+    }; // class LatencyProbe
+
+    /// Most recent SUMMA statistics storage
+    struct SummaStatsStorage {
+      SummaStats stats{}; ///< The statistics of the most recent SUMMA
+      madness::Spinlock lock; ///< The lock that protects \c stats
+
+      /// Storage instance accessor
+
+      /// \return The statistics storage of this process
+      static SummaStatsStorage& instance() {
+        static SummaStatsStorage storage;
+        return storage;
+      }
+    }; // struct SummaStatsStorage
+
+    /// Record the statistics of a completed SUMMA evaluation
+
+    /// \param stats The statistics of the SUMMA evaluation
+    inline void set_summa_stats(const SummaStats& stats) {
+      SummaStatsStorage& storage = SummaStatsStorage::instance();
+      madness::ScopedMutex<madness::Spinlock> locker(& storage.lock);
+      storage.stats = stats;
+    }
+
+  } // namespace detail
+
+  /// SUMMA statistics accessor
+
+  /// \return The statistics of the most recently completed SUMMA evaluation
+  /// on this process
+  inline SummaStats summa_stats() {
+    detail::SummaStatsStorage& storage = detail::SummaStatsStorage::instance();
+    madness::ScopedMutex<madness::Spinlock> locker(& storage.lock);
+    return storage.stats;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_STATS_H__INCLUDED
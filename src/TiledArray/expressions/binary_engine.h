@@ -28,6 +28,7 @@
 
 #include <TiledArray/expressions/expr_engine.h>
 #include <TiledArray/dist_eval/binary_eval.h>
+#include <TiledArray/dist_eval/summa_epilogue.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -77,6 +78,83 @@ namespace TiledArray {
       left_type left_; ///< The left-hand argument
       right_type right_; ///< The right-hand argument
 
+    private:
+
+      typedef TiledArray::detail::SummaEpilogue<value_type> epilogue_type; ///< Fused additive terms type
+
+      /// Check that an argument may accumulate the result of this expression
+
+      /// \tparam Engine The argument engine type
+      template <typename Engine>
+      using is_fusable_arg = std::integral_constant<bool,
+          std::is_same<typename EngineTrait<Engine>::value_type, value_type>::value &&
+          std::is_same<typename EngineTrait<Engine>::eval_type, value_type>::value>;
+
+      /// Construct a fused distributed evaluator with the other argument as an additive term
+
+      /// \tparam Left \c true if \c fused is the left-hand argument
+      /// \tparam Fused The fused argument engine type
+      /// \tparam Term The additive term engine type
+      /// \param fused The fused argument
+      /// \param term The additive term
+      /// \param shape The shape of the result
+      /// \param next The additive terms of the parent expressions (may be null)
+      /// \return The distributed evaluator of \c fused with \c term and
+      /// \c next as additive terms
+      template <bool Left, typename Fused, typename Term>
+      dist_eval_type make_fused_term_dist_eval(const Fused& fused, const Term& term,
+          const shape_type& shape, const std::shared_ptr<epilogue_type>& next,
+          std::true_type) const
+      {
+        typedef TiledArray::detail::BinaryEpilogue<typename Term::dist_eval_type,
+            op_type, Left> term_type;
+        return fused.make_fused_dist_eval(shape, std::make_shared<term_type>(
+            term.make_dist_eval(), ExprEngine_::make_op(), next));
+      }
+
+      template <bool Left, typename Fused, typename Term>
+      dist_eval_type make_fused_term_dist_eval(const Fused&, const Term&,
+          const shape_type&, const std::shared_ptr<epilogue_type>&,
+          std::false_type) const
+      {
+        TA_ASSERT(false);
+        return BinaryEngine_::make_dist_eval();
+      }
+
+    protected:
+
+      /// Check that additive terms can be fused with this sum
+
+      /// A sum, e.g. an addition or a subtraction, is fused when its result is
+      /// not permuted or masked, and one of its arguments is a contraction, or
+      /// another sum, that can be fused with additive terms and has the same
+      /// tile type. The other argument is then added to the tiles of that
+      /// contraction, instead of to an intermediate result.
+      /// \return \c true if \c make_fused_sum_dist_eval() may be called
+      bool is_fusable_sum() const {
+        return (! perm_) &&
+            ! (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape) &&
+            ((is_fusable_arg<left_type>::value && left_.is_fusable()) ||
+            (is_fusable_arg<right_type>::value && right_.is_fusable()));
+      }
+
+      /// Construct the distributed evaluator for a fused sum
+
+      /// \param shape The shape of the result
+      /// \param next The additive terms of the parent expressions (may be null)
+      /// \return The distributed evaluator of the fused argument with the
+      /// other argument and \c next as additive terms
+      dist_eval_type make_fused_sum_dist_eval(const shape_type& shape,
+          const std::shared_ptr<epilogue_type>& next) const
+      {
+        TA_ASSERT(is_fusable_sum());
+        if(is_fusable_arg<left_type>::value && left_.is_fusable())
+          return make_fused_term_dist_eval<true>(left_, right_, shape, next,
+              is_fusable_arg<left_type>());
+        return make_fused_term_dist_eval<false>(right_, left_, shape, next,
+            is_fusable_arg<right_type>());
+      }
+
     public:
 
       template <typename D>
@@ -29,6 +29,7 @@
 #include <TiledArray/expressions/binary_engine.h>
 #include <TiledArray/dist_eval/contraction_eval.h>
 #include <TiledArray/tile_op/contract_reduce.h>
+#include <TiledArray/math/strided_gemm.h>
 #include <TiledArray/proc_grid.h>
 
 namespace TiledArray {
@@ -114,6 +115,8 @@ namespace TiledArray {
       op_type op_; ///< Tile operation
       TiledArray::detail::ProcGrid proc_grid_; ///< Process grid for the contraction
       size_type K_; ///< Inner dimension size
+      std::shared_ptr<const symmetry::TileSymmetry> symmetry_; ///< Symmetry of the result tiles
+      bool grid_pmap_; ///< The result process map matches the process grid
 
 
       static unsigned int
@@ -126,6 +129,58 @@ namespace TiledArray {
         return i;
       }
 
+      /// Average tile size of a group of dimensions
+
+      /// \tparam E The argument engine type
+      /// \param arg The argument engine
+      /// \param first The first dimension of the group
+      /// \param last The end of the dimensions of the group
+      /// \return The average number of elements of the tiles of \c arg in
+      /// the fused dimensions <tt>[first, last)</tt>
+      template <typename E>
+      static double average_tile_size(const E& arg, const unsigned int first,
+          const unsigned int last)
+      {
+        const size_type* MADNESS_RESTRICT const tiles_size =
+            arg.trange().tiles_range().extent_data();
+        const size_type* MADNESS_RESTRICT const element_size =
+            arg.trange().elements_range().extent_data();
+        double result = 1.0;
+        for(unsigned int i = first; i < last; ++i)
+          result *= double(element_size[i]) / double(tiles_size[i]);
+        return result;
+      }
+
+      /// Check if the tiles of an argument are contracted without permutation
+
+      /// The tiles of an argument that must be permuted are contracted
+      /// directly from their original layout (see
+      /// \c math::strided_gemm ) when the argument is a leaf of the
+      /// expression, i.e. when its tiles would otherwise be permuted copies of
+      /// the array tiles, and the tiles of the other argument are large enough
+      /// (see \c math::strided_contraction_threshold ).
+      /// \tparam E The argument engine type
+      /// \param arg The argument engine
+      /// \param op The argument operation
+      /// \param other_size The average size of the outer dimensions of the
+      /// tiles of the other argument
+      /// \return \c true if the tiles of \c arg should not be permuted
+      template <typename E>
+      static bool use_strided_contraction(const E& arg, const TensorOp op,
+          const double other_size)
+      {
+        constexpr bool strided_contractable =
+            TiledArray::detail::is_strided_contractable<value_type,
+                typename eval_trait<typename left_type::value_type>::type,
+                typename eval_trait<typename right_type::value_type>::type>::value;
+        const double threshold = math::strided_contraction_threshold();
+        return strided_contractable
+            && TiledArray::detail::is_numeric<scalar_type>::value
+            && (E::leaves == 1u)
+            && (op == permute_to_no_trans) && arg.perm() && (threshold > 0.0)
+            && (other_size >= threshold);
+      }
+
     public:
 
       /// Constructor
@@ -137,7 +192,7 @@ namespace TiledArray {
       ContEngine(const MultExpr<L, R>& expr) :
         BinaryEngine_(expr), factor_(1), left_vars_(), right_vars_(),
         left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
-        proc_grid_(), K_(1u)
+        proc_grid_(), K_(1u), symmetry_(), grid_pmap_(false)
       { }
 
       /// Constructor
@@ -150,7 +205,7 @@ namespace TiledArray {
       ContEngine(const ScalMultExpr<L, R, S>& expr) :
         BinaryEngine_(expr), factor_(expr.factor()), left_vars_(), right_vars_(),
         left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
-        proc_grid_(), K_(1u)
+        proc_grid_(), K_(1u), symmetry_(), grid_pmap_(false)
       { }
 
       // Pull base class functions into this class.
@@ -370,18 +425,39 @@ namespace TiledArray {
         const madness::cblas::CBLAS_TRANSPOSE right_op =
             (right_op_ == trans ? madness::cblas::Trans : madness::cblas::NoTrans);
 
+        // Select the arguments that are contracted without permuting their
+        // tiles. The tile indices, tiled range, and shape of these arguments
+        // are still permuted.
+        Permutation left_perm, right_perm;
+        {
+          const math::GemmHelper gemm_helper(left_op, right_op, vars_.dim(),
+              left_vars_.dim(), right_vars_.dim());
+          if(use_strided_contraction(left_, left_op_, average_tile_size(right_,
+              gemm_helper.right_outer_begin(), gemm_helper.right_outer_end())))
+          {
+            left_perm = left_.perm();
+            left_.permute_tiles(false);
+          }
+          if(use_strided_contraction(right_, right_op_, average_tile_size(left_,
+              gemm_helper.left_outer_begin(), gemm_helper.left_outer_end())))
+          {
+            right_perm = right_.perm();
+            right_.permute_tiles(false);
+          }
+        }
 
         if(target_vars != vars_) {
           // Initialize permuted structure
           perm_ = ExprEngine_::make_perm(target_vars);
           op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
-              right_vars_.dim(), (permute_tiles_ ? perm_ : Permutation()));
+              right_vars_.dim(), (permute_tiles_ ? perm_ : Permutation()),
+              left_perm, right_perm);
           trange_ = ContEngine_::make_trange(perm_);
           shape_ = ContEngine_::make_shape(perm_);
         } else {
           // Initialize non-permuted structure
           op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
-              right_vars_.dim());
+              right_vars_.dim(), Permutation(), left_perm, right_perm);
           trange_ = ContEngine_::make_trange();
           shape_ = ContEngine_::make_shape();
         }
@@ -414,29 +490,57 @@ namespace TiledArray {
             right_.trange().elements_range().extent_data();
 
         // Compute the fused sizes of the contraction
-        size_type M = 1ul, m = 1ul, N = 1ul, n = 1ul;
+        size_type M = 1ul, m = 1ul, N = 1ul, n = 1ul, k = 1ul;
         unsigned int i = 0u;
         for(; i < left_outer_rank; ++i) {
           M *= left_tiles_size[i];
           m *= left_element_size[i];
         }
-        for(; i < left_rank; ++i)
+        for(; i < left_rank; ++i) {
           K_ *= left_tiles_size[i];
+          k *= left_element_size[i];
+        }
         for(i = inner_rank; i < right_rank; ++i) {
           N *= right_tiles_size[i];
           n *= right_element_size[i];
         }
 
-        // Construct the process grid.
-        proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+        // Construct the process grid, which is replicated over several
+        // process layers (2.5D SUMMA) when they are enabled and reduce
+        // communication (see Summa::layers).
+        typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
+            typename right_type::dist_eval_type, op_type, typename Derived::policy> impl_type;
+        const size_type layers = impl_type::layers(world->size(), K_, m, n, k);
+        proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n, layers);
 
         // Initialize children
         left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
         right_.init_distribution(world, proc_grid_.make_col_phase_pmap(K_));
 
-        // Initialize the process map in not already defined
-        if(! pmap)
+        // Initialize the process map in not already defined, and check that
+        // the process map places each tile on its process in the grid. A
+        // cyclic process map is compared by its parameters, other process
+        // maps tile by tile.
+        if(! pmap) {
           pmap = proc_grid_.make_pmap();
+          grid_pmap_ = true;
+        } else if(const TiledArray::detail::CyclicPmap* const cyclic_pmap =
+            dynamic_cast<const TiledArray::detail::CyclicPmap*>(pmap.get()))
+        {
+          grid_pmap_ = (cyclic_pmap->nrows() == proc_grid_.rows()) &&
+              (cyclic_pmap->ncols() == proc_grid_.cols()) &&
+              (cyclic_pmap->nrows_proc() == proc_grid_.proc_rows()) &&
+              (cyclic_pmap->ncols_proc() == proc_grid_.proc_cols());
+        } else {
+          const std::shared_ptr<pmap_interface> grid_pmap = proc_grid_.make_pmap();
+          grid_pmap_ = true;
+          for(size_type t = 0ul; t < pmap->size(); ++t) {
+            if(pmap->owner(t) != grid_pmap->owner(t)) {
+              grid_pmap_ = false;
+              break;
+            }
+          }
+        }
         ExprEngine_::init_distribution(world, pmap);
       }
 
@@ -525,6 +629,37 @@ namespace TiledArray {
       }
 
       dist_eval_type make_dist_eval() const {
+        return make_fused_dist_eval(shape_, nullptr);
+      }
+
+      /// Check that additive terms can be fused with this contraction
+
+      /// The terms are added to the result tiles on the processes that
+      /// evaluate them, so the result must have a single process layer, no
+      /// symmetry and no permutation, and its process map must place each
+      /// tile on its process in the process grid.
+      /// \return \c true if \c make_fused_dist_eval() may be called with
+      /// additive terms
+      bool is_fusable() const {
+        return grid_pmap_ && (! perm_) && (! symmetry_) &&
+            (proc_grid_.proc_layers() == 1u) &&
+            ! (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape);
+      }
+
+      /// Construct the distributed evaluator for this contraction and fused additive terms
+
+      /// The result tiles are screened with \c shape rather than with the
+      /// shape of this contraction, so with sparse shapes a contraction tile
+      /// that is zero in the contraction shape is still computed when one of
+      /// the additive terms is non-zero at that tile.
+      /// \param shape The shape of the result, which includes the non-zero
+      /// tiles of the additive terms
+      /// \param epilogue The additive terms (may be null)
+      /// \return The distributed evaluator that will evaluate this expression
+      /// and add the terms to its tiles
+      dist_eval_type make_fused_dist_eval(const shape_type& shape,
+          const std::shared_ptr<TiledArray::detail::SummaEpilogue<value_type> >& epilogue) const
+      {
         // Define the impl type
         typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
             typename right_type::dist_eval_type, op_type, typename Derived::policy> impl_type;
@@ -533,12 +668,24 @@ namespace TiledArray {
         typename right_type::dist_eval_type right = right_.make_dist_eval();
 
         std::shared_ptr<impl_type> pimpl =
-            std::make_shared<impl_type>(left, right, *world_, trange_, shape_,
-                                        pmap_, perm_, op_, K_, proc_grid_);
+            std::make_shared<impl_type>(left, right, *world_, trange_, shape,
+                                        pmap_, perm_, op_, K_, proc_grid_,
+                                        symmetry_, epilogue);
 
         return dist_eval_type(pimpl);
       }
 
+      /// Initialize the symmetry of the result tiles
+
+      /// The contraction evaluates only the unique result tiles, and skips
+      /// the tile products that contribute to the other tiles.
+      /// \param symmetry The symmetry of the result tiles
+      /// \return \c true
+      bool init_symmetry(const std::shared_ptr<const symmetry::TileSymmetry>& symmetry) {
+        symmetry_ = symmetry;
+        return true;
+      }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -0,0 +1,831 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  contraction_order.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_CONTRACTION_ORDER_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_CONTRACTION_ORDER_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <TiledArray/type_traits.h>
+#include <TiledArray/expressions/variable_list.h>
+#include <TiledArray/expressions/intermediate_cache.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    template <typename, bool> class TsrExpr;
+    template <typename, typename> class ScalTsrExpr;
+    template <typename, typename> class MultExpr;
+    template <typename, typename, typename> class ScalMultExpr;
+
+    /// Contraction order optimization settings
+
+    /// When an expression that is a product of three or more tensors, e.g.
+    /// \code
+    /// r("a,b,i,j") = t("c,k") * t("d,l") * v("k,l,c,d") * t("a,b,i,j");
+    /// \endcode
+    /// is assigned to an array, the pairwise contractions are reordered to
+    /// minimize the number of floating point operations, and then the size of
+    /// the largest intermediate, instead of being evaluated left-to-right.
+    /// The costs are estimated from the element ranges and the fraction of
+    /// non-zero tiles of the arguments. The products are reordered only when
+    /// every index appears in exactly two arguments (and not in the result) or
+    /// in exactly one argument (and in the result), and only when the estimated
+    /// cost is lower than that of the order given by the expression.
+    /// Since reordering changes the evaluation order, and therefore the
+    /// rounding and the peak memory of existing expressions, it is disabled
+    /// by default. It may be enabled by setting the \c TA_CONTRACTION_ORDER
+    /// environment variable to \c 1 , or by calling \c enable() .
+    class ContractionOrder {
+
+      static bool init_enabled() {
+        const char* order = getenv("TA_CONTRACTION_ORDER");
+        if(order)
+          return std::atoi(order) != 0;
+        return false;
+      }
+
+      static std::atomic<bool>& flag() {
+        static std::atomic<bool> enabled(init_enabled());
+        return enabled;
+      }
+
+    public:
+
+      /// Enable or disable contraction reordering
+
+      /// \param enabled The reordering flag
+      static void enable(const bool enabled = true) { flag() = enabled; }
+
+      /// Reordering flag accessor
+
+      /// \return \c true if contraction reordering is enabled
+      static bool enabled() { return flag(); }
+
+    }; // class ContractionOrder
+
+    namespace detail {
+
+      /// Contraction order planner
+
+      /// The planner finds the pairwise contraction order of a product of
+      /// tensors that minimizes the estimated number of floating point
+      /// operations and, among orders with equal operation counts, the size of
+      /// the largest intermediate. The exact optimum is found by dynamic
+      /// programming over the subsets of the arguments for up to
+      /// \c max_exact_size arguments; larger products are ordered greedily.
+      /// The nodes of a plan are numbered with the arguments first, in the
+      /// order they were added, followed by the result of each step.
+      class ContractionPlanner {
+      public:
+        typedef std::uint64_t vars_mask; ///< Set of indices
+        typedef std::uint32_t operands_mask; ///< Set of arguments
+
+        /// A pairwise contraction of two nodes
+        struct Step {
+          unsigned int left; ///< The left-hand node
+          unsigned int right; ///< The right-hand node
+        }; // struct Step
+
+        /// The estimated cost of a plan
+        struct Cost {
+          double flops; ///< Floating point operations
+          double memory; ///< Elements of the largest intermediate
+        }; // struct Cost
+
+        static constexpr unsigned int max_exact_size = 10u; ///< Maximum number of arguments ordered exactly
+        static constexpr unsigned int max_size = 32u; ///< Maximum number of arguments
+        static constexpr double tolerance = 0.01; ///< Minimum relative improvement of a reordered plan
+
+      private:
+
+        /// A node of a plan, i.e. an argument or an intermediate
+        struct Node {
+          operands_mask operands; ///< The arguments of this node
+          vars_mask vars; ///< The indices of this node
+          double density; ///< Estimated fraction of non-zero elements
+        }; // struct Node
+
+        std::vector<std::string> vars_; ///< Index names
+        std::vector<double> extents_; ///< Number of elements of each index
+        std::vector<double> tiles_; ///< Number of tiles of each index
+        std::vector<Node> operands_; ///< Arguments
+        vars_mask target_; ///< Indices of the result
+        bool valid_; ///< Flag for products that may be reordered
+
+        unsigned int find_var(const std::string& var) {
+          unsigned int i = 0u;
+          for(; i < vars_.size(); ++i)
+            if(vars_[i] == var)
+              return i;
+          vars_.push_back(var);
+          extents_.push_back(0.0);
+          tiles_.push_back(0.0);
+          return i;
+        }
+
+        double volume(vars_mask vars) const {
+          double result = 1.0;
+          for(unsigned int i = 0u; vars; ++i, vars >>= 1)
+            if(vars & 1u)
+              result *= extents_[i];
+          return result;
+        }
+
+        double tile_count(vars_mask vars) const {
+          double result = 1.0;
+          for(unsigned int i = 0u; vars; ++i, vars >>= 1)
+            if(vars & 1u)
+              result *= tiles_[i];
+          return result;
+        }
+
+        /// Indices of the intermediate of a set of arguments
+
+        /// \param operands A set of arguments
+        /// \return The indices of \c operands that appear in the other
+        /// arguments or in the result
+        vars_mask external(const operands_mask operands) const {
+          vars_mask inside = 0u, outside = target_;
+          for(unsigned int i = 0u; i < operands_.size(); ++i) {
+            if(operands & (operands_mask(1) << i))
+              inside |= operands_[i].vars;
+            else
+              outside |= operands_[i].vars;
+          }
+          return inside & outside;
+        }
+
+        /// Contract two nodes
+
+        /// \param left The left-hand node
+        /// \param right The right-hand node
+        /// \param[in,out] cost The cost of the plan, which is incremented by
+        /// the cost of this step
+        /// \return The result node
+        Node contract(const Node& left, const Node& right, Cost& cost) const {
+          const operands_mask operands = left.operands | right.operands;
+          const vars_mask vars = external(operands);
+          const vars_mask inner = (left.vars | right.vars) & ~vars;
+
+          // A result tile is zero when all products of argument tiles in its
+          // sum are zero.
+          const double pair_density = left.density * right.density;
+          const double density = (inner ?
+              1.0 - std::pow(1.0 - pair_density, tile_count(inner)) :
+              pair_density);
+
+          cost.flops += 2.0 * volume(left.vars | right.vars) * pair_density;
+          if(operands != all())
+            cost.memory = std::max(cost.memory, volume(vars) * density);
+
+          return Node{ operands, vars, density };
+        }
+
+        operands_mask all() const {
+          return (operands_.size() < max_size ?
+              (operands_mask(1) << operands_.size()) - 1u :
+              ~operands_mask(0));
+        }
+
+        static bool less(const Cost& c1, const Cost& c2) {
+          return (c1.flops < c2.flops) ||
+              ((c1.flops == c2.flops) && (c1.memory < c2.memory));
+        }
+
+        std::vector<Step> optimize_exact() const;
+        std::vector<Step> optimize_greedy() const;
+
+      public:
+
+        /// Constructor
+
+        /// \param target The indices of the result
+        explicit ContractionPlanner(const VariableList& target) :
+          vars_(), extents_(), tiles_(), operands_(), target_(0u), valid_(true)
+        {
+          for(const auto& var : target) {
+            const unsigned int i = find_var(var);
+            if(target_ & (vars_mask(1) << i))
+              valid_ = false;
+            target_ |= vars_mask(1) << i;
+          }
+        }
+
+        /// Add an argument
+
+        /// \tparam TRange The tiled range type
+        /// \param vars The indices of the argument
+        /// \param trange The tiled range of the argument
+        /// \param density The fraction of non-zero tiles of the argument
+        template <typename TRange>
+        void add_operand(const VariableList& vars, const TRange& trange,
+            const double density)
+        {
+          Node node{ operands_mask(1) << (operands_.size() % max_size), 0u, density };
+          if((operands_.size() >= max_size) || (vars.dim() != trange.data().size()))
+            valid_ = false;
+
+          for(unsigned int d = 0u; valid_ && (d < vars.dim()); ++d) {
+            const unsigned int i = find_var(vars[d]);
+            if(i >= std::numeric_limits<vars_mask>::digits) {
+              valid_ = false;
+              break;
+            }
+            const auto& elements = trange.data()[d].elements_range();
+            const auto& tiles = trange.data()[d].tiles_range();
+            const double extent = elements.second - elements.first;
+            const double tile_count = tiles.second - tiles.first;
+
+            // Repeated indices of an argument are not supported, and the
+            // ranges of an index must agree.
+            if((node.vars & (vars_mask(1) << i)) || ((extents_[i] != 0.0) &&
+                ((extents_[i] != extent) || (tiles_[i] != tile_count))))
+              valid_ = false;
+            node.vars |= vars_mask(1) << i;
+            extents_[i] = extent;
+            tiles_[i] = tile_count;
+          }
+
+          operands_.push_back(node);
+        }
+
+        /// Number of arguments accessor
+
+        /// \return The number of arguments
+        unsigned int size() const { return operands_.size(); }
+
+        /// Check that the product may be reordered
+
+        /// \return \c true if each index appears in two arguments and not in
+        /// the result, or in one argument and in the result
+        bool is_valid() const {
+          if(! valid_ || ! target_ || (operands_.size() < 2u) ||
+              (vars_.size() > std::numeric_limits<vars_mask>::digits))
+            return false;
+          for(unsigned int i = 0u; i < vars_.size(); ++i) {
+            const vars_mask var = vars_mask(1) << i;
+            unsigned int count = 0u;
+            for(const Node& operand : operands_)
+              if(operand.vars & var)
+                ++count;
+            if(count != ((target_ & var) ? 1u : 2u))
+              return false;
+          }
+          return true;
+        }
+
+        /// Estimate the cost of a plan
+
+        /// \param steps The steps of the plan
+        /// \return The cost of \c steps
+        Cost cost(const std::vector<Step>& steps) const {
+          std::vector<Node> nodes(operands_);
+          Cost result{ 0.0, 0.0 };
+          for(const Step& step : steps)
+            nodes.push_back(contract(nodes[step.left], nodes[step.right], result));
+          return result;
+        }
+
+        /// Find the optimal contraction order
+
+        /// Products of two tensors that do not share an index (outer products)
+        /// are not considered.
+        /// \return The steps of the optimal plan, or an empty plan when the
+        /// arguments may not be contracted without outer products
+        std::vector<Step> optimize() const {
+          TA_ASSERT(is_valid());
+          return (operands_.size() <= max_exact_size ? optimize_exact() :
+              optimize_greedy());
+        }
+
+        /// Compare two plans
+
+        /// \param plan The candidate plan
+        /// \param reference The reference plan
+        /// \return \c true if \c plan is cheaper than \c reference by more
+        /// than \c tolerance
+        bool is_better(const std::vector<Step>& plan,
+            const std::vector<Step>& reference) const
+        {
+          const Cost c1 = cost(plan);
+          const Cost c2 = cost(reference);
+          if(c1.flops < c2.flops * (1.0 - tolerance))
+            return true;
+          return (c1.flops <= c2.flops * (1.0 + tolerance)) &&
+              (c1.memory < c2.memory * (1.0 - tolerance));
+        }
+
+        /// Intermediate indices accessor
+
+        /// \param steps The steps of a plan
+        /// \param node A node of \c steps
+        /// \return The indices of \c node , in the order of their first
+        /// appearance in the arguments
+        VariableList vars(const std::vector<Step>& steps, const unsigned int node) const {
+          std::vector<operands_mask> operands;
+          for(unsigned int i = 0u; i < operands_.size(); ++i)
+            operands.push_back(operands_[i].operands);
+          for(const Step& step : steps)
+            operands.push_back(operands[step.left] | operands[step.right]);
+
+          std::vector<std::string> result;
+          vars_mask vars = external(operands[node]);
+          for(unsigned int i = 0u; vars; ++i, vars >>= 1)
+            if(vars & 1u)
+              result.push_back(vars_[i]);
+          return VariableList(result.begin(), result.end());
+        }
+
+      }; // class ContractionPlanner
+
+      inline std::vector<ContractionPlanner::Step>
+      ContractionPlanner::optimize_exact() const {
+        const operands_mask full = all();
+        const double inf = std::numeric_limits<double>::infinity();
+
+        // best[s] is the optimal cost of subset s, split[s] its left-hand part
+        std::vector<Cost> best(full + 1u, Cost{ inf, inf });
+        std::vector<operands_mask> split(full + 1u, 0u);
+        std::vector<Node> nodes(full + 1u);
+        for(unsigned int i = 0u; i < operands_.size(); ++i) {
+          best[operands_[i].operands] = Cost{ 0.0, 0.0 };
+          nodes[operands_[i].operands] = operands_[i];
+        }
+
+        for(operands_mask s = 1u; s <= full; ++s) {
+          if(! (s & (s - 1u)))
+            continue;
+          // Each split {l, s - l} is visited once, with the lowest argument of s in l
+          const operands_mask low = s & (~s + 1u);
+          for(operands_mask l = (s - 1u) & s; l; l = (l - 1u) & s) {
+            const operands_mask r = s & ~l;
+            if(! (l & low) || (best[l].flops == inf) || (best[r].flops == inf))
+              continue;
+            if(! (nodes[l].vars & nodes[r].vars))
+              continue;
+
+            Cost cost{ best[l].flops + best[r].flops,
+                std::max(best[l].memory, best[r].memory) };
+            const Node node = contract(nodes[l], nodes[r], cost);
+            if(less(cost, best[s])) {
+              best[s] = cost;
+              split[s] = l;
+              nodes[s] = node;
+            }
+          }
+        }
+
+        std::vector<Step> steps;
+        if(best[full].flops == inf)
+          return steps;
+
+        // Unwind the splits into steps, children before their parent
+        std::vector<unsigned int> ids(full + 1u, 0u);
+        for(unsigned int i = 0u; i < operands_.size(); ++i)
+          ids[operands_[i].operands] = i;
+        std::vector<std::pair<operands_mask, bool> > stack(1, std::make_pair(full, false));
+        while(! stack.empty()) {
+          const std::pair<operands_mask, bool> top = stack.back();
+          stack.pop_back();
+          const operands_mask s = top.first;
+          if(! (s & (s - 1u)))
+            continue;
+          const operands_mask l = split[s], r = s & ~l;
+          if(top.second) {
+            ids[s] = operands_.size() + steps.size();
+            steps.push_back(Step{ ids[l], ids[r] });
+          } else {
+            stack.emplace_back(s, true);
+            stack.emplace_back(r, false);
+            stack.emplace_back(l, false);
+          }
+        }
+
+        return steps;
+      }
+
+      inline std::vector<ContractionPlanner::Step>
+      ContractionPlanner::optimize_greedy() const {
+        // Contract the pair of nodes that shares an index and has the
+        // cheapest contraction until one node remains
+        std::vector<Node> nodes(operands_);
+        std::vector<unsigned int> active;
+        for(unsigned int i = 0u; i < operands_.size(); ++i)
+          active.push_back(i);
+
+        std::vector<Step> steps;
+        while(active.size() > 1u) {
+          const double inf = std::numeric_limits<double>::infinity();
+          Cost best{ inf, inf };
+          std::size_t best_i = 0ul, best_j = 0ul;
+          Node best_node{ 0u, 0u, 0.0 };
+          for(std::size_t i = 0ul; i < active.size(); ++i) {
+            for(std::size_t j = i + 1ul; j < active.size(); ++j) {
+              const Node& left = nodes[active[i]];
+              const Node& right = nodes[active[j]];
+              if(! (left.vars & right.vars))
+                continue;
+              Cost cost{ 0.0, 0.0 };
+              const Node node = contract(left, right, cost);
+              if(less(cost, best)) {
+                best = cost;
+                best_i = i;
+                best_j = j;
+                best_node = node;
+              }
+            }
+          }
+          if(best.flops == inf)
+            return std::vector<Step>();
+
+          steps.push_back(Step{ active[best_i], active[best_j] });
+          nodes.push_back(best_node);
+          active.erase(active.begin() + best_j);
+          active[best_i] = nodes.size() - 1u;
+        }
+
+        return steps;
+      }
+
+      /// A product of arrays collected from a product expression
+
+      /// \tparam A The array type
+      template <typename A>
+      class ContractionChain {
+      public:
+        typedef TiledArray::detail::numeric_t<A> numeric_type; ///< The array numeric type
+        typedef ContractionPlanner::Step step_type; ///< A pairwise contraction
+
+      private:
+        std::vector<std::pair<const A*, std::string> > operands_; ///< Arrays and their indices
+        std::vector<step_type> steps_; ///< The order given by the expression
+        numeric_type factor_; ///< The product of the scaling factors
+        bool valid_; ///< Flag for chains that may be reordered
+
+        static void evaluate(TsrExpr<A, true> result, const A& left,
+            const VariableList& left_vars, const A& right,
+            const VariableList& right_vars, World& world)
+        {
+          result = (left(left_vars.string()) * right(right_vars.string())).set_world(world);
+        }
+
+        /// The order given by the expression, with the planner node numbering
+        std::vector<step_type> reference() const {
+          auto node = [&] (const unsigned int i) -> unsigned int {
+            return (i < ContractionPlanner::max_size ? i :
+                operands_.size() + i - ContractionPlanner::max_size);
+          };
+          std::vector<step_type> result;
+          for(const step_type& step : steps_)
+            result.push_back(step_type{ node(step.left), node(step.right) });
+          return result;
+        }
+
+        /// Add the arguments of the chain to a planner
+
+        /// \param planner The planner
+        /// \return \c true if the chain may be reordered or cached
+        bool init_planner(ContractionPlanner& planner) const {
+          if(! valid_ || (operands_.size() < 2u))
+            return false;
+          for(const auto& operand : operands_) {
+            if(! operand.first->is_initialized())
+              return false;
+            planner.add_operand(VariableList(operand.second),
+                operand.first->trange(),
+                1.0 - double(operand.first->shape().sparsity()));
+          }
+          return planner.is_valid();
+        }
+
+        /// Reorder the contractions
+
+        /// \param planner The planner of this chain
+        /// \param[out] plan The optimal order when it reduces the estimated
+        /// cost, otherwise the order given by the expression
+        /// \return \c true if \c plan was reordered
+        bool reorder(const ContractionPlanner& planner,
+            std::vector<step_type>& plan) const
+        {
+          plan = reference();
+          if(! ContractionOrder::enabled() || (operands_.size() < 3u))
+            return false;
+          std::vector<step_type> optimized = planner.optimize();
+          if(optimized.empty() || ! planner.is_better(optimized, plan))
+            return false;
+          plan = std::move(optimized);
+          return true;
+        }
+
+      public:
+
+        ContractionChain() : operands_(), steps_(), factor_(1), valid_(true) { }
+
+        /// Add an argument
+
+        /// \param array The argument array
+        /// \param vars The indices of the argument
+        /// \return The node of the argument
+        unsigned int add_operand(const A& array, const std::string& vars) {
+          operands_.emplace_back(& array, vars);
+          return operands_.size() - 1u;
+        }
+
+        /// Add a pairwise product
+
+        /// Products are numbered from \c ContractionPlanner::max_size , since
+        /// they may be added before all arguments are known.
+        /// \param left The left-hand node
+        /// \param right The right-hand node
+        /// \return The node of the product
+        unsigned int add_step(const unsigned int left, const unsigned int right) {
+          steps_.push_back(step_type{ left, right });
+          return ContractionPlanner::max_size + steps_.size() - 1u;
+        }
+
+        /// Scale the product
+
+        /// \param factor The scaling factor
+        void scale(const numeric_type factor) { factor_ *= factor; }
+
+        /// Mark the chain as one that may not be reordered
+        void invalidate() { valid_ = false; }
+
+        /// Contraction order accessor
+
+        /// \param vars The indices of the result
+        /// \return The pairwise contractions in the order they are evaluated
+        /// by \c eval_to , with the \c ContractionPlanner node numbering, or
+        /// an empty list if the chain may not be reordered
+        std::vector<step_type> order(const std::string& vars) const {
+          ContractionPlanner planner{ VariableList(vars) };
+          std::vector<step_type> plan;
+          if(init_planner(planner))
+            reorder(planner, plan);
+          return plan;
+        }
+
+        /// Evaluate the chain in the optimal contraction order
+
+        /// The intermediates and the product are looked up in, and stored to,
+        /// the \c IntermediateCache when it is enabled.
+        /// \tparam Alias The tensor expression flag
+        /// \param tsr The result tensor expression
+        /// \return \c false if the product may not be reordered or cached, or
+        /// reordering does not reduce its cost; \c tsr is not modified in that
+        /// case
+        template <bool Alias>
+        bool eval_to(TsrExpr<A, Alias>& tsr) const {
+          const bool cache = IntermediateCache::enabled();
+          if(! (ContractionOrder::enabled() || cache))
+            return false;
+
+          ContractionPlanner planner{ VariableList(tsr.vars()) };
+          if(! init_planner(planner))
+            return false;
+
+          std::vector<step_type> plan;
+          if(! reorder(planner, plan) && ! cache)
+            return false;
+
+          // The canonical key of a node is the sorted list of the keys of its
+          // arguments
+          std::vector<std::vector<std::string> > keys;
+          if(cache) {
+            for(const auto& operand : operands_)
+              keys.emplace_back(1, IntermediateCache::key(*operand.first,
+                  VariableList(operand.second).string()));
+            for(const step_type& step : plan) {
+              std::vector<std::string> key(keys[step.left]);
+              key.insert(key.end(), keys[step.right].begin(), keys[step.right].end());
+              std::sort(key.begin(), key.end());
+              keys.push_back(std::move(key));
+            }
+          }
+          auto key = [&] (const unsigned int i) -> std::string {
+            std::string result;
+            for(const std::string& k : keys[i])
+              result += k;
+            return result;
+          };
+
+          // Evaluate the intermediates in the world of the result
+          World& world = (tsr.array().is_initialized() ?
+              tsr.array().world() : TiledArray::get_default_world());
+          std::vector<A> intermediates(plan.size());
+          std::vector<VariableList> intermediate_vars(plan.size());
+          auto node = [&] (const unsigned int i) -> const A& {
+            return (i < operands_.size() ? *operands_[i].first :
+                intermediates[i - operands_.size()]);
+          };
+          auto node_vars = [&] (const unsigned int i) -> VariableList {
+            return (i < operands_.size() ? VariableList(operands_[i].second) :
+                intermediate_vars[i - operands_.size()]);
+          };
+          auto eval_step = [&] (const unsigned int s) {
+            const step_type& step = plan[s];
+            intermediate_vars[s] = planner.vars(plan, operands_.size() + s);
+            evaluate(intermediates[s](intermediate_vars[s].string()),
+                node(step.left), node_vars(step.left), node(step.right),
+                node_vars(step.right), world);
+          };
+
+          if(! cache) {
+            for(unsigned int s = 0u; s + 1u < plan.size(); ++s)
+              eval_step(s);
+
+            const step_type& step = plan.back();
+            const auto left = node(step.left)(node_vars(step.left).string());
+            const auto right = node(step.right)(node_vars(step.right).string());
+            if(factor_ == numeric_type(1))
+              tsr = left * right;
+            else
+              tsr = left * right * factor_;
+
+            return true;
+          }
+
+          // Evaluate the nodes that are not cached, starting from the product,
+          // so that the intermediates of cached nodes are not evaluated.
+          std::function<void(unsigned int)> eval_node = [&] (const unsigned int i) {
+            if(i < operands_.size())
+              return;
+            const unsigned int s = i - operands_.size();
+            std::string vars;
+            if(IntermediateCache::find(key(i), intermediates[s], vars)) {
+              intermediate_vars[s] = VariableList(vars);
+              return;
+            }
+            eval_node(plan[s].left);
+            eval_node(plan[s].right);
+            eval_step(s);
+            IntermediateCache::insert(key(i), intermediates[s],
+                intermediate_vars[s].string());
+          };
+          const unsigned int product = operands_.size() + plan.size() - 1u;
+          eval_node(product);
+
+          const auto result = node(product)(node_vars(product).string());
+          if(factor_ == numeric_type(1))
+            tsr = result;
+          else
+            tsr = result * factor_;
+
+          return true;
+        }
+
+      }; // class ContractionChain
+
+      /// Product expression traits
+
+      /// \c value is \c true when expression \c E is a product of arrays of
+      /// type \c A , with numeric scaling factors, that may be collected into a
+      /// \c ContractionChain .
+      /// \tparam E The expression type
+      /// \tparam A The array type
+      template <typename E, typename A>
+      struct ContractionChainTrait {
+        static constexpr bool value = false;
+      }; // struct ContractionChainTrait
+
+      template <typename A, bool Alias>
+      struct ContractionChainTrait<TsrExpr<A, Alias>, A> {
+        static constexpr bool value = true;
+
+        static unsigned int collect(const TsrExpr<A, Alias>& expr,
+            ContractionChain<A>& chain)
+        {
+          if(expr.is_overridden())
+            chain.invalidate();
+          return chain.add_operand(expr.array(), expr.vars());
+        }
+      }; // struct ContractionChainTrait<TsrExpr<A, Alias>, A>
+
+      template <typename A>
+      struct ContractionChainTrait<TsrExpr<const A, true>, A> {
+        static constexpr bool value = true;
+
+        static unsigned int collect(const TsrExpr<const A, true>& expr,
+            ContractionChain<A>& chain)
+        {
+          if(expr.is_overridden())
+            chain.invalidate();
+          return chain.add_operand(expr.array(), expr.vars());
+        }
+      }; // struct ContractionChainTrait<TsrExpr<const A, true>, A>
+
+      template <typename A, typename Scalar>
+      struct ContractionChainTrait<ScalTsrExpr<A, Scalar>, A> {
+        static constexpr bool value =
+            TiledArray::detail::is_numeric<Scalar>::value &&
+            std::is_convertible<Scalar, TiledArray::detail::numeric_t<A> >::value;
+
+        static unsigned int collect(const ScalTsrExpr<A, Scalar>& expr,
+            ContractionChain<A>& chain)
+        {
+          if(expr.is_overridden())
+            chain.invalidate();
+          chain.scale(expr.factor());
+          return chain.add_operand(expr.array(), expr.vars());
+        }
+      }; // struct ContractionChainTrait<ScalTsrExpr<A, Scalar>, A>
+
+      template <typename Left, typename Right, typename A>
+      struct ContractionChainTrait<MultExpr<Left, Right>, A> {
+        static constexpr bool value = ContractionChainTrait<Left, A>::value &&
+            ContractionChainTrait<Right, A>::value;
+
+        static unsigned int collect(const MultExpr<Left, Right>& expr,
+            ContractionChain<A>& chain)
+        {
+          if(expr.is_overridden())
+            chain.invalidate();
+          const unsigned int left =
+              ContractionChainTrait<Left, A>::collect(expr.left(), chain);
+          const unsigned int right =
+              ContractionChainTrait<Right, A>::collect(expr.right(), chain);
+          return chain.add_step(left, right);
+        }
+      }; // struct ContractionChainTrait<MultExpr<Left, Right>, A>
+
+      template <typename Left, typename Right, typename Scalar, typename A>
+      struct ContractionChainTrait<ScalMultExpr<Left, Right, Scalar>, A> {
+        static constexpr bool value = ContractionChainTrait<Left, A>::value &&
+            ContractionChainTrait<Right, A>::value &&
+            TiledArray::detail::is_numeric<Scalar>::value &&
+            std::is_convertible<Scalar, TiledArray::detail::numeric_t<A> >::value;
+
+        static unsigned int collect(const ScalMultExpr<Left, Right, Scalar>& expr,
+            ContractionChain<A>& chain)
+        {
+          if(expr.is_overridden())
+            chain.invalidate();
+          chain.scale(expr.factor());
+          const unsigned int left =
+              ContractionChainTrait<Left, A>::collect(expr.left(), chain);
+          const unsigned int right =
+              ContractionChainTrait<Right, A>::collect(expr.right(), chain);
+          return chain.add_step(left, right);
+        }
+      }; // struct ContractionChainTrait<ScalMultExpr<Left, Right, Scalar>, A>
+
+      /// Evaluate a product of arrays in the optimal contraction order
+
+      /// \tparam E The product expression type
+      /// \tparam A The result array type
+      /// \tparam Alias The tensor expression flag
+      /// \param expr The product expression
+      /// \param tsr The result tensor expression
+      /// \return \c false if \c expr was not evaluated, i.e. when it may not
+      /// be reordered or cached, or when reordering does not reduce its cost
+      template <typename E, typename A, bool Alias>
+      inline typename std::enable_if<ContractionChainTrait<E, A>::value, bool>::type
+      eval_product(const E& expr, TsrExpr<A, Alias>& tsr) {
+        if(! ContractionOrder::enabled() && ! IntermediateCache::enabled())
+          return false;
+        ContractionChain<A> chain;
+        ContractionChainTrait<E, A>::collect(expr, chain);
+        return chain.eval_to(tsr);
+      }
+
+      template <typename E, typename A, bool Alias>
+      inline typename std::enable_if<! ContractionChainTrait<E, A>::value, bool>::type
+      eval_product(const E&, TsrExpr<A, Alias>&) { return false; }
+
+    } // namespace detail
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_CONTRACTION_ORDER_H__INCLUDED
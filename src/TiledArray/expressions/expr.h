@@ -28,6 +28,7 @@
 
 #include "expr_engine.h"
 #include "../reduce_task.h"
+#include "../symm/tile_symmetry.h"
 #include "../tile_interface/cast.h"
 #include "../tile_interface/scale.h"
 #include "../tile_op/shift.h"
@@ -136,6 +137,12 @@ namespace TiledArray {
         return derived();
       }
 
+      /// Check for overridden result parameters
+
+      /// \return \c true if the world, process map, or shape of the result
+      /// of this expression was set by the user
+      bool is_overridden() const { return static_cast<bool>(override_ptr_); }
+
     private:
 
       /// Task function used to evaluate a lazy tile and apply an op
@@ -311,6 +318,16 @@ namespace TiledArray {
         engine_type engine(derived());
         engine.init(world, pmap, target_vars);
 
+        // Only the unique tiles of a symmetric result are stored. The
+        // evaluator may skip the evaluation of the other tiles.
+        std::shared_ptr<const TiledArray::symmetry::TileSymmetry> symmetry;
+        if(tsr.array().is_initialized()) {
+          symmetry = tsr.array().symmetry();
+          if(symmetry && ! symmetry->is_compatible(engine.trange()))
+            symmetry.reset();
+        }
+        const bool unique_only = symmetry && engine.init_symmetry(symmetry);
+
         // Create the distributed evaluator from this expression
         typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
         dist_eval.eval();
@@ -318,12 +335,18 @@ namespace TiledArray {
         // Create the result array
         A result(dist_eval.world(), dist_eval.trange(),
             dist_eval.shape(), dist_eval.pmap());
+        if(symmetry)
+          result.set_symmetry(symmetry);
 
         // Move the data from dist_eval into the result array. There is no
         // communication in this step.
         for(const auto index : *dist_eval.pmap()) {
-          if(! dist_eval.is_zero(index))
-            set_tile(result, index, dist_eval.get(index));
+          if(! dist_eval.is_zero(index)) {
+            if(! symmetry || result.is_unique(index))
+              set_tile(result, index, dist_eval.get(index));
+            else if(! unique_only)
+              dist_eval.discard(index);
+          }
         }
 
         // Wait for child expressions of dist_eval
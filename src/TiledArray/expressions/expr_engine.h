@@ -30,6 +30,13 @@
 #include <TiledArray/expressions/expr_trace.h>
 
 namespace TiledArray {
+  namespace symmetry {
+    class TileSymmetry;
+  } // namespace symmetry
+  namespace detail {
+    template <typename> class SummaEpilogue;
+  } // namespace detail
+
   namespace expressions {
 
     // Forward declarations
@@ -160,6 +167,40 @@ namespace TiledArray {
         pmap_ = pmap;
       }
 
+      /// Initialize the symmetry of the result tiles
+
+      /// This is called for the top-level expression of an assignment to a
+      /// symmetric array, after \c init() . Derived classes that can skip the
+      /// evaluation of non-unique result tiles may provide their own
+      /// implementation of this function.
+      /// \return \c true if the distributed evaluator will evaluate only the
+      /// unique tiles, otherwise \c false
+      bool init_symmetry(const std::shared_ptr<const symmetry::TileSymmetry>&) {
+        return false;
+      }
+
+      /// Check that additive terms can be fused with this expression
+
+      /// Additive terms are fused with contractions, which add the terms to
+      /// their result tiles as soon as they are reduced. Derived classes that
+      /// support fused terms provide their own implementation of this
+      /// function and of \c make_fused_dist_eval() .
+      /// \return \c true if \c make_fused_dist_eval() may be called,
+      /// otherwise \c false
+      bool is_fusable() const { return false; }
+
+      /// Construct the distributed evaluator for this expression and fused additive terms
+
+      /// This is only called when \c is_fusable() is \c true .
+      /// \return The distributed evaluator that will evaluate this expression
+      /// and add the terms to its tiles
+      dist_eval_type make_fused_dist_eval(const shape_type&,
+          const std::shared_ptr<TiledArray::detail::SummaEpilogue<value_type> >&) const
+      {
+        TA_ASSERT(false);
+        return derived().make_dist_eval();
+      }
+
       /// Permutation factory function
 
       /// This function will generate the permutation that will be applied to
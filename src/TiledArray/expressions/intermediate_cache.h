@@ -0,0 +1,278 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  intermediate_cache.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_INTERMEDIATE_CACHE_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_INTERMEDIATE_CACHE_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/type_traits.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Cache of evaluated products
+
+    /// When the cache is enabled, the products of arrays that are assigned to
+    /// arrays, and the intermediates of their contractions, are stored and
+    /// reused by later assignments with the same arguments. For example, the
+    /// product \c t("a,b,k,l")*v("k,l,i,j") is evaluated only once in
+    /// \code
+    /// r1("a,b,i,j") = t("a,b,k,l") * v("k,l,i,j");
+    /// r2("b,a,i,j") = 0.5 * t("a,b,k,l") * v("k,l,i,j");
+    /// \endcode
+    /// An entry is identified by the ids of the argument arrays, their
+    /// annotations, and the array type; the order of the arguments and the
+    /// scaling factor of the product are not part of the key. Since the
+    /// assignment of an expression to an array creates a new array (with a new
+    /// id), the entries of arrays that have been reassigned are not used
+    /// again. Modifications of the tiles of an array in place, e.g. with
+    /// \c foreach_inplace or by writing to the data of a tile, are not
+    /// detected; call \c clear() after such modifications.
+    ///
+    /// The memory of the cached arrays is estimated from their element ranges
+    /// and shapes, and the least recently used entries are evicted when the
+    /// estimate exceeds the memory budget. Since the estimate depends only on
+    /// replicated data, all processes make the same caching decisions. The
+    /// cache is disabled by default; it is enabled by setting the
+    /// \c TA_INTERMEDIATE_CACHE environment variable to the budget in
+    /// megabytes (per process), or by calling \c enable() . The cached arrays
+    /// are released by \c TiledArray::finalize() .
+    class IntermediateCache {
+
+      /// A cached array
+      struct Entry {
+        std::string key; ///< The canonical key of the cached product
+        std::shared_ptr<void> array; ///< The cached array
+        std::string vars; ///< The annotation of the cached array
+        std::size_t bytes; ///< Estimated size of the local tiles
+      }; // struct Entry
+
+      typedef std::list<Entry> list_type;
+
+      std::atomic<std::size_t> budget_; ///< Memory budget in bytes
+      std::size_t bytes_; ///< Estimated memory of the cached arrays
+      std::size_t hits_; ///< Number of successful look-ups
+      std::size_t misses_; ///< Number of failed look-ups
+      list_type entries_; ///< Entries, most recently used first
+      std::unordered_map<std::string, list_type::iterator> index_; ///< Entry look-up table
+      madness::Spinlock lock_; ///< Lock that protects the entries
+
+      static std::size_t init_budget() {
+        const char* budget = getenv("TA_INTERMEDIATE_CACHE");
+        if(budget)
+          return std::size_t(std::max(std::atol(budget), 0l)) << 20;
+        return 0ul;
+      }
+
+      IntermediateCache() :
+        budget_(init_budget()), bytes_(0ul), hits_(0ul), misses_(0ul),
+        entries_(), index_(), lock_()
+      {
+        // The cached arrays must be destroyed before their World
+        TiledArray::detail::at_finalize([] () { IntermediateCache::clear(); });
+      }
+
+      static IntermediateCache& instance() {
+        static IntermediateCache cache;
+        return cache;
+      }
+
+      /// Evict the least recently used entries
+
+      /// \param bytes The memory that is required for a new entry
+      void evict(const std::size_t bytes) {
+        while(! entries_.empty() && (bytes_ + bytes > budget_)) {
+          bytes_ -= entries_.back().bytes;
+          index_.erase(entries_.back().key);
+          entries_.pop_back();
+        }
+      }
+
+      template <typename A>
+      static std::string typed_key(const std::string& key) {
+        return std::string(typeid(A).name()) + '|' + key;
+      }
+
+      /// Estimate the memory of the local tiles of an array
+
+      /// \tparam A The array type
+      /// \param array The array
+      /// \return The estimated number of bytes of the local tiles of \c array
+      template <typename A>
+      static std::size_t local_bytes(const A& array) {
+        const double elements = double(array.trange().elements_range().volume())
+            * (1.0 - double(array.shape().sparsity()));
+        return std::size_t(elements * sizeof(TiledArray::detail::numeric_t<A>)
+            / double(array.world().size()));
+      }
+
+    public:
+
+      /// Enable or disable the cache
+
+      /// \param budget The memory budget in bytes; the cache is disabled and
+      /// cleared when \c budget is zero
+      static void enable(const std::size_t budget) {
+        IntermediateCache& cache = instance();
+        madness::ScopedMutex<madness::Spinlock> locker(& cache.lock_);
+        cache.budget_ = budget;
+        if(budget) {
+          cache.evict(0ul);
+        } else {
+          cache.entries_.clear();
+          cache.index_.clear();
+          cache.bytes_ = 0ul;
+        }
+      }
+
+      /// Cache flag accessor
+
+      /// \return \c true if the cache is enabled
+      static bool enabled() { return instance().budget_ != 0ul; }
+
+      /// Memory budget accessor
+
+      /// \return The memory budget in bytes
+      static std::size_t budget() { return instance().budget_; }
+
+      /// Memory usage accessor
+
+      /// \return The estimated memory of the cached arrays in bytes
+      static std::size_t size() {
+        IntermediateCache& cache = instance();
+        madness::ScopedMutex<madness::Spinlock> locker(& cache.lock_);
+        return cache.bytes_;
+      }
+
+      /// Hit count accessor
+
+      /// \return The number of look-ups that found a cached array
+      static std::size_t hits() {
+        IntermediateCache& cache = instance();
+        madness::ScopedMutex<madness::Spinlock> locker(& cache.lock_);
+        return cache.hits_;
+      }
+
+      /// Miss count accessor
+
+      /// \return The number of look-ups that did not find a cached array
+      static std::size_t misses() {
+        IntermediateCache& cache = instance();
+        madness::ScopedMutex<madness::Spinlock> locker(& cache.lock_);
+        return cache.misses_;
+      }
+
+      /// Remove all entries and reset the hit and miss counts
+      static void clear() {
+        IntermediateCache& cache = instance();
+        madness::ScopedMutex<madness::Spinlock> locker(& cache.lock_);
+        cache.entries_.clear();
+        cache.index_.clear();
+        cache.bytes_ = 0ul;
+        cache.hits_ = 0ul;
+        cache.misses_ = 0ul;
+      }
+
+      /// Array key
+
+      /// \tparam A The array type
+      /// \param array An argument array
+      /// \param vars The annotation of \c array
+      /// \return The key of \c array in the canonical key of a product
+      template <typename A>
+      static std::string key(const A& array, const std::string& vars) {
+        const madness::uniqueidT id = array.id();
+        return std::to_string(id.get_world_id()) + ':' +
+            std::to_string(id.get_obj_id()) + '(' + vars + ')';
+      }
+
+      /// Find a cached array
+
+      /// \tparam A The array type
+      /// \param[in] key The canonical key of the product
+      /// \param[out] array The cached array
+      /// \param[out] vars The annotation of the cached array
+      /// \return \c true if the product is cached
+      template <typename A>
+      static bool find(const std::string& key, A& array, std::string& vars) {
+        IntermediateCache& cache = instance();
+        madness::ScopedMutex<madness::Spinlock> locker(& cache.lock_);
+        auto it = cache.index_.find(typed_key<A>(key));
+        if(it == cache.index_.end()) {
+          ++cache.misses_;
+          return false;
+        }
+
+        ++cache.hits_;
+        cache.entries_.splice(cache.entries_.begin(), cache.entries_, it->second);
+        array = *std::static_pointer_cast<A>(it->second->array);
+        vars = it->second->vars;
+        return true;
+      }
+
+      /// Store an array
+
+      /// Arrays larger than the memory budget are not stored.
+      /// \tparam A The array type
+      /// \param key The canonical key of the product
+      /// \param array The evaluated product
+      /// \param vars The annotation of \c array
+      template <typename A>
+      static void insert(const std::string& key, const A& array,
+          const std::string& vars)
+      {
+        const std::size_t bytes = local_bytes(array);
+        const std::string full_key = typed_key<A>(key);
+
+        IntermediateCache& cache = instance();
+        madness::ScopedMutex<madness::Spinlock> locker(& cache.lock_);
+        auto it = cache.index_.find(full_key);
+        if(it != cache.index_.end()) {
+          cache.bytes_ -= it->second->bytes;
+          cache.entries_.erase(it->second);
+          cache.index_.erase(it);
+        }
+        if(bytes > cache.budget_)
+          return;
+
+        cache.evict(bytes);
+        cache.entries_.push_front(Entry{ full_key,
+            std::static_pointer_cast<void>(std::make_shared<A>(array)), vars,
+            bytes });
+        cache.index_.emplace(full_key, cache.entries_.begin());
+        cache.bytes_ += bytes;
+      }
+
+    }; // class IntermediateCache
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_INTERMEDIATE_CACHE_H__INCLUDED
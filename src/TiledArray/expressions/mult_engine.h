@@ -329,6 +329,23 @@ namespace TiledArray {
           return BinaryEngine_::make_dist_eval();
       }
 
+      /// Initialize the symmetry of the result tiles
+
+      /// \param symmetry The symmetry of the result tiles
+      /// \return \c true if this expression is a contraction, which evaluates
+      /// only the unique tiles, otherwise \c false
+      bool init_symmetry(const std::shared_ptr<const symmetry::TileSymmetry>& symmetry) {
+        return contract_ && ContEngine_::init_symmetry(symmetry);
+      }
+
+      /// Check that additive terms can be fused with this expression
+
+      /// \return \c true if this expression is a contraction that can be
+      /// fused with additive terms, otherwise \c false
+      bool is_fusable() const {
+        return contract_ && ContEngine_::is_fusable();
+      }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -510,6 +527,23 @@ namespace TiledArray {
           return BinaryEngine_::make_dist_eval();
       }
 
+      /// Initialize the symmetry of the result tiles
+
+      /// \param symmetry The symmetry of the result tiles
+      /// \return \c true if this expression is a contraction, which evaluates
+      /// only the unique tiles, otherwise \c false
+      bool init_symmetry(const std::shared_ptr<const symmetry::TileSymmetry>& symmetry) {
+        return contract_ && ContEngine_::init_symmetry(symmetry);
+      }
+
+      /// Check that additive terms can be fused with this expression
+
+      /// \return \c true if this expression is a contraction that can be
+      /// fused with additive terms, otherwise \c false
+      bool is_fusable() const {
+        return contract_ && ContEngine_::is_fusable();
+      }
+
       /// Non-permuting tiled range factory function
 
       /// \return The result tiled range object
@@ -28,6 +28,7 @@
 
 #include <TiledArray/expressions/binary_expr.h>
 #include <TiledArray/expressions/mult_engine.h>
+#include <TiledArray/expressions/contraction_order.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -107,6 +108,22 @@ namespace TiledArray {
         BinaryExpr_(left, right)
       { }
 
+      using BinaryExpr_::eval_to;
+
+      /// Evaluate this expression and assign the result to an array
+
+      /// When \c ContractionOrder is enabled, products of three or more arrays
+      /// are contracted in the order with the lowest estimated cost, and
+      /// products are reused when the \c IntermediateCache is enabled.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor expression of the result array
+      template <typename A, bool Alias>
+      void eval_to(TsrExpr<A, Alias>& tsr) const {
+        if(! detail::eval_product(*this, tsr))
+          BinaryExpr_::eval_to(tsr);
+      }
+
 
       /// Dot product
 
@@ -177,6 +194,22 @@ namespace TiledArray {
       /// \return The scaling factor
       scalar_type factor() const { return factor_; }
 
+      using BinaryExpr_::eval_to;
+
+      /// Evaluate this expression and assign the result to an array
+
+      /// When \c ContractionOrder is enabled, products of three or more arrays
+      /// are contracted in the order with the lowest estimated cost, and
+      /// products are reused when the \c IntermediateCache is enabled.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor expression of the result array
+      template <typename A, bool Alias>
+      void eval_to(TsrExpr<A, Alias>& tsr) const {
+        if(! detail::eval_product(*this, tsr))
+          BinaryExpr_::eval_to(tsr);
+      }
+
     }; // class ScalMultExpr
 
 
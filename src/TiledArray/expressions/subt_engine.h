@@ -194,6 +194,36 @@ namespace TiledArray {
       /// \return The tile operation
       static op_type make_tile_op(const Permutation& perm) { return op_type(op_base_type(), perm); }
 
+      /// Construct the distributed evaluator for this expression
+
+      /// When one of the arguments is a contraction, the other argument is
+      /// added to the result tiles of the contraction as they are reduced,
+      /// if possible (see \c BinaryEngine::is_fusable_sum() ).
+      /// \return The distributed evaluator that will evaluate this expression
+      dist_eval_type make_dist_eval() const {
+        if(BinaryEngine_::is_fusable_sum())
+          return BinaryEngine_::make_fused_sum_dist_eval(ExprEngine_::shape(), nullptr);
+        return BinaryEngine_::make_dist_eval();
+      }
+
+      /// Check that additive terms can be fused with this expression
+
+      /// \return \c true if one of the arguments is a contraction that can be
+      /// fused with additive terms
+      bool is_fusable() const { return BinaryEngine_::is_fusable_sum(); }
+
+      /// Construct the distributed evaluator for this expression and fused additive terms
+
+      /// \param shape The shape of the result
+      /// \param epilogue The additive terms of the parent expressions
+      /// \return The distributed evaluator that will evaluate this expression
+      /// and add the terms to its tiles
+      dist_eval_type make_fused_dist_eval(const shape_type& shape,
+          const std::shared_ptr<TiledArray::detail::SummaEpilogue<value_type> >& epilogue) const
+      {
+        return BinaryEngine_::make_fused_sum_dist_eval(shape, epilogue);
+      }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -25,7 +25,10 @@
 #define WORLD_INSTANTIATE_STATIC_TEMPLATES
 #endif // WORLD_INSTANTIATE_STATIC_TEMPLATES
 
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 #pragma GCC diagnostic push
 #pragma GCC system_header
 #include <madness/world/MADworld.h>
@@ -121,6 +124,38 @@ namespace TiledArray {
         current_world, world_resetter);
   }
 
+  namespace detail {
+
+    /// Finalization callbacks
+
+    /// \return The functions that are called by \c TiledArray::finalize()
+    /// before the MADWorld runtime is finalized, e.g. to release the arrays
+    /// held by global caches while their World still exists.
+    inline std::vector<std::function<void()> >& finalize_callbacks() {
+      static std::vector<std::function<void()> > callbacks;
+      return callbacks;
+    }
+
+    /// Register a finalization callback
+
+    /// \param callback The function to be called by \c TiledArray::finalize()
+    inline void at_finalize(std::function<void()> callback) {
+      static std::mutex mutex;
+      std::lock_guard<std::mutex> lock(mutex);
+      finalize_callbacks().push_back(std::move(callback));
+    }
+
+    /// Call the finalization callbacks
+
+    /// This is called by \c TiledArray::finalize() before the runtime is
+    /// finalized.
+    inline void run_finalize_callbacks() {
+      for(const auto& callback : finalize_callbacks())
+        callback();
+    }
+
+  } // namespace detail
+
   /// @name TiledArray initialization.
   ///       These functions initialize TiledArray AND MADWorld runtime components.
   ///       @note the default World object is set to the object returned by these.
@@ -141,6 +176,7 @@ namespace TiledArray {
   }
 
   inline void finalize() {
+    detail::run_finalize_callbacks();
     madness::finalize();
     TiledArray::reset_default_world();
   }
@@ -0,0 +1,134 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  batched_gemm.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_BATCHED_GEMM_H__INCLUDED
+#define TILEDARRAY_MATH_BATCHED_GEMM_H__INCLUDED
+
+#include <TiledArray/math/parallel_gemm.h>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+  namespace math {
+
+    namespace detail {
+
+      /// Read the batched contraction threshold from the environment
+
+      /// The threshold may be set with the \c TA_BATCHED_CONTRACTION
+      /// environment variable; the default is \f$ 2^{15} \f$ (e.g. tiles
+      /// with extents of 32), and 0 disables batched contractions.
+      /// \return The batched contraction threshold
+      inline double init_batched_contraction_threshold() {
+        const char* threshold = getenv("TA_BATCHED_CONTRACTION");
+        if(threshold)
+          return std::max(std::stod(threshold), 0.0);
+        return 32768.0;
+      }
+
+    } // namespace detail
+
+    /// Batched contraction threshold accessor
+
+    /// The tile pairs of each result tile of a contraction are contracted in
+    /// batches (see \c batched_gemm ) when the average value of \c m*n*k of
+    /// the tile contractions is less than this threshold. The cost of
+    /// scheduling a task for each tile pair is then comparable to the cost of
+    /// the tile GEMM.
+    /// \return The batched contraction threshold, or 0 if batched
+    /// contractions are disabled
+    inline double batched_contraction_threshold() {
+      static const double threshold = detail::init_batched_contraction_threshold();
+      return threshold;
+    }
+
+    /// Sum of GEMMs with a common result matrix
+
+    /// Computes
+    /// \f$ C = \alpha \sum_p \mathrm{op}(A_p) \mathrm{op}(B_p) + C \f$ ,
+    /// where \f$ \mathrm{op}(A_p) \f$ is an \c m x \c k[p] matrix and
+    /// \f$ \mathrm{op}(B_p) \f$ is a \c k[p] x \c n matrix. The arguments are
+    /// packed side by side into an \c m x \c K and a \c K x \c n matrix, where
+    /// \c K is the sum of \c k , which are then multiplied with a single
+    /// GEMM. For small matrices this is much faster than a sequence of GEMMs.
+    /// The leading dimensions of the arguments are those of contiguous
+    /// matrices, i.e. \c k[p] or \c m for \c A_p and \c n or \c k[p] for
+    /// \c B_p .
+    /// \tparam S The type of \c alpha
+    /// \tparam T1 The element type of \c A_p
+    /// \tparam T2 The element type of \c B_p
+    /// \tparam T3 The element type of \c C
+    /// \param op_a The operation applied to the \c A_p matrices
+    /// \param op_b The operation applied to the \c B_p matrices
+    /// \param m The number of rows in \c C
+    /// \param n The number of columns in \c C
+    /// \param k The inner dimension size of each product
+    /// \param alpha The scaling factor applied to the sum of products
+    /// \param a The \c A_p matrices
+    /// \param b The \c B_p matrices
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <typename S, typename T1, typename T2, typename T3>
+    inline void batched_gemm(const madness::cblas::CBLAS_TRANSPOSE op_a,
+        const madness::cblas::CBLAS_TRANSPOSE op_b, const integer m,
+        const integer n, const std::vector<integer>& k, const S alpha,
+        const std::vector<const T1*>& a, const std::vector<const T2*>& b,
+        T3* const c, const integer ldc)
+    {
+      TA_ASSERT(k.size() == a.size());
+      TA_ASSERT(k.size() == b.size());
+
+      integer k_total = 0;
+      for(const integer k_p : k)
+        k_total += k_p;
+      if(k_total == 0)
+        return;
+
+      // Pack [ op(A_0) op(A_1) ... ] and [ op(B_0) ; op(B_1) ; ... ]
+      std::vector<T1, Eigen::aligned_allocator<T1> > a_pack(m * k_total);
+      std::vector<T2, Eigen::aligned_allocator<T2> > b_pack(k_total * n);
+      integer offset = 0;
+      for(std::size_t p = 0ul; p < k.size(); ++p) {
+        pack_block(op_a, m, k[p], a[p],
+            (op_a == madness::cblas::NoTrans ? k[p] : m),
+            a_pack.data() + offset, k_total);
+        pack_block(op_b, k[p], n, b[p],
+            (op_b == madness::cblas::NoTrans ? n : k[p]),
+            b_pack.data() + offset * n);
+        offset += k[p];
+      }
+
+      if(use_parallel_gemm(m, n, k_total))
+        math::parallel_gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, m, n,
+            k_total, alpha, a_pack.data(), k_total, b_pack.data(), n, T3(1),
+            c, ldc);
+      else
+        math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, m, n, k_total,
+            alpha, a_pack.data(), k_total, b_pack.data(), n, T3(1), c, ldc);
+    }
+
+  }  // namespace math
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_BATCHED_GEMM_H__INCLUDED
@@ -27,143 +27,254 @@
 #define TILEDARRAY_PARALLEL_GEMM_H__INCLUDED
 
 #include <TiledArray/madness.h>
-#include <TiledArray/vector_op.h>
-#include <TiledArray/blas.h>
-
-#define TILEDARRAY_DYNAMIC_BLOCK_SIZE std::numeric_limits<std::size_t>::max();
+#include <TiledArray/math/vector_op.h>
+#include <TiledArray/math/blas.h>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_INTEL_TBB
+#include <tbb/blocked_range2d.h>
+#include <tbb/parallel_for.h>
+#endif // HAVE_INTEL_TBB
 
 namespace TiledArray {
   namespace math {
 
-//#ifdef HAVE_INTEL_TBB
-
-
-    template <typename T, integer Size>
-    class MatrixBlockTask : public tbb::task {
-
-      const integer rows_;
-      const integer cols_;
-      T* data_;
-      const integer ld_;
-      std::shared_ptr<T> result_;
-
-      /// Copy a \c Size^2 block from \c data to \c result
-
-      /// \param[out] result A pointer to the first element of the result block
-      /// \param[in] data A pointer to the first element of the block to be copied
-      /// \param[in] ld The leading dimension stride for the \c data block
-      void copy_block(T* result, const T* data, const integer ld) {
-        const T* const block_end = result + (TILEDARRAY_LOOP_UNWIND * Size);
-        for(; result < block_end; result += Size, data += ld)
-          TiledArray::math::copy_block(result, data);
+    /// Block sizes used by the blocked GEMM
+
+    /// The result matrix is partitioned into \c m_block x \c n_block blocks,
+    /// each of which is computed by one task. The inner dimension is swept in
+    /// chunks of \c k_block so that the packed panels of the arguments fit in
+    /// the L2 cache.
+    struct GemmBlockSize {
+      static constexpr integer m_block = 128;
+      static constexpr integer n_block = 512;
+      static constexpr integer k_block = 256;
+    }; // struct GemmBlockSize
+
+    namespace detail {
+
+      /// Read the parallel GEMM threshold from the environment
+
+      /// The threshold is the minimum value of \c m*n*k for which
+      /// \c parallel_gemm is used. It may be set with the
+      /// \c TA_PARALLEL_GEMM_THRESHOLD environment variable; the default is
+      /// \f$ 2^{24} \f$ (e.g. \c m=n=k=256 ).
+      /// \return The parallel GEMM threshold
+      inline double init_parallel_gemm_threshold() {
+        const char* threshold = getenv("TA_PARALLEL_GEMM_THRESHOLD");
+        if(threshold)
+          return std::stod(threshold);
+        return 16777216.0;
       }
 
-      /// Copy a rectangular \c m*n block from \c data to \c result
-
-      /// \param[in] m The number of rows to copy
-      /// \param[in] n The number of columns to copy
-      /// \param[out] result A pointer to the first element of the result block
-      /// \param[in] data A pointer to the first element of the block to be copied
-      /// \param[in] ld The leading dimension stride for the \c data block
-      void copy_block(const integer m, const integer n, T* result,
-          const T* data, const integer ld)
-      {
-        const T* const block_end = result + (m * Size);
-        for(; result < block_end; result += Size, data += ld)
-          TiledArray::math::copy_block(n, result, data);
+    } // namespace detail
+
+    /// Parallel GEMM threshold accessor
+
+    /// \return The minimum value of \c m*n*k for which \c parallel_gemm is
+    /// used by \c Tensor::gemm
+    inline double parallel_gemm_threshold() {
+      static const double threshold = detail::init_parallel_gemm_threshold();
+      return threshold;
+    }
+
+    /// Check if a *GEMM operation is large enough to be split into tasks
+
+    /// \param m The number of rows in the result matrix
+    /// \param n The number of columns in the result matrix
+    /// \param k The size of the inner dimension
+    /// \return \c true if \c parallel_gemm should be used, otherwise \c false
+    inline bool use_parallel_gemm(const integer m, const integer n, const integer k) {
+#ifdef HAVE_INTEL_TBB
+      return ((m > GemmBlockSize::m_block) || (n > GemmBlockSize::n_block)) &&
+          ((double(m) * double(n) * double(k)) >= parallel_gemm_threshold());
+#else
+      return false;
+#endif // HAVE_INTEL_TBB
+    }
+
+    /// Copy a block of a row-major matrix into a contiguous buffer
+
+    /// The result is the \c rows x \c cols block of
+    /// \f$ \mathrm{op}(A) \f$ stored in row-major order with a leading
+    /// dimension of \c result_ld (\c cols by default), so that it can be
+    /// used as a \c NoTrans argument.
+    /// \tparam T The matrix element type
+    /// \param op The transpose operation applied to \c data
+    /// \param rows The number of rows in the packed block
+    /// \param cols The number of columns in the packed block
+    /// \param data A pointer to the first element of the block in the
+    /// original matrix
+    /// \param ld The leading dimension of the original matrix
+    /// \param[out] result A pointer to the packed block buffer
+    /// \param result_ld The leading dimension of the packed block, or 0 for
+    /// \c cols (default = 0)
+    template <typename T>
+    inline void pack_block(const madness::cblas::CBLAS_TRANSPOSE op,
+        const integer rows, const integer cols, const T* const data,
+        const integer ld, T* const result, const integer result_ld = 0)
+    {
+      typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+          matrix_type;
+      typedef Eigen::Map<const matrix_type, Eigen::Unaligned, Eigen::OuterStride<> >
+          const_map_type;
+
+      Eigen::Map<matrix_type, Eigen::Unaligned, Eigen::OuterStride<> > packed(
+          result, rows, cols, Eigen::OuterStride<>(result_ld ? result_ld : cols));
+      switch(op) {
+        case madness::cblas::NoTrans:
+          packed = const_map_type(data, rows, cols, Eigen::OuterStride<>(ld));
+          break;
+        case madness::cblas::Trans:
+          packed = const_map_type(data, cols, rows, Eigen::OuterStride<>(ld)).transpose();
+          break;
+        default:
+          packed = const_map_type(data, cols, rows, Eigen::OuterStride<>(ld)).adjoint();
+          break;
       }
+    }
+
+    /// Blocked, packed GEMM kernel
+
+    /// This object computes one \c GemmBlockSize::m_block x
+    /// \c GemmBlockSize::n_block block of
+    /// \f$ C = \alpha \mathrm{op}(A) \mathrm{op}(B) + \beta C \f$. For each
+    /// chunk of the inner dimension, the corresponding panels of \c A and
+    /// \c B are packed into contiguous, non-transposed buffers and passed to
+    /// the serial \c gemm. Blocks of \c C are independent, so they may be
+    /// evaluated concurrently.
+    /// \tparam S1 The type of \c alpha
+    /// \tparam T1 The element type of \c A
+    /// \tparam T2 The element type of \c B
+    /// \tparam S2 The type of \c beta
+    /// \tparam T3 The element type of \c C
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    class GemmBlockTask {
+      const madness::cblas::CBLAS_TRANSPOSE op_a_; ///< Operation applied to A
+      const madness::cblas::CBLAS_TRANSPOSE op_b_; ///< Operation applied to B
+      const integer m_; ///< Number of rows in C
+      const integer n_; ///< Number of columns in C
+      const integer k_; ///< Inner dimension size
+      const S1 alpha_; ///< Scaling factor for A*B
+      const T1* const a_; ///< A matrix
+      const integer lda_; ///< Leading dimension of A
+      const T2* const b_; ///< B matrix
+      const integer ldb_; ///< Leading dimension of B
+      const S2 beta_; ///< Scaling factor for C
+      T3* const c_; ///< C matrix
+      const integer ldc_; ///< Leading dimension of C
 
     public:
-      MatrixBlockTask(const integer rows, const integer cols,
-          const T* const data, const integer ld) :
-        rows_(rows), cols_(cols), data_(data), ld_(ld)
-      { }
-
-      /// Task body
-      virtual tbb::task* execut() {
 
-        // Compute block iteration limit
-        constexpr integer index_mask = ~integer(TILEDARRAY_LOOP_UNWIND - 1ul);
-        const integer mx = rows_ & index_mask; // = rows - rows % TILEDARRAY_LOOP_UNWIND
-        const integer nx = cols_ & index_mask; // = cols - cols % TILEDARRAY_LOOP_UNWIND
-        const integer m_tail = rows_ - mx;
-        const integer n_tail = cols_ - nx;
-
-        // Copy data into block_
-        integer i = 0ul;
-        T* result_i = result_.get();
-        const T* data_i = data_;
-        for(; i < mx; i += TILEDARRAY_LOOP_UNWIND, result_i += Size, data_i += ld_) {
-
-          integer j = 0ul;
-          for(; j < nx; j += TILEDARRAY_LOOP_UNWIND)
-            copy_block(result_i + j, data_i + j);
-
-          if(n_tail)
-            copy_block(TILEDARRAY_LOOP_UNWIND, n_tail, result_i + j, data_i + j);
-        }
-
-        if(m_tail) {
+      GemmBlockTask(const madness::cblas::CBLAS_TRANSPOSE op_a,
+          const madness::cblas::CBLAS_TRANSPOSE op_b, const integer m,
+          const integer n, const integer k, const S1 alpha, const T1* const a,
+          const integer lda, const T2* const b, const integer ldb,
+          const S2 beta, T3* const c, const integer ldc) :
+        op_a_(op_a), op_b_(op_b), m_(m), n_(n), k_(k), alpha_(alpha), a_(a),
+        lda_(lda), b_(b), ldb_(ldb), beta_(beta), c_(c), ldc_(ldc)
+      { }
 
-          integer j = 0ul;
-          for(; j < nx; j += TILEDARRAY_LOOP_UNWIND)
-            copy_block(m_tail, TILEDARRAY_LOOP_UNWIND, result_i + j, data_i + j);
+      /// The number of block rows in C
+      integer row_blocks() const {
+        return (m_ + GemmBlockSize::m_block - 1) / GemmBlockSize::m_block;
+      }
 
-          if(n_tail)
-            copy_block(m_tail, n_tail, result_i + j, data_i + j);
+      /// The number of block columns in C
+      integer col_blocks() const {
+        return (n_ + GemmBlockSize::n_block - 1) / GemmBlockSize::n_block;
+      }
 
+      /// Evaluate a block of C
+
+      /// \param bi The block row index of C
+      /// \param bj The block column index of C
+      void operator()(const integer bi, const integer bj) const {
+        const integer i0 = bi * GemmBlockSize::m_block;
+        const integer j0 = bj * GemmBlockSize::n_block;
+        const integer mb = std::min(integer(GemmBlockSize::m_block), m_ - i0);
+        const integer nb = std::min(integer(GemmBlockSize::n_block), n_ - j0);
+        const integer kc = std::min(integer(GemmBlockSize::k_block), k_);
+
+        std::vector<T1, Eigen::aligned_allocator<T1> > a_pack(mb * kc);
+        std::vector<T2, Eigen::aligned_allocator<T2> > b_pack(kc * nb);
+        T3* const c_block = c_ + i0 * ldc_ + j0;
+
+        for(integer p0 = 0; p0 < k_; p0 += GemmBlockSize::k_block) {
+          const integer kb = std::min(integer(GemmBlockSize::k_block), k_ - p0);
+
+          // Pack op(A)[i0:i0+mb, p0:p0+kb] and op(B)[p0:p0+kb, j0:j0+nb]
+          pack_block(op_a_, mb, kb, (op_a_ == madness::cblas::NoTrans ?
+              a_ + i0 * lda_ + p0 : a_ + p0 * lda_ + i0), lda_, a_pack.data());
+          pack_block(op_b_, kb, nb, (op_b_ == madness::cblas::NoTrans ?
+              b_ + p0 * ldb_ + j0 : b_ + j0 * ldb_ + p0), ldb_, b_pack.data());
+
+          // Only the first inner block is scaled by beta, the remaining blocks
+          // accumulate into C.
+          math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, mb, nb, kb,
+              alpha_, a_pack.data(), kb, b_pack.data(), nb,
+              (p0 == 0 ? beta_ : S2(1)), c_block, ldc_);
         }
-
-        return nullptr;
       }
 
-      std::shared_ptr<T> result() {
-        constexpr integer size = Size * Size;
-        constexpr integer bytes = size * sizeof(T);
-
-        T* result_ptr = nullptr;
-        if(! posix_memalign(result_ptr, TILEARRAY_ALIGNMENT, bytes))
-          throw std::bad_alloc();
-
-        result_.reset(result_ptr);
+#ifdef HAVE_INTEL_TBB
+      /// TBB parallel_for body
 
-        return result_;
+      /// \param range The range of C blocks to evaluate
+      void operator()(const tbb::blocked_range2d<integer>& range) const {
+        for(integer bi = range.rows().begin(); bi != range.rows().end(); ++bi)
+          for(integer bj = range.cols().begin(); bj != range.cols().end(); ++bj)
+            operator()(bi, bj);
       }
-
-    }; // class MatrixBlockTask
-
-
-    template <integer Size, typename C, typename A = C, typename B = C, typename Alpha = C, typename Beta = C>
-    class GemmTask : public tbb::task {
-      const madness::cblas::CBLAS_TRANSPOSE op_a_, op_b_;
-      const integer m_, n_, k_;
-      const Alpha alpha_;
-      std::shared_ptr<A> a_;
-      constexpr integer lda_ = Size;
-      std::shared_ptr<B> b_;
-      const Beta beta_;
-      std::shared_ptr<C> c_;
-      const integer ldc_;
-
-    public:
-
-
-      GemmTask(madness::cblas::CBLAS_TRANSPOSE op_a,
-          madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
-          const integer k, const Alpha alpha, const std::shared_ptr<A>& a,
-          const std::shared_ptr<B>& b, const Beta beta,
-          const std::shared_ptr<C>& c, const integer ldc) :
-            op_a_(op_a), op_b_(op_b), m_(m), n_(n), k_(k), alpha_(alpha), a_(a),
-            b_(b), beta_(beta), c_(c), ldc_(c)
-      { }
-
-      virtual tbb::task execute() {
-        gemm(op_a_, op_b_, m_, n_, k_, alpha_, a_.get(), Size, b_.get(), Size, c_, ldc_);
+#endif // HAVE_INTEL_TBB
+
+    }; // class GemmBlockTask
+
+    /// Task-parallel, cache-blocked GEMM
+
+    /// Computes \f$ C = \alpha \mathrm{op}(A) \mathrm{op}(B) + \beta C \f$ for
+    /// row-major matrices, with the same arguments as \c gemm. The result
+    /// matrix is divided into blocks that are evaluated as independent TBB
+    /// tasks, which share the thread pool with the MADNESS task queue. When
+    /// TBB is not available, or the matrices are too small to split, this
+    /// is equivalent to \c gemm.
+    /// \param op_a The operation applied to \c a
+    /// \param op_b The operation applied to \c b
+    /// \param m The number of rows in \c c
+    /// \param n The number of columns in \c c
+    /// \param k The size of the inner dimension
+    /// \param alpha The scaling factor applied to \f$ \mathrm{op}(A) \mathrm{op}(B) \f$
+    /// \param a The left-hand matrix
+    /// \param lda The leading dimension of \c a
+    /// \param b The right-hand matrix
+    /// \param ldb The leading dimension of \c b
+    /// \param beta The scaling factor applied to \c c
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline void parallel_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const S1 alpha, const T1* a, const integer lda,
+        const T2* b, const integer ldb, const S2 beta, T3* c, const integer ldc)
+    {
+#ifdef HAVE_INTEL_TBB
+      GemmBlockTask<S1, T1, T2, S2, T3> task(op_a, op_b, m, n, k, alpha, a,
+          lda, b, ldb, beta, c, ldc);
+      const integer row_blocks = task.row_blocks();
+      const integer col_blocks = task.col_blocks();
+
+      if((k > 0) && (row_blocks * col_blocks > 1)) {
+        tbb::parallel_for(tbb::blocked_range2d<integer>(0, row_blocks, 1,
+            0, col_blocks, 1), task, tbb::simple_partitioner());
+        return;
       }
+#endif // HAVE_INTEL_TBB
 
-    }; // class GemmTask
-
-//#endif // HAVE_INTEL_TBB
+      math::gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    }
 
   }  // namespace math
 } // namespace TiledArray
@@ -0,0 +1,456 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  simd_transpose.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_SIMD_TRANSPOSE_H__INCLUDED
+#define TILEDARRAY_MATH_SIMD_TRANSPOSE_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TILEDARRAY_HAS_X86_TRANSPOSE_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace TiledArray {
+  namespace math {
+
+    /// Instruction sets of the transpose micro-kernels
+    typedef enum {
+      transpose_scalar = 0, ///< Portable scalar loops
+      transpose_avx2 = 1, ///< AVX2 (256-bit) kernels
+      transpose_avx512 = 2 ///< AVX-512F (512-bit) kernels
+    } TransposeISA;
+
+    namespace detail {
+
+      /// Select the transpose instruction set
+
+      /// The best instruction set supported by the processor is used, unless
+      /// the \c TA_TRANSPOSE_ISA environment variable is set to \c scalar,
+      /// \c avx2, or \c avx512, which limits the instruction set.
+      /// \return The instruction set of the transpose kernels
+      inline TransposeISA init_transpose_isa() {
+        TransposeISA isa = transpose_scalar;
+#ifdef TILEDARRAY_HAS_X86_TRANSPOSE_KERNELS
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f"))
+          isa = transpose_avx512;
+        else if(__builtin_cpu_supports("avx2"))
+          isa = transpose_avx2;
+#endif // TILEDARRAY_HAS_X86_TRANSPOSE_KERNELS
+
+        const char* limit = getenv("TA_TRANSPOSE_ISA");
+        if(limit) {
+          const std::string name(limit);
+          if(name == "scalar")
+            isa = transpose_scalar;
+          else if((name == "avx2") && (isa > transpose_avx2))
+            isa = transpose_avx2;
+        }
+
+        return isa;
+      }
+
+#ifdef TILEDARRAY_HAS_X86_TRANSPOSE_KERNELS
+
+      // Transpose micro-kernels. Each kernel transposes a square block of
+      // elements of the given size (in bytes) from the row-major block
+      // arg, with a row stride of arg_stride, into result, with a row stride
+      // of result_stride. The strides are given in elements.
+
+      /// 4x4 block of 8-byte elements (AVX)
+      __attribute__((target("avx2")))
+      inline void transpose_kernel_8x4_avx2(const double* const arg,
+          const std::size_t arg_stride, double* const result,
+          const std::size_t result_stride)
+      {
+        const __m256d r0 = _mm256_loadu_pd(arg);
+        const __m256d r1 = _mm256_loadu_pd(arg + arg_stride);
+        const __m256d r2 = _mm256_loadu_pd(arg + 2 * arg_stride);
+        const __m256d r3 = _mm256_loadu_pd(arg + 3 * arg_stride);
+
+        const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+        const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+        const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+        const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+        _mm256_storeu_pd(result, _mm256_permute2f128_pd(t0, t2, 0x20));
+        _mm256_storeu_pd(result + result_stride, _mm256_permute2f128_pd(t1, t3, 0x20));
+        _mm256_storeu_pd(result + 2 * result_stride, _mm256_permute2f128_pd(t0, t2, 0x31));
+        _mm256_storeu_pd(result + 3 * result_stride, _mm256_permute2f128_pd(t1, t3, 0x31));
+      }
+
+      /// 8x8 block of 4-byte elements (AVX)
+      __attribute__((target("avx2")))
+      inline void transpose_kernel_4x8_avx2(const float* const arg,
+          const std::size_t arg_stride, float* const result,
+          const std::size_t result_stride)
+      {
+        __m256 r[8], t[8];
+        for(int i = 0; i < 8; ++i)
+          r[i] = _mm256_loadu_ps(arg + i * arg_stride);
+
+        for(int i = 0; i < 8; i += 2) {
+          t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+          t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        }
+
+        for(int i = 0; i < 8; i += 4) {
+          r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+          r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+          r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+          r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        for(int i = 0; i < 4; ++i) {
+          _mm256_storeu_ps(result + i * result_stride,
+              _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+          _mm256_storeu_ps(result + (i + 4) * result_stride,
+              _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+        }
+      }
+
+      /// 2x2 block of 16-byte elements (AVX)
+      __attribute__((target("avx2")))
+      inline void transpose_kernel_16x2_avx2(const double* const arg,
+          const std::size_t arg_stride, double* const result,
+          const std::size_t result_stride)
+      {
+        // Strides are in 16-byte elements
+        const __m256d r0 = _mm256_loadu_pd(arg);
+        const __m256d r1 = _mm256_loadu_pd(arg + 2 * arg_stride);
+
+        _mm256_storeu_pd(result, _mm256_permute2f128_pd(r0, r1, 0x20));
+        _mm256_storeu_pd(result + 2 * result_stride, _mm256_permute2f128_pd(r0, r1, 0x31));
+      }
+
+      // The AVX-512 intrinsics of some GCC versions trigger false
+      // uninitialized variable warnings
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+
+      /// 8x8 block of 8-byte elements (AVX-512F)
+      __attribute__((target("avx512f")))
+      inline void transpose_kernel_8x8_avx512(const double* const arg,
+          const std::size_t arg_stride, double* const result,
+          const std::size_t result_stride)
+      {
+        __m512d r[8], t[8];
+        for(int i = 0; i < 8; ++i)
+          r[i] = _mm512_loadu_pd(arg + i * arg_stride);
+
+        // Interleave pairs of rows
+        for(int i = 0; i < 8; i += 2) {
+          t[i] = _mm512_unpacklo_pd(r[i], r[i + 1]);
+          t[i + 1] = _mm512_unpackhi_pd(r[i], r[i + 1]);
+        }
+
+        // Gather the 128-bit lanes of four rows
+        for(int i = 0; i < 8; i += 4) {
+          r[i] = _mm512_shuffle_f64x2(t[i], t[i + 2], 0x88);
+          r[i + 1] = _mm512_shuffle_f64x2(t[i], t[i + 2], 0xdd);
+          r[i + 2] = _mm512_shuffle_f64x2(t[i + 1], t[i + 3], 0x88);
+          r[i + 3] = _mm512_shuffle_f64x2(t[i + 1], t[i + 3], 0xdd);
+        }
+
+        // Gather the 128-bit lanes of all eight rows
+        _mm512_storeu_pd(result, _mm512_shuffle_f64x2(r[0], r[4], 0x88));
+        _mm512_storeu_pd(result + 4 * result_stride, _mm512_shuffle_f64x2(r[0], r[4], 0xdd));
+        _mm512_storeu_pd(result + 2 * result_stride, _mm512_shuffle_f64x2(r[1], r[5], 0x88));
+        _mm512_storeu_pd(result + 6 * result_stride, _mm512_shuffle_f64x2(r[1], r[5], 0xdd));
+        _mm512_storeu_pd(result + result_stride, _mm512_shuffle_f64x2(r[2], r[6], 0x88));
+        _mm512_storeu_pd(result + 5 * result_stride, _mm512_shuffle_f64x2(r[2], r[6], 0xdd));
+        _mm512_storeu_pd(result + 3 * result_stride, _mm512_shuffle_f64x2(r[3], r[7], 0x88));
+        _mm512_storeu_pd(result + 7 * result_stride, _mm512_shuffle_f64x2(r[3], r[7], 0xdd));
+      }
+
+      /// 4x4 block of 16-byte elements (AVX-512F)
+      __attribute__((target("avx512f")))
+      inline void transpose_kernel_16x4_avx512(const double* const arg,
+          const std::size_t arg_stride, double* const result,
+          const std::size_t result_stride)
+      {
+        // Strides are in 16-byte elements
+        const __m512d r0 = _mm512_loadu_pd(arg);
+        const __m512d r1 = _mm512_loadu_pd(arg + 2 * arg_stride);
+        const __m512d r2 = _mm512_loadu_pd(arg + 4 * arg_stride);
+        const __m512d r3 = _mm512_loadu_pd(arg + 6 * arg_stride);
+
+        const __m512d t0 = _mm512_shuffle_f64x2(r0, r1, 0x44);
+        const __m512d t1 = _mm512_shuffle_f64x2(r0, r1, 0xee);
+        const __m512d t2 = _mm512_shuffle_f64x2(r2, r3, 0x44);
+        const __m512d t3 = _mm512_shuffle_f64x2(r2, r3, 0xee);
+
+        _mm512_storeu_pd(result, _mm512_shuffle_f64x2(t0, t2, 0x88));
+        _mm512_storeu_pd(result + 2 * result_stride, _mm512_shuffle_f64x2(t0, t2, 0xdd));
+        _mm512_storeu_pd(result + 4 * result_stride, _mm512_shuffle_f64x2(t1, t3, 0x88));
+        _mm512_storeu_pd(result + 6 * result_stride, _mm512_shuffle_f64x2(t1, t3, 0xdd));
+      }
+
+#pragma GCC diagnostic pop
+
+#endif // TILEDARRAY_HAS_X86_TRANSPOSE_KERNELS
+
+      /// Transpose micro-kernel selection
+
+      /// \tparam Size The element size in bytes
+      template <std::size_t Size>
+      struct TransposeKernel {
+        typedef void (*kernel_type)(const void*, std::size_t, void*, std::size_t);
+
+        /// The kernel for an instruction set
+
+        /// \param[in] isa The instruction set
+        /// \param[out] block The size of the blocks that are transposed by the
+        /// kernel
+        /// \return The kernel, or \c nullptr if there is no kernel for \c isa
+        static kernel_type kernel(const TransposeISA isa, std::size_t& block) {
+          block = 1ul;
+#ifdef TILEDARRAY_HAS_X86_TRANSPOSE_KERNELS
+          switch(Size) {
+            case 4ul:
+              if(isa >= transpose_avx2) {
+                block = 8ul;
+                return [] (const void* arg, std::size_t arg_stride, void* result,
+                    std::size_t result_stride)
+                { transpose_kernel_4x8_avx2(static_cast<const float*>(arg),
+                    arg_stride, static_cast<float*>(result), result_stride); };
+              }
+              break;
+            case 8ul:
+              if(isa >= transpose_avx512) {
+                block = 8ul;
+                return [] (const void* arg, std::size_t arg_stride, void* result,
+                    std::size_t result_stride)
+                { transpose_kernel_8x8_avx512(static_cast<const double*>(arg),
+                    arg_stride, static_cast<double*>(result), result_stride); };
+              }
+              if(isa >= transpose_avx2) {
+                block = 4ul;
+                return [] (const void* arg, std::size_t arg_stride, void* result,
+                    std::size_t result_stride)
+                { transpose_kernel_8x4_avx2(static_cast<const double*>(arg),
+                    arg_stride, static_cast<double*>(result), result_stride); };
+              }
+              break;
+            case 16ul:
+              if(isa >= transpose_avx512) {
+                block = 4ul;
+                return [] (const void* arg, std::size_t arg_stride, void* result,
+                    std::size_t result_stride)
+                { transpose_kernel_16x4_avx512(static_cast<const double*>(arg),
+                    arg_stride, static_cast<double*>(result), result_stride); };
+              }
+              if(isa >= transpose_avx2) {
+                block = 2ul;
+                return [] (const void* arg, std::size_t arg_stride, void* result,
+                    std::size_t result_stride)
+                { transpose_kernel_16x2_avx2(static_cast<const double*>(arg),
+                    arg_stride, static_cast<double*>(result), result_stride); };
+              }
+              break;
+          }
+#endif // TILEDARRAY_HAS_X86_TRANSPOSE_KERNELS
+          return nullptr;
+        }
+
+      }; // struct TransposeKernel
+
+      /// Transpose with the micro-kernel of an instruction set
+
+      /// \tparam T The element type
+      template <typename T>
+      class TransposeCopy {
+        typedef typename TransposeKernel<sizeof(T)>::kernel_type kernel_type;
+
+        kernel_type kernel_; ///< The micro-kernel (may be null)
+        std::size_t block_; ///< The micro-kernel block size
+
+        /// The maximum size of a block of the argument that is transposed
+        /// without further partitioning, so that the argument and result
+        /// blocks stay in the L1 cache
+        static constexpr std::size_t tile_bytes = 8192ul;
+
+        /// Transpose a block element by element
+        static void transpose_elements(const std::size_t m, const std::size_t n,
+            const std::size_t result_stride, T* MADNESS_RESTRICT const result,
+            const std::size_t arg_stride, const T* MADNESS_RESTRICT const arg)
+        {
+          for(std::size_t i = 0ul; i < m; ++i) {
+            const T* MADNESS_RESTRICT const arg_i = arg + i * arg_stride;
+            for(std::size_t j = 0ul; j < n; ++j)
+              result[j * result_stride + i] = arg_i[j];
+          }
+        }
+
+        /// The number of elements before the first aligned element
+
+        /// \param p A pointer to an element
+        /// \return The number of elements that precede the first element at or
+        /// after \c p that is aligned to the micro-kernel vector size, or 0 if
+        /// \c p is not aligned to the element size
+        std::size_t unaligned(const void* const p) const {
+          const std::size_t alignment = block_ * sizeof(T);
+          const std::size_t offset = reinterpret_cast<std::uintptr_t>(p) % alignment;
+          if((offset == 0ul) || (offset % sizeof(T) != 0ul))
+            return 0ul;
+          return (alignment - offset) / sizeof(T);
+        }
+
+        /// Transpose an L1 tile with the micro-kernel
+        void transpose_tile(const std::size_t m, const std::size_t n,
+            const std::size_t result_stride, T* MADNESS_RESTRICT const result,
+            const std::size_t arg_stride, const T* MADNESS_RESTRICT const arg) const
+        {
+          const std::size_t mx = (kernel_ ? m - (m % block_) : 0ul);
+          const std::size_t nx = (kernel_ ? n - (n % block_) : 0ul);
+
+          // Full micro-kernel blocks, in the order of the result rows
+          for(std::size_t j = 0ul; j < nx; j += block_)
+            for(std::size_t i = 0ul; i < mx; i += block_)
+              kernel_(arg + i * arg_stride + j, arg_stride,
+                  result + j * result_stride + i, result_stride);
+
+          // Right-hand and bottom edges
+          transpose_elements(mx, n - nx, result_stride, result + nx * result_stride,
+              arg_stride, arg + nx);
+          transpose_elements(m - mx, n, result_stride, result + mx, arg_stride,
+              arg + mx * arg_stride);
+        }
+
+        /// Cache-oblivious transpose of aligned blocks
+        void transpose_blocks(const std::size_t m, const std::size_t n,
+            const std::size_t result_stride, T* const result,
+            const std::size_t arg_stride, const T* const arg) const
+        {
+          if((m * n * sizeof(T) <= tile_bytes) || ((m <= block_) && (n <= block_))) {
+            transpose_tile(m, n, result_stride, result, arg_stride, arg);
+          } else if(m >= n) {
+            const std::size_t m1 = std::max(((m >> 1) / block_) * block_, block_);
+            transpose_blocks(m1, n, result_stride, result, arg_stride, arg);
+            transpose_blocks(m - m1, n, result_stride, result + m1, arg_stride,
+                arg + m1 * arg_stride);
+          } else {
+            const std::size_t n1 = std::max(((n >> 1) / block_) * block_, block_);
+            transpose_blocks(m, n1, result_stride, result, arg_stride, arg);
+            transpose_blocks(m, n - n1, result_stride, result + n1 * result_stride,
+                arg_stride, arg + n1);
+          }
+        }
+
+      public:
+
+        /// Constructor
+
+        /// \param isa The instruction set of the micro-kernels
+        explicit TransposeCopy(const TransposeISA isa) :
+          kernel_(TransposeKernel<sizeof(T)>::kernel(isa, block_))
+        { }
+
+        /// Cache-oblivious transpose
+
+        /// The leading rows and columns of the argument are transposed element
+        /// by element, so that the loads and stores of the micro-kernel do
+        /// not straddle cache lines when the strides are multiples of the
+        /// vector size. The rest of the matrix is split recursively along its
+        /// largest dimension until the blocks fit in the L1 cache, which are
+        /// then transposed with the micro-kernel. The splits are aligned with
+        /// the micro-kernel blocks.
+        /// \param m The number of rows in the argument matrix
+        /// \param n The number of columns in the argument matrix
+        /// \param result_stride The stride between result rows
+        /// \param result A pointer to the first element of the result matrix
+        /// \param arg_stride The stride between argument rows
+        /// \param arg A pointer to the first element of the argument matrix
+        void operator()(const std::size_t m, const std::size_t n,
+            const std::size_t result_stride, T* const result,
+            const std::size_t arg_stride, const T* const arg) const
+        {
+          const std::size_t i0 = (kernel_ ? std::min(unaligned(result), m) : 0ul);
+          const std::size_t j0 = (kernel_ ? std::min(unaligned(arg), n) : 0ul);
+
+          transpose_elements(i0, n, result_stride, result, arg_stride, arg);
+          transpose_elements(m - i0, j0, result_stride, result + i0, arg_stride,
+              arg + i0 * arg_stride);
+          transpose_blocks(m - i0, n - j0, result_stride,
+              result + j0 * result_stride + i0, arg_stride,
+              arg + i0 * arg_stride + j0);
+        }
+
+      }; // class TransposeCopy
+
+    } // namespace detail
+
+    /// Transpose instruction set accessor
+
+    /// \return The instruction set used by \c transpose_copy
+    inline TransposeISA transpose_isa() {
+      static const TransposeISA isa = detail::init_transpose_isa();
+      return isa;
+    }
+
+    /// Check for a vectorized transpose of a type
+
+    /// \c value is \c true if \c transpose_copy may be used to copy \c T ,
+    /// i.e. \c T is trivially copyable and has the size of a \c float ,
+    /// \c double , or \c std::complex<double> .
+    /// \tparam T The element type
+    template <typename T>
+    struct is_transpose_copyable :
+        public std::integral_constant<bool, std::is_trivially_copyable<T>::value
+            && ((sizeof(T) == 4ul) || (sizeof(T) == 8ul) || (sizeof(T) == 16ul))>
+    { };
+
+    /// Matrix transpose copy
+
+    /// Copies the transpose of the row-major \c m x \c n matrix \c arg into
+    /// \c result (i.e. <tt>result[j * result_stride + i] = arg[i * arg_stride + j]</tt>).
+    /// Unlike \c transpose , no element operations are applied, so blocks of
+    /// the matrix are transposed in registers with the AVX2 or AVX-512
+    /// micro-kernel that is selected at runtime (see \c transpose_isa ).
+    /// \tparam T The element type
+    /// \param m The number of rows in the argument matrix
+    /// \param n The number of columns in the argument matrix
+    /// \param result_stride The stride between result rows
+    /// \param result A pointer to the first element of the result matrix
+    /// \param arg_stride The stride between argument rows
+    /// \param arg A pointer to the first element of the argument matrix
+    template <typename T>
+    inline void transpose_copy(const std::size_t m, const std::size_t n,
+        const std::size_t result_stride, T* const result,
+        const std::size_t arg_stride, const T* const arg)
+    {
+      static_assert(is_transpose_copyable<T>::value,
+          "transpose_copy requires a trivially copyable 4-, 8-, or 16-byte type");
+      static const detail::TransposeCopy<T> op(transpose_isa());
+      op(m, n, result_stride, result, arg_stride, arg);
+    }
+
+  }  // namespace math
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_SIMD_TRANSPOSE_H__INCLUDED
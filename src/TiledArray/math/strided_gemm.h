@@ -0,0 +1,305 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  strided_gemm.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_STRIDED_GEMM_H__INCLUDED
+#define TILEDARRAY_MATH_STRIDED_GEMM_H__INCLUDED
+
+#include <TiledArray/math/parallel_gemm.h>
+#include <TiledArray/permutation.h>
+#include <TiledArray/range.h>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+  namespace math {
+
+    namespace detail {
+
+      /// Read the strided contraction threshold from the environment
+
+      /// The threshold may be set with the \c TA_STRIDED_CONTRACTION
+      /// environment variable; the default is 32, and 0 disables strided
+      /// contractions.
+      /// \return The strided contraction threshold
+      inline double init_strided_contraction_threshold() {
+        const char* threshold = getenv("TA_STRIDED_CONTRACTION");
+        if(threshold)
+          return std::max(std::stod(threshold), 0.0);
+        return 32.0;
+      }
+
+    } // namespace detail
+
+    /// Strided contraction threshold accessor
+
+    /// An argument of a contraction that must be permuted is contracted with
+    /// \c strided_gemm, instead of being permuted, when the average tile size
+    /// of the outer dimensions of the other argument is at least this
+    /// threshold. Each packed element of the argument is then used in at
+    /// least this many multiply-adds, so the packing is cheap compared to the
+    /// GEMM, and the permuted copy of the argument is not needed.
+    /// \return The strided contraction threshold, or 0 if strided
+    /// contractions are disabled
+    inline double strided_contraction_threshold() {
+      static const double threshold = detail::init_strided_contraction_threshold();
+      return threshold;
+    }
+
+    /// A tensor that is viewed as a matrix with permuted dimensions
+
+    /// The element in row \c i and column \c j of the matrix is
+    /// <tt>data[row_offsets[i] + col_offsets[j]]</tt>. The rows and columns
+    /// are the fused logical dimensions of the tensor, i.e. the dimensions of
+    /// the permuted tensor, so the tensor is contracted as if it were
+    /// permuted without constructing the permuted copy.
+    /// \tparam T The element type
+    template <typename T>
+    class StridedMatrix {
+      const T* data_; ///< The tensor data
+      std::vector<integer> row_offsets_; ///< Offsets of the rows
+      std::vector<integer> col_offsets_; ///< Offsets of the columns
+
+      /// Compute the offsets of the elements of a group of fused dimensions
+
+      /// \param range The tensor range
+      /// \param dims The storage dimensions in logical order
+      /// \param first The first logical dimension of the group
+      /// \param last The end of the logical dimensions of the group
+      /// \return The offsets of the fused index, in row-major order
+      static std::vector<integer> make_offsets(const Range& range,
+          const std::vector<unsigned int>& dims, const unsigned int first,
+          const unsigned int last)
+      {
+        std::vector<integer> offsets(1, 0);
+        for(unsigned int d = first; d < last; ++d) {
+          const integer extent = range.extent_data()[dims[d]];
+          const integer stride = range.stride_data()[dims[d]];
+          std::vector<integer> result;
+          result.reserve(offsets.size() * extent);
+          for(const integer offset : offsets)
+            for(integer i = 0; i < extent; ++i)
+              result.push_back(offset + i * stride);
+          offsets.swap(result);
+        }
+        return offsets;
+      }
+
+    public:
+
+      /// Constructor
+
+      /// The logical dimensions <tt>[row_begin, row_end)</tt> are fused into
+      /// the rows of the matrix and <tt>[col_begin, col_end)</tt> into the
+      /// columns, e.g. the outer and inner dimension ranges of a
+      /// \c GemmHelper .
+      /// \param data The tensor data
+      /// \param range The tensor range
+      /// \param perm The permutation from the storage order to the logical
+      /// order of the dimensions (empty for the identity)
+      /// \param row_begin The first row dimension
+      /// \param row_end The end of the row dimensions
+      /// \param col_begin The first column dimension
+      /// \param col_end The end of the column dimensions
+      StridedMatrix(const T* const data, const Range& range,
+          const Permutation& perm, const unsigned int row_begin,
+          const unsigned int row_end, const unsigned int col_begin,
+          const unsigned int col_end) :
+        data_(data), row_offsets_(), col_offsets_()
+      {
+        const unsigned int rank = range.rank();
+        TA_ASSERT(row_end <= rank);
+        TA_ASSERT(col_end <= rank);
+        TA_ASSERT(! perm || (perm.dim() == rank));
+
+        // Map the logical dimensions to the storage dimensions
+        std::vector<unsigned int> dims(rank);
+        for(unsigned int i = 0u; i < rank; ++i)
+          dims[perm ? perm[i] : i] = i;
+
+        row_offsets_ = make_offsets(range, dims, row_begin, row_end);
+        col_offsets_ = make_offsets(range, dims, col_begin, col_end);
+      }
+
+      /// \return The number of rows
+      integer rows() const { return row_offsets_.size(); }
+
+      /// \return The number of columns
+      integer cols() const { return col_offsets_.size(); }
+
+      /// Copy a block of the matrix into a contiguous buffer
+
+      /// \param i0 The first row of the block
+      /// \param j0 The first column of the block
+      /// \param rows The number of rows in the block
+      /// \param cols The number of columns in the block
+      /// \param[out] result The row-major block buffer
+      template <typename U>
+      void pack(const integer i0, const integer j0, const integer rows,
+          const integer cols, U* MADNESS_RESTRICT const result) const
+      {
+        const integer* MADNESS_RESTRICT const row_offsets = row_offsets_.data() + i0;
+        const integer* MADNESS_RESTRICT const col_offsets = col_offsets_.data() + j0;
+        const integer row_step = (rows > 1 ? row_offsets[1] - row_offsets[0] : 0);
+        const integer col_step = (cols > 1 ? col_offsets[1] - col_offsets[0] : 0);
+
+        // Traverse the block in the direction of the smaller stride
+        if((cols == 1) || ((rows > 1) && (row_step < col_step))) {
+          for(integer j = 0; j < cols; ++j) {
+            const T* MADNESS_RESTRICT const col = data_ + col_offsets[j];
+            for(integer i = 0; i < rows; ++i)
+              result[i * cols + j] = col[row_offsets[i]];
+          }
+        } else {
+          for(integer i = 0; i < rows; ++i) {
+            const T* MADNESS_RESTRICT const row = data_ + row_offsets[i];
+            U* MADNESS_RESTRICT const result_row = result + i * cols;
+            for(integer j = 0; j < cols; ++j)
+              result_row[j] = row[col_offsets[j]];
+          }
+        }
+      }
+
+    }; // class StridedMatrix
+
+
+    /// Blocked GEMM kernel for strided matrices
+
+    /// This object computes one \c GemmBlockSize::m_block x
+    /// \c GemmBlockSize::n_block block of \f$ C = \alpha A B + C \f$, where
+    /// \c A and \c B are strided matrices. As in \c GemmBlockTask , the
+    /// panels of \c A and \c B for each chunk of the inner dimension are
+    /// packed into contiguous buffers, here directly from the strided
+    /// layout, and passed to the serial \c gemm.
+    /// \tparam S The type of \c alpha
+    /// \tparam T1 The element type of \c A
+    /// \tparam T2 The element type of \c B
+    /// \tparam T3 The element type of \c C
+    template <typename S, typename T1, typename T2, typename T3>
+    class StridedGemmBlockTask {
+      const StridedMatrix<T1>& a_; ///< A matrix
+      const StridedMatrix<T2>& b_; ///< B matrix
+      const S alpha_; ///< Scaling factor for A*B
+      T3* const c_; ///< C matrix (row-major, with a leading dimension of n)
+
+    public:
+
+      StridedGemmBlockTask(const StridedMatrix<T1>& a,
+          const StridedMatrix<T2>& b, const S alpha, T3* const c) :
+        a_(a), b_(b), alpha_(alpha), c_(c)
+      { }
+
+      /// The number of block rows in C
+      integer row_blocks() const {
+        return (a_.rows() + GemmBlockSize::m_block - 1) / GemmBlockSize::m_block;
+      }
+
+      /// The number of block columns in C
+      integer col_blocks() const {
+        return (b_.cols() + GemmBlockSize::n_block - 1) / GemmBlockSize::n_block;
+      }
+
+      /// Evaluate a block of C
+
+      /// \param bi The block row index of C
+      /// \param bj The block column index of C
+      void operator()(const integer bi, const integer bj) const {
+        const integer m = a_.rows(), n = b_.cols(), k = a_.cols();
+        const integer i0 = bi * GemmBlockSize::m_block;
+        const integer j0 = bj * GemmBlockSize::n_block;
+        const integer mb = std::min(integer(GemmBlockSize::m_block), m - i0);
+        const integer nb = std::min(integer(GemmBlockSize::n_block), n - j0);
+        const integer kc = std::min(integer(GemmBlockSize::k_block), k);
+
+        std::vector<T1, Eigen::aligned_allocator<T1> > a_pack(mb * kc);
+        std::vector<T2, Eigen::aligned_allocator<T2> > b_pack(kc * nb);
+        T3* const c_block = c_ + i0 * n + j0;
+
+        for(integer p0 = 0; p0 < k; p0 += GemmBlockSize::k_block) {
+          const integer kb = std::min(integer(GemmBlockSize::k_block), k - p0);
+
+          // Pack A[i0:i0+mb, p0:p0+kb] and B[p0:p0+kb, j0:j0+nb]
+          a_.pack(i0, p0, mb, kb, a_pack.data());
+          b_.pack(p0, j0, kb, nb, b_pack.data());
+
+          math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, mb, nb,
+              kb, alpha_, a_pack.data(), kb, b_pack.data(), nb, T3(1),
+              c_block, n);
+        }
+      }
+
+#ifdef HAVE_INTEL_TBB
+      /// TBB parallel_for body
+
+      /// \param range The range of C blocks to evaluate
+      void operator()(const tbb::blocked_range2d<integer>& range) const {
+        for(integer bi = range.rows().begin(); bi != range.rows().end(); ++bi)
+          for(integer bj = range.cols().begin(); bj != range.cols().end(); ++bj)
+            operator()(bi, bj);
+      }
+#endif // HAVE_INTEL_TBB
+
+    }; // class StridedGemmBlockTask
+
+    /// GEMM for strided matrices
+
+    /// Computes \f$ C = \alpha A B + C \f$ , where \c C is a row-major
+    /// matrix and \c A and \c B are views of tensors with permuted
+    /// dimensions (GETT). The blocks of \c C are evaluated as independent
+    /// TBB tasks when \c use_parallel_gemm() is true for the matrix sizes.
+    /// \param alpha The scaling factor applied to \f$ A B \f$
+    /// \param a The left-hand matrix
+    /// \param b The right-hand matrix
+    /// \param c The result matrix, with a leading dimension of
+    /// <tt>b.cols()</tt>
+    template <typename S, typename T1, typename T2, typename T3>
+    inline void strided_gemm(const S alpha, const StridedMatrix<T1>& a,
+        const StridedMatrix<T2>& b, T3* const c)
+    {
+      TA_ASSERT(a.cols() == b.rows());
+
+      StridedGemmBlockTask<S, T1, T2, T3> task(a, b, alpha, c);
+      const integer row_blocks = task.row_blocks();
+      const integer col_blocks = task.col_blocks();
+      if(a.cols() == 0)
+        return;
+
+#ifdef HAVE_INTEL_TBB
+      if(use_parallel_gemm(a.rows(), b.cols(), a.cols()) &&
+          (row_blocks * col_blocks > 1))
+      {
+        tbb::parallel_for(tbb::blocked_range2d<integer>(0, row_blocks, 1,
+            0, col_blocks, 1), task, tbb::simple_partitioner());
+        return;
+      }
+#endif // HAVE_INTEL_TBB
+
+      for(integer bi = 0; bi < row_blocks; ++bi)
+        for(integer bj = 0; bj < col_blocks; ++bj)
+          task(bi, bj);
+    }
+
+  }  // namespace math
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_STRIDED_GEMM_H__INCLUDED
@@ -29,6 +29,8 @@
 #include <TiledArray/type_traits.h>
 #include <TiledArray/madness.h>
 #include <TiledArray/config.h>
+#include <algorithm>
+#include <cstdlib>
 
 #define TILEDARRAY_LOOP_UNWIND ::TiledArray::math::LoopUnwind::value
 
@@ -286,6 +288,52 @@ namespace TiledArray {
 
     }; // class Block
 
+    namespace detail {
+
+      /// Read the parallel vector operation threshold from the environment
+
+      /// The threshold may be set with the
+      /// \c TA_PARALLEL_VECTOR_OP_THRESHOLD environment variable; the default
+      /// is \f$ 2^{18} \f$ elements (e.g. 2 MB of \c double ).
+      /// \return The parallel vector operation threshold
+      inline std::size_t init_parallel_vector_op_threshold() {
+        const char* threshold = getenv("TA_PARALLEL_VECTOR_OP_THRESHOLD");
+        if(threshold)
+          return std::size_t(std::max(std::atol(threshold), 1l));
+        return 262144ul;
+      }
+
+    } // namespace detail
+
+    /// Parallel vector operation threshold accessor
+
+    /// \return The minimum number of elements for which vector operations
+    /// are split into TBB tasks
+    inline std::size_t parallel_vector_op_threshold() {
+      static const std::size_t threshold = detail::init_parallel_vector_op_threshold();
+      return threshold;
+    }
+
+    /// Check if a vector operation is large enough to be split into tasks
+
+    /// Vector operations on smaller vectors are evaluated by the calling
+    /// thread, since the tiles of an array are already evaluated by
+    /// concurrent tasks and splitting small vectors only adds scheduling
+    /// overhead. The parallel loops of larger vectors are TBB tasks, which
+    /// are executed by the threads of the task scheduler that is shared with
+    /// the MADNESS thread pool, so they use idle threads and do not
+    /// oversubscribe the cores when many tiles are evaluated at once.
+    /// \param n The number of elements in the vectors
+    /// \return \c true if the operation should be split into tasks,
+    /// otherwise \c false
+    inline bool use_parallel_vector_op(const std::size_t n) {
+#ifdef HAVE_INTEL_TBB
+      return n >= parallel_vector_op_threshold();
+#else
+      return false;
+#endif // HAVE_INTEL_TBB
+    }
+
 #ifdef HAVE_INTEL_TBB
 
     struct SizeTRange {
@@ -398,6 +446,7 @@ namespace TiledArray {
                                   const Args* const... args)
     {
       #ifdef HAVE_INTEL_TBB
+      if(use_parallel_vector_op(n)) {
 //        std::cout << "INPLACE_TBB_VECTOR_OP" << std::endl;
         SizeTRange range(0, n);
 
@@ -411,9 +460,10 @@ namespace TiledArray {
        auto apply_inplace_vector_op = ApplyInplaceVectorOp<Op, Result, Args...>(op, result, args...);
 
         tbb::parallel_for(range, apply_inplace_vector_op, tbb::auto_partitioner());
-      #else
-        inplace_vector_op_serial(op, n, result, args...);
+        return;
+      }
       #endif
+      inplace_vector_op_serial(op, n, result, args...);
     }
 
     template <typename Op, typename Result, typename... Args,
@@ -479,6 +529,7 @@ namespace TiledArray {
                    const Args* const... args)
     {
       #ifdef HAVE_INTEL_TBB
+      if(use_parallel_vector_op(n)) {
 //        std::cout << "TBB_VECTOR_OP" << std::endl;
         SizeTRange range(0, n);
 
@@ -492,9 +543,10 @@ namespace TiledArray {
       auto apply_vector_op = ApplyVectorOp<Op,Result,Args...>(op, result, args...);
 
       tbb::parallel_for(range, apply_vector_op, tbb::auto_partitioner());
-      #else
-        vector_op_serial(op, n, result, args...);
+        return;
+      }
       #endif
+      vector_op_serial(op, n, result, args...);
     }
 
     template <typename Op, typename Result, typename... Args>
@@ -546,6 +598,7 @@ namespace TiledArray {
     void vector_ptr_op(Op&& op, const std::size_t n, Result* const result,
                        const Args* const... args){
       #ifdef HAVE_INTEL_TBB
+      if(use_parallel_vector_op(n)) {
 //        std::cout << "TBB_VECTOR_PTR_OP" << std::endl;
         SizeTRange range(0, n);
 
@@ -558,9 +611,10 @@ namespace TiledArray {
         // else
         auto apply_vector_ptr_op = ApplyVectorPtrOp<Op,Result,Args...>(op, result, args...);
         tbb::parallel_for(range, apply_vector_ptr_op,tbb::auto_partitioner());
-      #else
-        vector_ptr_op_serial(op,n,result,args...);
+        return;
+      }
       #endif
+      vector_ptr_op_serial(op,n,result,args...);
     }
 
     template <typename Op, typename Result, typename... Args>
@@ -640,8 +694,8 @@ namespace TiledArray {
     void reduce_op(ReduceOp&& reduce_op, JoinOp&& join_op, const Result& identity, const std::size_t n, Result& result,
                    const Args* const... args)
     {
-      //TODO implement reduce operation with TBB
 #ifdef HAVE_INTEL_TBB
+      if(use_parallel_vector_op(n)) {
         SizeTRange range(0, n);
 
         auto apply_reduce_op = ApplyReduceOp<ReduceOp,JoinOp,Result,Args...>(reduce_op, join_op, identity, result, args...);
@@ -649,9 +703,10 @@ namespace TiledArray {
         tbb::parallel_reduce(range, apply_reduce_op, tbb::auto_partitioner());
 
         result = apply_reduce_op.result();
-#else
-        reduce_op_serial(reduce_op,n,result,args...);
+        return;
+      }
 #endif
+      reduce_op_serial(reduce_op,n,result,args...);
     }
 
     template <typename Arg, typename Result>
@@ -0,0 +1,194 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  balanced_pmap.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_BALANCED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_BALANCED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/tiled_range.h>
+#include <algorithm>
+#include <cmath>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// A cost-balanced process map
+
+    /// Tiles are split into contiguous blocks, like BlockedPmap, but the
+    /// block boundaries are chosen so that each process owns approximately
+    /// the same estimated cost instead of the same number of tiles. The cost
+    /// of a non-zero tile is a weighted sum of its memory, which is
+    /// proportional to the tile volume \f$ v \f$, and of its compute work,
+    /// which is estimated as \f$ v^{3/2} \f$ (the work of a matrix multiply
+    /// with square tiles); both are normalized by their totals. Zero tiles
+    /// have no cost. The map only stores the \f$ P+1 \f$ block boundaries, so
+    /// the owner of a tile is found with a binary search in
+    /// \f$ O(\log P) \f$ time. Since the shape is replicated, all processes
+    /// compute the same map.
+    class BalancedPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      std::vector<size_type> bounds_; ///< The first tile of each process block, and the number of tiles
+
+      /// Compute the volume of each tile
+
+      /// \param trange The tiled range of the array
+      /// \return The volume of each tile, in row-major order
+      static std::vector<double> tile_volumes(const TiledRange& trange) {
+        std::vector<double> volumes(1ul, 1.0);
+        for(const auto& tr1 : trange.data()) {
+          std::vector<double> temp;
+          temp.reserve(volumes.size() * tr1.tile_extent());
+          for(const double volume : volumes) {
+            for(auto t = tr1.tiles_range().first; t < tr1.tiles_range().second; ++t) {
+              const auto& tile = tr1.tile(t);
+              temp.push_back(volume * double(tile.second - tile.first));
+            }
+          }
+          volumes.swap(temp);
+        }
+        return volumes;
+      }
+
+      /// Split the tiles into blocks with equal cost
+
+      /// \param cost The cost of each tile
+      void init_bounds(const std::vector<double>& cost) {
+        // Compute the cumulative cost of the tiles
+        std::vector<double> sum(size_ + 1ul, 0.0);
+        for(size_type i = 0ul; i < size_; ++i)
+          sum[i + 1ul] = sum[i] + cost[i];
+        const double total = sum.back();
+
+        // Place each boundary at the tile where the cumulative cost is
+        // closest to the target cost of the preceding processes.
+        bounds_.resize(procs_ + 1ul, 0ul);
+        for(size_type p = 1ul; p < procs_; ++p) {
+          const double target = total * double(p) / double(procs_);
+          size_type b = std::lower_bound(sum.begin() + bounds_[p - 1ul],
+              sum.end(), target) - sum.begin();
+          if((b > bounds_[p - 1ul]) && ((target - sum[b - 1ul]) <= (sum[b] - target)))
+            --b;
+          bounds_[p] = std::min(b, size_);
+        }
+        bounds_[procs_] = size_;
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct a cost-balanced process map
+
+      /// \tparam Shape The shape type of the array
+      /// \param world The world where the tiles will be mapped
+      /// \param trange The tiled range of the array
+      /// \param shape The shape of the array; tiles for which
+      /// \c shape.is_zero() is \c true have no cost
+      /// \param compute_weight The weight of the compute work in the tile
+      /// cost, in the range [0,1]; the weight of the memory is
+      /// \c 1-compute_weight
+      template <typename Shape>
+      BalancedPmap(World& world, const TiledRange& trange, const Shape& shape,
+          const double compute_weight = 0.5) :
+        Pmap(world, trange.tiles_range().volume()), bounds_()
+      {
+        TA_ASSERT(compute_weight >= 0.0);
+        TA_ASSERT(compute_weight <= 1.0);
+
+        // Estimate the memory and work of the non-zero tiles
+        std::vector<double> memory = tile_volumes(trange);
+        std::vector<double> work(size_, 0.0);
+        double total_memory = 0.0, total_work = 0.0;
+        for(size_type i = 0ul; i < size_; ++i) {
+          if(shape.is_zero(i)) {
+            memory[i] = 0.0;
+          } else {
+            work[i] = memory[i] * std::sqrt(memory[i]);
+            total_memory += memory[i];
+            total_work += work[i];
+          }
+        }
+
+        // Blend the normalized costs. If all tiles are zero, or empty, fall
+        // back to an even distribution of tiles.
+        if(total_memory > 0.0) {
+          const double memory_scale = (1.0 - compute_weight) / total_memory;
+          const double work_scale = compute_weight / total_work;
+          for(size_type i = 0ul; i < size_; ++i)
+            memory[i] = memory[i] * memory_scale + work[i] * work_scale;
+        } else {
+          std::fill(memory.begin(), memory.end(), 1.0);
+        }
+        init_bounds(memory);
+
+        // Construct the list of local tiles
+        local_.reserve(bounds_[rank_ + 1ul] - bounds_[rank_]);
+        for(size_type tile = bounds_[rank_]; tile < bounds_[rank_ + 1ul]; ++tile)
+          local_.push_back(tile);
+      }
+
+      virtual ~BalancedPmap() { }
+
+      /// Block boundary accessor
+
+      /// \param p The process rank
+      /// \return The first tile owned by process \c p ; the tiles of process
+      /// \c p are in the range [ \c first(p) , \c first(p+1) )
+      size_type first(const size_type p) const {
+        TA_ASSERT(p <= procs_);
+        return bounds_[p];
+      }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return std::upper_bound(bounds_.begin() + 1l, bounds_.end(), tile)
+            - (bounds_.begin() + 1l);
+      }
+
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return ((tile >= bounds_[rank_]) && (tile < bounds_[rank_ + 1ul]));
+      }
+
+    }; // class BalancedPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+
+#endif // TILEDARRAY_PMAP_BALANCED_PMAP_H__INCLUDED
@@ -27,11 +27,21 @@
 #define TILEDARRAY_PMAP_HASH_PMAP_H__INCLUDED
 
 #include <TiledArray/pmap/pmap.h>
+#include <algorithm>
 
 namespace TiledArray {
   namespace detail {
 
     /// Hashed process map
+
+    /// Tiles are grouped into contiguous buckets, and each bucket is assigned
+    /// to a process with a hash of the bucket index. The number of buckets is
+    /// proportional to the number of processes, not to the number of tiles.
+    /// The local tile list is therefore built from
+    /// \f$ O(P \cdot \rm{buckets\_per\_proc}) \f$ hash evaluations plus
+    /// \f$ O(N_{\rm tiles}/P) \f$ insertions, instead of hashing every tile
+    /// on every rank. Increasing the number of buckets per process improves the
+    /// load balance at the cost of a longer construction time.
     class HashPmap : public Pmap {
     protected:
 
@@ -44,37 +54,76 @@ namespace TiledArray {
     private:
 
       const madness::hashT seed_; ///< Hashing seed value
+      const size_type bucket_size_; ///< The number of tiles in each bucket
+
+      /// Compute the number of tiles in each bucket
+
+      /// \param size The number of tiles to be mapped
+      /// \param procs The number of processes
+      /// \param buckets_per_proc The target number of buckets per process
+      /// \return The number of tiles in each bucket
+      static size_type init_bucket_size(const size_type size,
+          const size_type procs, const size_type buckets_per_proc)
+      {
+        const size_type buckets = std::max<size_type>(procs * buckets_per_proc, 1ul);
+        return std::max<size_type>((size + buckets - 1ul) / buckets, 1ul);
+      }
+
+      /// Maps \c bucket to the processor that owns it
+
+      /// \param bucket The bucket to be queried
+      /// \return Processor that logically owns \c bucket
+      size_type bucket_owner(const size_type bucket) const {
+        madness::hashT seed = seed_;
+        madness::hash_combine(seed, bucket);
+        return (seed % procs_);
+      }
 
     public:
       typedef Pmap::size_type size_type; ///< Size type
 
+      /// Default target number of buckets per process
+      static constexpr size_type default_buckets_per_proc = 64ul;
+
       /// Construct a hashed process map
 
       /// \param world The world where the tiles are mapped
       /// \param size The number of tiles to be mapped
       /// \param seed The hash seed used to generate different maps
-      HashPmap(World& world, const size_type size, madness::hashT seed = 0ul) :
-          Pmap(world, size), seed_(seed)
+      /// \param buckets_per_proc The target number of tile buckets per
+      /// process
+      HashPmap(World& world, const size_type size, madness::hashT seed = 0ul,
+          const size_type buckets_per_proc = default_buckets_per_proc) :
+          Pmap(world, size), seed_(seed),
+          bucket_size_(init_bucket_size(size, procs_, buckets_per_proc))
       {
-        // Construct a map of all local processes
-        // TODO: NON-SCALING!!!
-        // This code is non-scaling because it iterates over all elements
-        for(size_type i = 0ul; i < size_; ++i)
-          if(HashPmap::owner(i) == rank_)
-            local_.push_back(i);
+        // Construct the list of local tiles from the buckets owned by this
+        // process.
+        const size_type buckets = (size_ + bucket_size_ - 1ul) / bucket_size_;
+        for(size_type bucket = 0ul; bucket < buckets; ++bucket) {
+          if(bucket_owner(bucket) == rank_) {
+            const size_type first = bucket * bucket_size_;
+            const size_type last = std::min(first + bucket_size_, size_);
+            for(size_type tile = first; tile < last; ++tile)
+              local_.push_back(tile);
+          }
+        }
       }
 
       virtual ~HashPmap() { }
 
+      /// Bucket size accessor
+
+      /// \return The number of tiles in each bucket
+      size_type bucket_size() const { return bucket_size_; }
+
       /// Maps \c tile to the processor that owns it
 
       /// \param tile The tile to be queried
       /// \return Processor that logically owns \c tile
       virtual size_type owner(const size_type tile) const {
         TA_ASSERT(tile < size_);
-        madness::hashT seed = seed_;
-        madness::hash_combine(seed, tile);
-        return (seed % procs_);
+        return bucket_owner(tile / bucket_size_);
       }
 
 
@@ -0,0 +1,217 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  layered_cyclic_pmap.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Maps cyclically a matrix of indices onto a stack of 2-d process matrices
+
+    /// The processes are organized into \c layers matrices of
+    /// \f$ P_{\rm row} \times P_{\rm col} \f$ processes, where process
+    /// \f$ \{ p_{\rm layer}, p_{\rm row}, p_{\rm col} \} \f$ has rank
+    /// \f$ p_{\rm layer} P_{\rm row} P_{\rm col} + p_{\rm row} P_{\rm col} + p_{\rm col} \f$.
+    /// Either the rows or the columns of the index matrix are partitioned
+    /// into \c layers contiguous blocks (see \c layer_begin() ), and the
+    /// indices of block \f$ l \f$ are distributed cyclically, as with
+    /// \c CyclicPmap , over the processes of layer \f$ l \f$. This is the
+    /// distribution of the arguments of a contraction in which each layer
+    /// evaluates a contiguous block of the inner (contracted) dimension.
+    ///
+    /// \note This class is used to map <em>tile</em> indices to processes.
+    class LayeredCyclicPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const size_type rows_; ///< Number of tile rows to be mapped
+      const size_type cols_; ///< Number of tile columns to be mapped
+      const size_type proc_cols_; ///< Number of process columns
+      const size_type proc_rows_; ///< Number of process rows
+      const size_type layers_; ///< Number of process layers
+      const bool layer_cols_; ///< Columns are partitioned among layers if true, rows otherwise
+
+      /// Layer block accessor
+
+      /// \param tile_row The tile row index
+      /// \param tile_col The tile column index
+      /// \return The layer of the block that contains the tile
+      size_type tile_layer(const size_type tile_row, const size_type tile_col) const {
+        return (layer_cols_ ? layer(cols_, layers_, tile_col) :
+            layer(rows_, layers_, tile_row));
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param rows The number of tile rows to be mapped
+      /// \param cols The number of tile columns to be mapped
+      /// \param proc_rows The number of process rows in each layer
+      /// \param proc_cols The number of process columns in each layer
+      /// \param layers The number of process layers
+      /// \param layer_cols If \c true, the tile columns are partitioned among
+      /// the layers, otherwise the tile rows are
+      /// \throw TiledArray::Exception When <tt>proc_rows * proc_cols * layers > world.size()</tt>
+      /// \throw TiledArray::Exception When the partitioned dimension is
+      /// smaller than \c layers
+      LayeredCyclicPmap(World& world, size_type rows, size_type cols,
+          size_type proc_rows, size_type proc_cols, size_type layers,
+          const bool layer_cols) :
+        Pmap(world, rows * cols), rows_(rows), cols_(cols),
+        proc_cols_(proc_cols), proc_rows_(proc_rows), layers_(layers),
+        layer_cols_(layer_cols)
+      {
+        // Check that the size is non-zero
+        TA_ASSERT(rows_ >= 1ul);
+        TA_ASSERT(cols_ >= 1ul);
+
+        // Check limits of process rows, columns, and layers
+        TA_ASSERT(proc_rows_ >= 1ul);
+        TA_ASSERT(proc_cols_ >= 1ul);
+        TA_ASSERT(layers_ >= 1ul);
+        TA_ASSERT((proc_rows_ * proc_cols_ * layers_) <= procs_);
+        TA_ASSERT((layer_cols_ ? cols_ : rows_) >= layers_);
+
+        // Initialize local tile list
+        const size_type layer_size = proc_rows_ * proc_cols_;
+        const size_type rank_layer = rank_ / layer_size;
+        if(rank_layer < layers_) {
+          // Compute rank coordinates
+          const size_type rank_row = (rank_ % layer_size) / proc_cols_;
+          const size_type rank_col = rank_ % proc_cols_;
+
+          // Compute the block of rows and columns assigned to this layer
+          size_type row_begin = 0ul, row_end = rows_, col_begin = 0ul, col_end = cols_;
+          if(layer_cols_) {
+            col_begin = layer_begin(cols_, layers_, rank_layer);
+            col_end = layer_begin(cols_, layers_, rank_layer + 1ul);
+          } else {
+            row_begin = layer_begin(rows_, layers_, rank_layer);
+            row_end = layer_begin(rows_, layers_, rank_layer + 1ul);
+          }
+
+          // Move the first row and column to the cyclic position of this rank
+          row_begin += (proc_rows_ - ((row_begin + proc_rows_ - rank_row) % proc_rows_)) % proc_rows_;
+          col_begin += (proc_cols_ - ((col_begin + proc_cols_ - rank_col) % proc_cols_)) % proc_cols_;
+
+          // Iterate over local tiles
+          for(size_type i = row_begin; i < row_end; i += proc_rows_) {
+            const size_type tile_end = i * cols_ + col_end;
+            for(size_type tile = i * cols_ + col_begin; tile < tile_end; tile += proc_cols_) {
+              TA_ASSERT(LayeredCyclicPmap::owner(tile) == rank_);
+              local_.push_back(tile);
+            }
+          }
+        }
+      }
+
+      virtual ~LayeredCyclicPmap() { }
+
+      /// First index of a layer block
+
+      /// \param size The size of the partitioned dimension
+      /// \param layers The number of layers
+      /// \param layer The layer index, which may be equal to \c layers
+      /// \return The first index of the block assigned to \c layer , or
+      /// \c size when \c layer is equal to \c layers
+      static size_type layer_begin(const size_type size, const size_type layers,
+          const size_type layer)
+      {
+        TA_ASSERT(layer <= layers);
+        return (size * layer) / layers;
+      }
+
+      /// Layer of an index
+
+      /// \param size The size of the partitioned dimension
+      /// \param layers The number of layers
+      /// \param index The index in the partitioned dimension
+      /// \return The layer whose block contains \c index
+      static size_type layer(const size_type size, const size_type layers,
+          const size_type index)
+      {
+        TA_ASSERT(index < size);
+        return ((index + 1ul) * layers - 1ul) / size;
+      }
+
+      /// Access number of rows in the tile index matrix
+      size_type nrows() const { return rows_; }
+      /// Access number of columns in the tile index matrix
+      size_type ncols() const { return cols_; }
+      /// Access number of rows in the process matrix of each layer
+      size_type nrows_proc() const { return proc_rows_; }
+      /// Access number of columns in the process matrix of each layer
+      size_type ncols_proc() const { return proc_cols_; }
+      /// Access number of process layers
+      size_type nlayers() const { return layers_; }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        // Compute tile coordinate in tile grid
+        const size_type tile_row = tile / cols_;
+        const size_type tile_col = tile % cols_;
+        // Compute process coordinate of tile in the process grid
+        const size_type proc_layer = tile_layer(tile_row, tile_col);
+        const size_type proc_row = tile_row % proc_rows_;
+        const size_type proc_col = tile_col % proc_cols_;
+        // Compute the process that owns tile
+        const size_type proc =
+            (proc_layer * proc_rows_ + proc_row) * proc_cols_ + proc_col;
+
+        TA_ASSERT(proc < procs_);
+
+        return proc;
+      }
+
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return (LayeredCyclicPmap::owner(tile) == rank_);
+      }
+
+    }; // class LayeredCyclicPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+
+#endif // TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
@@ -27,6 +27,7 @@
 #define TILEDARRAY_GRID_H__INCLUDED
 
 #include <TiledArray/pmap/cyclic_pmap.h>
+#include <TiledArray/pmap/layered_cyclic_pmap.h>
 #include <TiledArray/math/eigen.h>
 
 namespace TiledArray {
@@ -56,6 +57,15 @@ namespace TiledArray {
     /// \f]
     /// where the positive, real root of \f$P_{\rm{row}}\f$ give the optimal
     /// optimal communication time.
+    ///
+    /// The grid may also be replicated over several process layers (a 3D
+    /// grid). Each layer is a 2D grid of \c proc_size() processes, where
+    /// layer \f$l\f$ contains the processes with ranks in
+    /// \f$[l P_{\rm{layer}}, (l+1) P_{\rm{layer}})\f$, and \f$P_{\rm{layer}}\f$
+    /// is the layer size. The inner dimension of a contraction is partitioned
+    /// among the layers (see \c make_row_phase_pmap() and
+    /// \c make_col_phase_pmap() ), so each layer evaluates a partial result
+    /// for the elements of the grid, and the result is held by layer 0.
     class ProcGrid {
     public:
       typedef uint_fast32_t size_type;
@@ -67,10 +77,13 @@ namespace TiledArray {
       size_type size_; ///< Number of elements
       size_type proc_rows_; ///< Number of rows in the process grid
       size_type proc_cols_; ///< Number of columns in the process grid
-      size_type proc_size_; ///< Number of processes in the process grid. This
-                         ///<  may be less than the number of processes in world.
+      size_type proc_size_; ///< Number of processes in each layer of the process
+                         ///<  grid. This may be less than the number of
+                         ///<  processes in world.
+      size_type proc_layers_; ///< Number of layers in the process grid
       ProcessID rank_row_; ///< This process's row in the process grid
       ProcessID rank_col_; ///< This process's column in the process grid
+      ProcessID rank_layer_; ///< This process's layer in the process grid
       size_type local_rows_; ///< The number of local element rows
       size_type local_cols_; ///< The number of local element columns
       size_type local_size_; ///< Number of local elements
@@ -172,6 +185,10 @@ namespace TiledArray {
 
       /// This function initializes the member variables with with the optimal
       /// sizes.
+      /// \param rank The rank of this process
+      /// \param nprocs The number of processes in each layer
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
       void init(const size_type rank, const size_type nprocs,
           const std::size_t row_size, const std::size_t col_size)
       {
@@ -183,15 +200,6 @@ namespace TiledArray {
           proc_cols_ = 1u;
           proc_size_ = 1u;
 
-          // Set this process rank
-          rank_row_ = 0;
-          rank_col_ = 0;
-
-          // Set local counts
-          local_rows_ = rows_;
-          local_cols_ = cols_;
-          local_size_ = size_;
-
         } else if(size_ <= nprocs) { // Max one tile per process
 
           // Set process grid sizes
@@ -199,17 +207,6 @@ namespace TiledArray {
           proc_cols_ = cols_;
           proc_size_ = size_;
 
-          if(rank < proc_size_) {
-            // Set this process rank
-            rank_row_ = rank / proc_cols_;
-            rank_col_ = rank % proc_cols_;
-
-            // Set local counts
-            local_rows_ = 1u;
-            local_cols_ = 1u;
-            local_size_ = 1u;
-          }
-
         } else { // The not so simple case
 
           // Compute the limits for process rows
@@ -232,17 +229,18 @@ namespace TiledArray {
           }
 
           proc_size_ = proc_rows_ * proc_cols_;
+        }
 
-          if(rank < proc_size_) {
-            // Set this process rank
-            rank_row_ = rank / proc_cols_;
-            rank_col_ = rank % proc_cols_;
+        if(rank < (proc_size_ * proc_layers_)) {
+          // Set this process rank
+          rank_layer_ = rank / proc_size_;
+          rank_row_ = (rank % proc_size_) / proc_cols_;
+          rank_col_ = rank % proc_cols_;
 
-            // Set local counts
-            local_rows_ = (rows_ / proc_rows_) + (size_type(rank_row_) < (rows_ % proc_rows_) ? 1u : 0u);
-            local_cols_ = (cols_ / proc_cols_) + (size_type(rank_col_) < (cols_ % proc_cols_) ? 1u : 0u);
-            local_size_ = local_rows_ * local_cols_;
-          }
+          // Set local counts
+          local_rows_ = (rows_ / proc_rows_) + (size_type(rank_row_) < (rows_ % proc_rows_) ? 1u : 0u);
+          local_cols_ = (cols_ / proc_cols_) + (size_type(rank_col_) < (cols_ % proc_cols_) ? 1u : 0u);
+          local_size_ = local_rows_ * local_cols_;
         }
       }
 
@@ -252,8 +250,9 @@ namespace TiledArray {
       /// All sizes are initialized to zero.
       ProcGrid() :
         world_(NULL), rows_(0u), cols_(0u), size_(0u), proc_rows_(0u),
-        proc_cols_(0u), proc_size_(0u), rank_row_(0), rank_col_(0),
-        local_rows_(0u), local_cols_(0u), local_size_(0u)
+        proc_cols_(0u), proc_size_(0u), proc_layers_(0u), rank_row_(0),
+        rank_col_(0), rank_layer_(0), local_rows_(0u), local_cols_(0u),
+        local_size_(0u)
       { }
 
       /// Construct a process grid
@@ -266,11 +265,13 @@ namespace TiledArray {
       /// \param cols The number of tile columns
       /// \param row_size The number of element rows
       /// \param col_size The number of element columns
+      /// \param layers The number of process layers
       ProcGrid(World& world, const size_type rows, const size_type cols,
-          const std::size_t row_size, const std::size_t col_size) :
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers = 1u) :
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
         proc_rows_(0ul), proc_cols_(0ul), proc_size_(0ul),
-        rank_row_(-1), rank_col_(-1),
+        proc_layers_(layers), rank_row_(-1), rank_col_(-1), rank_layer_(-1),
         local_rows_(0ul), local_cols_(0ul), local_size_(0ul)
       {
         // Check for non-zero sizes
@@ -278,8 +279,10 @@ namespace TiledArray {
         TA_ASSERT(cols_ >= 1u);
         TA_ASSERT(row_size >= 1ul);
         TA_ASSERT(col_size >= 1ul);
+        TA_ASSERT(proc_layers_ >= 1u);
+        TA_ASSERT(proc_layers_ <= size_type(world_->size()));
 
-        init(world_->rank(), world_->size(), row_size, col_size);
+        init(world_->rank(), world_->size() / proc_layers_, row_size, col_size);
       }
 
 #ifdef TILEDARRAY_ENABLE_TEST_PROC_GRID
@@ -300,12 +303,15 @@ namespace TiledArray {
       /// \param cols The number of tile columns
       /// \param row_size The number of element rows
       /// \param col_size The number of element columns
+      /// \param layers The number of process layers
       ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
           const size_type rows, const size_type cols,
-          const std::size_t row_size, const std::size_t col_size) :
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers = 1u) :
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
-        proc_rows_(0u), proc_cols_(0u), proc_size_(0u), rank_row_(-1),
-        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u)
+        proc_rows_(0u), proc_cols_(0u), proc_size_(0u), proc_layers_(layers),
+        rank_row_(-1), rank_col_(-1), rank_layer_(-1), local_rows_(0u),
+        local_cols_(0u), local_size_(0u)
       {
         // Check for non-zero sizes
         TA_ASSERT(rows >= 1u);
@@ -313,8 +319,10 @@ namespace TiledArray {
         TA_ASSERT(row_size >= 1u);
         TA_ASSERT(col_size >= 1u);
         TA_ASSERT(test_rank < test_nprocs);
+        TA_ASSERT(layers >= 1u);
+        TA_ASSERT(layers <= test_nprocs);
 
-        init(test_rank, test_nprocs, row_size, col_size);
+        init(test_rank, test_nprocs / layers, row_size, col_size);
       }
 #endif // TILEDARRAY_ENABLE_TEST_PROC_GRID
 
@@ -328,7 +336,8 @@ namespace TiledArray {
         world_(other.world_), rows_(other.rows_), cols_(other.cols_),
         size_(other.size_), proc_rows_(other.proc_rows_),
         proc_cols_(other.proc_cols_), proc_size_(other.proc_size_),
-        rank_row_(other.rank_row_), rank_col_(other.rank_col_),
+        proc_layers_(other.proc_layers_), rank_row_(other.rank_row_),
+        rank_col_(other.rank_col_), rank_layer_(other.rank_layer_),
         local_rows_(other.local_rows_), local_cols_(other.local_cols_),
         local_size_(other.local_size_)
       { }
@@ -344,8 +353,10 @@ namespace TiledArray {
         proc_rows_ = other.proc_rows_;
         proc_cols_ = other.proc_cols_;
         proc_size_ = other.proc_size_;
+        proc_layers_ = other.proc_layers_;
         rank_row_ = other.rank_row_;
         rank_col_ = other.rank_col_;
+        rank_layer_ = other.rank_layer_;
         local_rows_ = other.local_rows_;
         local_cols_ = other.local_cols_;
         local_size_ = other.local_size_;
@@ -393,6 +404,11 @@ namespace TiledArray {
       /// \return The column of this process in the process grid
       ProcessID rank_col() const { return rank_col_; }
 
+      /// Rank layer accessor
+
+      /// \return The layer of this process in the process grid
+      ProcessID rank_layer() const { return rank_layer_; }
+
       /// Process row count accessor
 
       /// \return The number of rows in the process grid
@@ -405,10 +421,25 @@ namespace TiledArray {
 
       /// Process grid size accessor
 
-      /// \return The number of processes included in the process grid (may be
-      /// less than the number of process in world).
+      /// \return The number of processes included in each layer of the
+      /// process grid (may be less than the number of process in world).
       size_type proc_size() const { return proc_size_; }
 
+      /// Process layer count accessor
+
+      /// \return The number of layers in the process grid
+      size_type proc_layers() const { return proc_layers_; }
+
+      /// Inner dimension partition accessor
+
+      /// \param k The number of tiles in the inner dimension
+      /// \param layer The process layer, which may be equal to \c proc_layers()
+      /// \return The first inner tile index evaluated by \c layer , or \c k
+      /// when \c layer is equal to \c proc_layers()
+      size_type layer_begin(const size_type k, const size_type layer) const {
+        return LayeredCyclicPmap::layer_begin(k, proc_layers_, layer);
+      }
+
 
       /// Construct a row group
 
@@ -425,7 +456,7 @@ namespace TiledArray {
           proc_list.reserve(proc_cols_);
 
           // Populate the row process list
-          size_type p = rank_row_ * proc_cols_;
+          size_type p = (rank_layer_ * proc_rows_ + rank_row_) * proc_cols_;
           const size_type row_end = p + proc_cols_;
           for(; p < row_end; ++p)
             proc_list.push_back(p);
@@ -452,7 +483,8 @@ namespace TiledArray {
           proc_list.reserve(proc_rows_);
 
           // Populate the column process list
-          for(size_type p = rank_col_; p < proc_size_; p += proc_cols_)
+          const size_type layer_offset = rank_layer_ * proc_size_;
+          for(size_type p = layer_offset + rank_col_; p < (layer_offset + proc_size_); p += proc_cols_)
             proc_list.push_back(p);
 
           // Construct the group
@@ -469,7 +501,7 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (row,rank_col)
       ProcessID map_row(const size_type row) const {
         TA_ASSERT(row < proc_rows_);
-        return rank_col_ + row * proc_cols_;
+        return rank_layer_ * proc_size_ + rank_col_ + row * proc_cols_;
       }
 
       /// Map a column to the process in this process's row
@@ -478,7 +510,16 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (rank_row,col)
       ProcessID map_col(const size_type col) const {
         TA_ASSERT(col < proc_cols_);
-        return rank_row_ * proc_cols_ + col;
+        return rank_layer_ * proc_size_ + rank_row_ * proc_cols_ + col;
+      }
+
+      /// Map a layer to the process in this process's row and column
+
+      /// \param layer The layer to be mapped
+      /// \return The process the corresponds to the process coordinate \c (rank_row,rank_col) in \c layer
+      ProcessID map_layer(const size_type layer) const {
+        TA_ASSERT(layer < proc_layers_);
+        return layer * proc_size_ + rank_row_ * proc_cols_ + rank_col_;
       }
 
       /// Construct a cyclic process
@@ -494,24 +535,32 @@ namespace TiledArray {
       /// Construct column phased a cyclic process
 
       /// Construct a cyclic process map where the column phase of the process
-      /// matches that of this process grid.
+      /// matches that of this process grid. When the grid has more than one
+      /// layer, the rows are partitioned among the layers.
       /// \param rows The number of rows in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_col_phase_pmap(const size_type rows) const {
         TA_ASSERT(world_);
 
+        if(proc_layers_ > 1u)
+          return std::make_shared<LayeredCyclicPmap>(*world_, rows, cols_,
+              proc_rows_, proc_cols_, proc_layers_, false);
         return std::make_shared<CyclicPmap>(*world_, rows, cols_, proc_rows_, proc_cols_);
       }
 
       /// Construct row phased a cyclic process
 
       /// Construct a cyclic process map where the column phase of the process
-      /// matches that of this process grid.
+      /// matches that of this process grid. When the grid has more than one
+      /// layer, the columns are partitioned among the layers.
       /// \param cols The number of columns in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_row_phase_pmap(const size_type cols) const {
         TA_ASSERT(world_);
 
+        if(proc_layers_ > 1u)
+          return std::make_shared<LayeredCyclicPmap>(*world_, rows_, cols,
+              proc_rows_, proc_cols_, proc_layers_, true);
         return std::make_shared<CyclicPmap>(*world_, rows_, cols, proc_rows_, proc_cols_);
       }
     }; // class Grid
@@ -35,6 +35,9 @@ namespace TiledArray {
   /// test if an element is included in the range with a coordinate index or
   /// ordinal offset. Finally, it can be used to convert coordinate indices to
   /// ordinal offsets and vice versa.
+  /// The dimension data of ranges with a rank of up to \c max_inline_rank is
+  /// stored inside the range object, so constructing, copying, and permuting
+  /// these ranges does not allocate memory.
   /// TODO add Range support for negative indices
   class Range {
   public:
@@ -48,6 +51,9 @@ namespace TiledArray {
     typedef detail::RangeIterator<size_type, Range_> const_iterator; ///< Coordinate iterator
     friend class detail::RangeIterator<size_type, Range_>;
 
+    /// The maximum rank of a range with inline dimension data
+    static constexpr unsigned int max_inline_rank = 6u;
+
   protected:
 
     size_type* data_ = nullptr;
@@ -62,6 +68,67 @@ namespace TiledArray {
     size_type offset_ = 0ul; ///< Ordinal index offset correction
     size_type volume_ = 0ul; ///< Total number of elements
     unsigned int rank_ = 0u; ///< The rank (or number of dimensions) in the range
+    size_type inline_data_[max_inline_rank << 2]; ///< Inline storage for \c data_
+
+    /// Allocate the dimension data
+
+    /// \c data_ points to \c inline_data_ when \c rank is less than or
+    /// equal to \c max_inline_rank , otherwise it is allocated on the heap.
+    /// \param rank The rank of the range
+    /// \pre \c data_ does not own heap memory
+    /// \post \c data_ can hold 4*rank elements and \c rank_ is equal to
+    /// \c rank
+    /// \throw std::bad_alloc When memory allocation fails.
+    void alloc_data(const unsigned int rank) {
+      data_ = (rank == 0u ? nullptr :
+          (rank <= max_inline_rank ? inline_data_ : new size_type[rank << 2]));
+      rank_ = rank;
+    }
+
+    /// Free the dimension data
+
+    /// \post \c data_ is \c nullptr
+    void free_data() {
+      if(data_ != inline_data_)
+        delete [] data_;
+      data_ = nullptr;
+    }
+
+    /// Reallocate the dimension data for a new rank
+
+    /// The current dimension data is kept when the rank is not changed.
+    /// \param rank The rank of the range
+    /// \throw std::bad_alloc When memory allocation fails.
+    void realloc_data(const unsigned int rank) {
+      if(rank_ != rank) {
+        free_data();
+        alloc_data(rank);
+      }
+    }
+
+    /// Take the dimension data of another range
+
+    /// Heap memory is moved to this range, and inline data is copied.
+    /// \param other The range to be moved
+    /// \pre \c data_ does not own heap memory
+    /// \post \c other is an empty range
+    void move_data(Range_& other) {
+      if(other.data_ == other.inline_data_) {
+        data_ = inline_data_;
+        std::memcpy(inline_data_, other.inline_data_,
+            (sizeof(size_type) << 2) * other.rank_);
+      } else {
+        data_ = other.data_;
+      }
+      offset_ = other.offset_;
+      volume_ = other.volume_;
+      rank_ = other.rank_;
+
+      other.data_ = nullptr;
+      other.offset_ = 0ul;
+      other.volume_ = 0ul;
+      other.rank_ = 0u;
+    }
 
   private:
 
@@ -309,8 +376,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(lower_bound, upper_bound);
       }
     }
@@ -333,8 +399,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(lower_bound, upper_bound);
       }
     }
@@ -353,8 +418,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(extent);
       }
     }
@@ -371,8 +435,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(extent);
       }
     }
@@ -393,8 +456,7 @@ namespace TiledArray {
       const size_type n = detail::size(bounds);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(bounds);
       }
     }
@@ -413,8 +475,7 @@ namespace TiledArray {
       const size_type n = detail::size(bounds);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(bounds);
       }
     }
@@ -450,27 +511,18 @@ namespace TiledArray {
     /// \throw std::bad_alloc When memory allocation fails.
     Range(const Range_& other) {
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
+        alloc_data(other.rank_);
         offset_ = other.offset_;
         volume_ = other.volume_;
-        rank_ = other.rank_;
         memcpy(data_, other.data_, (sizeof(size_type) << 2) * other.rank_);
       }
     }
 
-    /// Copy Constructor
+    /// Move Constructor
 
-    /// \param other The range to be copied
-    /// \throw std::bad_alloc When memory allocation fails.
-    Range(Range_&& other) :
-      data_(other.data_), offset_(other.offset_), volume_(other.volume_),
-      rank_(other.rank_)
-    {
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
-    }
+    /// \param other The range to be moved
+    /// \throw nothing
+    Range(Range_&& other) { move_data(other); }
 
     /// Permuting copy constructor
 
@@ -481,8 +533,7 @@ namespace TiledArray {
       TA_ASSERT(perm.dim() == other.rank_);
 
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
-        rank_ = other.rank_;
+        alloc_data(other.rank_);
 
         if(perm) {
           init_range_data(perm, other.data_, other.data_ + rank_);
@@ -496,7 +547,7 @@ namespace TiledArray {
     }
 
     /// Destructor
-    ~Range() { delete [] data_; }
+    ~Range() { free_data(); }
 
     /// Copy assignment operator
 
@@ -504,11 +555,7 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw std::bad_alloc When memory allocation fails.
     Range_& operator=(const Range_& other) {
-      if(rank_ != other.rank_) {
-        delete [] data_;
-        data_ = (other.rank_ > 0ul ? new size_type[other.rank_ << 2] : nullptr);
-        rank_ = other.rank_;
-      }
+      realloc_data(other.rank_);
       memcpy(data_, other.data_, (sizeof(size_type) << 2) * rank_);
       offset_ = other.offset_;
       volume_ = other.volume_;
@@ -522,15 +569,10 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw nothing
     Range_& operator=(Range_&& other) {
-      data_ = other.data_;
-      offset_ = other.offset_;
-      volume_ = other.volume_;
-      rank_ = other.rank_;
-
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
+      if(this != &other) {
+        free_data();
+        move_data(other);
+      }
 
       return *this;
     }
@@ -756,11 +798,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
 
       // Reallocate memory for range arrays
-      if(rank_ != n) {
-        delete [] data_;
-        data_ = (n > 0ul ? new size_type[n << 2] : nullptr);
-        rank_ = n;
-      }
+      realloc_data(n);
       if(n > 0ul)
         init_range_data(lower_bound, upper_bound);
       else
@@ -924,11 +962,7 @@ namespace TiledArray {
 
       // Reallocate the array
       const unsigned int four_x_rank = rank << 2;
-      if(rank_ != rank) {
-        delete [] data_;
-        data_ = (rank > 0u ? new size_type[four_x_rank] : nullptr);
-        rank_ = rank;
-      }
+      realloc_data(rank);
 
       // Get range data
       ar & madness::archive::wrap(data_, four_x_rank) & offset_ & volume_;
@@ -941,11 +975,18 @@ namespace TiledArray {
     }
 
     void swap(Range_& other) {
-      // Get temp data
-      std::swap(data_, other.data_);
-      std::swap(offset_, other.offset_);
-      std::swap(volume_, other.volume_);
-      std::swap(rank_, other.rank_);
+      if((data_ != inline_data_) && (other.data_ != other.inline_data_)) {
+        // Swap heap data
+        std::swap(data_, other.data_);
+        std::swap(offset_, other.offset_);
+        std::swap(volume_, other.volume_);
+        std::swap(rank_, other.rank_);
+      } else {
+        // Inline data is copied
+        Range_ temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+      }
     }
 
   private:
@@ -1032,14 +1073,17 @@ namespace TiledArray {
     TA_ASSERT(perm.dim() == rank_);
     if(rank_ > 1ul) {
       // Copy the lower and upper bound data into a temporary array
-      size_type* MADNESS_RESTRICT const temp_lower = new size_type[rank_ << 1];
+      size_type temp_buffer[max_inline_rank << 1];
+      size_type* MADNESS_RESTRICT const temp_lower = (rank_ <= max_inline_rank ?
+          temp_buffer : new size_type[rank_ << 1]);
       const size_type* MADNESS_RESTRICT const temp_upper = temp_lower + rank_;
       std::memcpy(temp_lower, data_, (sizeof(size_type) << 1) * rank_);
 
       init_range_data(perm, temp_lower, temp_upper);
 
       // Cleanup old memory.
-      delete[] temp_lower;
+      if(temp_lower != temp_buffer)
+        delete[] temp_lower;
     }
     return *this;
   }
@@ -23,6 +23,8 @@
 #include <TiledArray/config.h>
 #include <TiledArray/error.h>
 #include <TiledArray/madness.h>
+#include <TiledArray/type_traits.h>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
@@ -42,6 +44,24 @@ namespace TiledArray {
       typedef std::pair<Future<T>, Future<U> > type;
     }; // struct ArgumentHelper
 
+    /// Check for a batch reduction operation
+
+    /// \c value is \c true if \c Op can reduce a batch of arguments at once,
+    /// i.e. if it has the member function
+    /// <tt>void operator()(Result&, const std::vector<const Arg*>&)</tt> .
+    /// \tparam Op The reduction operation type
+    /// \tparam Result The reduction result type
+    /// \tparam Arg The reduction argument type
+    template <typename Op, typename Result, typename Arg, typename = void>
+    struct is_batch_reducible : public std::false_type { };
+
+    template <typename Op, typename Result, typename Arg>
+    struct is_batch_reducible<Op, Result, Arg,
+        void_t<decltype(std::declval<Op&>()(std::declval<Result&>(),
+            std::declval<const std::vector<const Arg*>&>()))> > :
+        public std::true_type
+    { };
+
     /// Wrapper that to convert a pair-wise reduction into a standard reduction
 
     /// \tparam opT The pair-wise reduction operation to be reduced
@@ -112,6 +132,34 @@ namespace TiledArray {
         op_(result, arg.first, arg.second);
       }
 
+      /// Reduce a batch of argument pairs
+
+      /// This function is only defined if \c opT reduces batches of pairs,
+      /// with the member function
+      /// \code
+      /// void operator()(result_type&,
+      ///     const std::vector<const first_argument_type*>&,
+      ///     const std::vector<const second_argument_type*>&) const;
+      /// \endcode
+      /// \param[out] result The object that will hold the result of this reduction
+      /// \param[in] args The argument pairs to be reduced
+      template <typename Op = opT>
+      auto operator()(result_type& result, const std::vector<const argument_type*>& args) const ->
+          decltype(std::declval<const Op&>()(result,
+              std::declval<const std::vector<const first_argument_type*>&>(),
+              std::declval<const std::vector<const second_argument_type*>&>()))
+      {
+        std::vector<const first_argument_type*> first;
+        std::vector<const second_argument_type*> second;
+        first.reserve(args.size());
+        second.reserve(args.size());
+        for(const argument_type* arg : args) {
+          first.push_back(& arg->first.get());
+          second.push_back(& arg->second.get());
+        }
+        op_(result, first, second);
+      }
+
     }; // class ReducePairOpWrapper
 
 
@@ -188,6 +236,15 @@ namespace TiledArray {
     ///     }
     /// }; // struct VectorProduct
     /// \endcode
+    ///
+    /// In batch mode, the arguments that are ready are queued and reduced
+    /// serially by a single task, which reduces all arguments that are ready
+    /// at once if the operation has the optional member function
+    /// \code
+    /// void operator()(result_type&, const std::vector<const argument_type*>&) const;
+    /// \endcode
+    /// This avoids the task-per-argument overhead of reductions of many small
+    /// arguments.
     /// \note There is no need to add this object to the MADNESS task queue. It
     /// will be handled internally by the object. Simply call \c submit() to add
     /// this task to the task queue.
@@ -386,10 +443,72 @@ namespace TiledArray {
           this->dec();
         }
 
+        /// Reduce a batch of arguments with the batch operation
+        void reduce_batch(result_type& result,
+            const std::vector<const argument_type*>& args, std::true_type)
+        {
+          if(args.size() == 1ul)
+            op_(result, *args.front());
+          else
+            op_(result, args);
+        }
+
+        /// Reduce a batch of arguments one at a time
+        void reduce_batch(result_type& result,
+            const std::vector<const argument_type*>& args, std::false_type)
+        {
+          for(const argument_type* arg : args)
+            op_(result, *arg);
+        }
+
+        /// Reduce the queued arguments in batches
+
+        /// The arguments that are queued while a batch is reduced are
+        /// reduced in the next batch, until the queue is empty, after which
+        /// \c result is placed in the ready state.
+        /// \param result The target of the reduction
+        void reduce_batches(std::shared_ptr<result_type> result) {
+          std::vector<ReduceObject*> objects;
+          std::vector<const argument_type*> args;
+          std::size_t count = 0ul;
+
+          while(true) {
+            lock_.lock(); // <<< Begin critical section
+            if(batch_objects_.empty()) {
+              ready_result_ = result;
+              lock_.unlock(); // <<< End critical section
+              break;
+            }
+            objects.swap(batch_objects_);
+            lock_.unlock(); // <<< End critical section
+
+            // Reduce the batch
+            args.clear();
+            for(const ReduceObject* object : objects)
+              args.push_back(& object->arg());
+            reduce_batch(*result, args, std::integral_constant<bool,
+                is_batch_reducible<opT, result_type, argument_type>::value>());
+
+            // Cleanup the arguments
+            for(const ReduceObject* object : objects)
+              ReduceObject::destroy(object);
+            count += objects.size();
+            objects.clear();
+          }
+
+          // Decrement the dependency counter for the arguments. This must be
+          // done after result is placed in the ready state to avoid a race
+          // condition.
+          for(; count > 0ul; --count)
+            this->dec();
+        }
+
         World& world_; ///< The world that owns this task
         opT op_; ///< The reduction operation
         std::shared_ptr<result_type> ready_result_; ///< Result object that is ready to be reduced
         volatile ReduceObject* ready_object_; ///< Reduction argument that is ready to be reduced
+        const bool batch_; ///< Reduce the arguments in batches
+        std::vector<ReduceObject*> batch_objects_; ///< Reduction arguments that are queued for the next batch
         Future<result_type> result_; ///< The result of the reduction task
         madness::Spinlock lock_; ///< Task lock
         madness::CallbackInterface* callback_; ///< The completion callback
@@ -402,10 +521,13 @@ namespace TiledArray {
         /// \param op The reduction operation
         /// \param callback The callback that will be invoked when this task
         /// has completed
-        ReduceTaskImpl(World& world, opT op, madness::CallbackInterface* callback) :
+        /// \param batch Reduce the arguments in batches
+        ReduceTaskImpl(World& world, opT op, madness::CallbackInterface* callback,
+            const bool batch) :
           madness::TaskInterface(1, TaskAttributes::hipri()),
           world_(world), op_(op), ready_result_(std::make_shared<result_type>(op())),
-          ready_object_(nullptr), result_(), lock_(), callback_(callback)
+          ready_object_(nullptr), batch_(batch), batch_objects_(), result_(),
+          lock_(), callback_(callback)
         { }
 
         virtual ~ReduceTaskImpl() { }
@@ -427,7 +549,17 @@ namespace TiledArray {
         void ready(ReduceObject* object) {
           MADNESS_ASSERT(object);
           lock_.lock(); // <<< Begin critical section
-          if(ready_result_) {
+          if(batch_) {
+            // Queue the object, and start a batch reduction task if the
+            // result is not being reduced
+            batch_objects_.push_back(object);
+            std::shared_ptr<result_type> ready_result = ready_result_;
+            ready_result_.reset();
+            lock_.unlock(); // <<< End critical section
+            if(ready_result)
+              world_.taskq.add(this, & ReduceTaskImpl::reduce_batches,
+                  ready_result, TaskAttributes::hipri());
+          } else if(ready_result_) {
             std::shared_ptr<result_type> ready_result = ready_result_;
             ready_result_.reset();
             lock_.unlock(); // <<< End critical section
@@ -475,9 +607,10 @@ namespace TiledArray {
       /// \param op The reduction operation [ default = opT() ]
       /// \param callback The callback that will be invoked when this task is
       /// complete
+      /// \param batch Reduce the arguments in batches [ default = false ]
       ReduceTask(World& world, const opT& op = opT(),
-          madness::CallbackInterface* callback = nullptr) :
-        pimpl_(new ReduceTaskImpl(world, op, callback)), count_(0ul)
+          madness::CallbackInterface* callback = nullptr, const bool batch = false) :
+        pimpl_(new ReduceTaskImpl(world, op, callback, batch)), count_(0ul)
       { }
 
       /// Move constructor
@@ -666,8 +799,12 @@ namespace TiledArray {
       /// \param op The pair reduction operation [ default = opT() ]
       /// \param callback The callback that will be invoked when this task is
       /// complete
-      ReducePairTask(World& world, const opT& op = opT(), madness::CallbackInterface* callback = nullptr) :
-        ReduceTask_(world, op_type(op), callback)
+      /// \param batch Reduce the argument pairs in batches, e.g. with a
+      /// single GEMM for the tile pairs of a contraction (see \c ReduceTask )
+      /// [ default = false ]
+      ReducePairTask(World& world, const opT& op = opT(),
+          madness::CallbackInterface* callback = nullptr, const bool batch = false) :
+        ReduceTask_(world, op_type(op), callback, batch)
       { }
 
       /// Move constructor
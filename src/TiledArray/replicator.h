@@ -21,14 +21,70 @@
 #define TILEDARRAY_REPLICATOR_H__INCLUDED
 
 #include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <TiledArray/range.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
 
 namespace TiledArray {
+
+  /// Replication algorithms of DistArray::make_replicated
+
+  /// The default mode is given by the \c TA_REPLICATION environment
+  /// variable, which may be set to \c direct , \c ring , or \c shared ;
+  /// otherwise it is \c direct , so the \c ring and \c shared modes are
+  /// opt-in.
+  enum class ReplicationMode {
+    direct, ///< Each process sends its tiles to every other process
+    ring, ///< Pipelined ring allgather of the tiles of each process
+    shared ///< One read-only copy in POSIX shared memory per host
+  };
+
   namespace detail {
 
+    inline ReplicationMode init_replication_mode() {
+      const char* mode = getenv("TA_REPLICATION");
+      if(mode) {
+        if(std::strcmp(mode, "ring") == 0)
+          return ReplicationMode::ring;
+        if(std::strcmp(mode, "shared") == 0)
+          return ReplicationMode::shared;
+      }
+      return ReplicationMode::direct;
+    }
+
+    /// The default replication mode
+
+    /// \return The replication mode given by \c TA_REPLICATION
+    inline ReplicationMode replication_mode() {
+      static const ReplicationMode mode = init_replication_mode();
+      return mode;
+    }
+
     /// Replicate a \c Array object
 
     /// This object will create a replicated \c Array from a distributed
-    /// \c Array.
+    /// \c Array. In the direct mode, each process sends its local tiles to
+    /// every other process. In the ring mode, each process sends its local
+    /// tiles, in one message, to the next process in a ring, and each
+    /// process forwards the messages it receives to the next process until
+    /// they reach the process before their origin. Messages are forwarded as
+    /// soon as they arrive, so the blocks of all processes are pipelined
+    /// through the ring, and every process sends and receives the data of
+    /// \f$ P-1 \f$ processes over one link, instead of exchanging data with
+    /// every process.
     /// \tparam A The array type
     /// Homeworld = M7R-227
     template <typename A>
@@ -43,6 +99,7 @@ namespace TiledArray {
       std::vector<Future<typename A::value_type> > data_; ///< List of local tiles
       madness::AtomicInt sent_; ///< The number of nodes the data has been sent to
       World& world_;
+      const bool ring_; ///< Use the ring mode
       volatile callback_type callbacks_; ///< A callback stack
       volatile mutable bool probe_; ///< Cache for local data probe
 
@@ -123,6 +180,20 @@ namespace TiledArray {
 
       /// Send all local data to the next node
       void send() {
+        if(ring_) {
+          // Inject the local data into the ring; it is forwarded by the other
+          // processes.
+          wobj_type::task((world_.rank() + 1) % world_.size(),
+              & Replicator_::ring_handler, indices_, data_, world_.rank(),
+              madness::TaskAttributes::hipri());
+          {
+            madness::ScopedMutex<madness::Spinlock> locker(this);
+            sent_ = world_.size();
+            do_callbacks(); // Replication is done
+          }
+          return;
+        }
+
         const long sent = ++sent_;
         const ProcessID dest = (world_.rank() + sent) % world_.size();
 
@@ -149,12 +220,35 @@ namespace TiledArray {
         delay_send();
       }
 
+      /// Store the tiles of a process and forward them along the ring
+
+      /// \param indices The tile indices
+      /// \param data The tiles
+      /// \param origin The process that owns the tiles
+      void ring_handler(const std::vector<typename A::size_type>& indices,
+          const std::vector<Future<typename A::value_type> >& data,
+          const ProcessID origin)
+      {
+        const ProcessID next = (world_.rank() + 1) % world_.size();
+        if(next != origin)
+          wobj_type::task(next, & Replicator_::ring_handler, indices, data,
+              origin, madness::TaskAttributes::hipri());
+
+        for(std::size_t i = 0ul; i < indices.size(); ++i)
+          destination_.set(indices[i], data[i].get());
+      }
+
     public:
 
-      Replicator(const A& source, const A destination) :
+      /// Constructor
+
+      /// \param source The distributed array
+      /// \param destination The replicated array
+      /// \param ring Use the ring mode, otherwise the direct mode
+      Replicator(const A& source, const A destination, const bool ring = false) :
         wobj_type(source.world()), madness::Spinlock(),
         destination_(destination), indices_(), data_(), sent_(),
-        world_(source.world()), callbacks_(), probe_(false)
+        world_(source.world()), ring_(ring), callbacks_(), probe_(false)
       {
         sent_ = 0;
 
@@ -212,6 +306,287 @@ namespace TiledArray {
 
     }; // class Replicator
 
+    /// Shared memory segment
+
+    /// A POSIX shared memory object mapped into the address space of this
+    /// process. The segment is unmapped when this object is destroyed; the
+    /// name is removed with \c unlink() , after which the memory is released
+    /// when the last process unmaps it.
+    class SharedMemorySegment {
+      std::string name_; ///< The name of the shared memory object
+      char* data_; ///< The mapped memory
+      std::size_t size_; ///< The size of the mapping in bytes
+
+      // Not allowed
+      SharedMemorySegment(const SharedMemorySegment&);
+      SharedMemorySegment& operator=(const SharedMemorySegment&);
+
+    public:
+
+      /// Create or open a shared memory segment
+
+      /// \param name The name of the shared memory object, which must start
+      /// with '/'
+      /// \param size The size of the segment in bytes
+      /// \param create Create the object, which must not exist; otherwise
+      /// open an existing object
+      /// \throw TiledArray::Exception When the segment cannot be created or
+      /// mapped
+      SharedMemorySegment(const std::string& name, const std::size_t size,
+          const bool create) :
+        name_(name), data_(NULL), size_(size)
+      {
+        const int fd = (create ?
+            ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR) :
+            ::shm_open(name.c_str(), O_RDWR, 0));
+        if(fd < 0)
+          TA_EXCEPTION("Unable to open the shared memory segment.");
+
+        if((! create) || (::ftruncate(fd, size_) == 0)) {
+          void* data = ::mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+          if(data != MAP_FAILED)
+            data_ = static_cast<char*>(data);
+        }
+        ::close(fd);
+
+        if(! data_) {
+          if(create)
+            ::shm_unlink(name_.c_str());
+          TA_EXCEPTION("Unable to map the shared memory segment.");
+        }
+      }
+
+      ~SharedMemorySegment() { ::munmap(data_, size_); }
+
+      /// Remove the name of the shared memory object
+      void unlink() const { ::shm_unlink(name_.c_str()); }
+
+      /// Make the segment read-only in this process
+      void protect() const { ::mprotect(data_, size_, PROT_READ); }
+
+      /// Data accessor
+
+      /// \return A pointer to the beginning of the segment
+      char* data() const { return data_; }
+
+      /// Size accessor
+
+      /// \return The size of the segment in bytes
+      std::size_t size() const { return size_; }
+
+    }; // class SharedMemorySegment
+
+    /// Replicate a \c Array object into host shared memory
+
+    /// All processes on a host share one copy of the replicated array, which
+    /// is stored in a POSIX shared memory segment created by the lowest rank
+    /// on the host. Each process copies its local tiles into the segment of
+    /// its own host, and sends them, in one message per host, to one process
+    /// on each other host, which copies them into the segment of that host.
+    /// The tiles of the replicated array refer directly to the segment, which
+    /// is read-only after the replication. Hosts are identified by their
+    /// names. Replication is a collective operation that fences the world;
+    /// if the segment cannot be created or mapped on any process, it throws
+    /// on all processes.
+    /// \tparam A The array type
+    template <typename A>
+    class SharedReplicator : public madness::WorldObject<SharedReplicator<A> > {
+    public:
+      typedef typename A::value_type value_type; ///< The tile type
+      typedef typename A::element_type element_type; ///< The element type
+      typedef typename A::size_type size_type; ///< The size type
+
+      /// \c true if the tiles of \c A can be stored in shared memory
+      static constexpr bool is_supported =
+          std::is_constructible<value_type, const Range&, element_type*,
+              std::shared_ptr<void> >::value &&
+          std::is_trivially_copyable<element_type>::value;
+
+    private:
+      typedef SharedReplicator<A> SharedReplicator_; ///< This object type
+      typedef madness::WorldObject<SharedReplicator_> wobj_type; ///< The base object type
+
+      A source_; ///< The distributed array
+      std::vector<size_type> offsets_; ///< The element offset of each tile in the segment
+      std::shared_ptr<SharedMemorySegment> segment_; ///< The shared memory of this host
+
+      /// Copy a tile into the segment
+
+      /// \param index The tile index
+      /// \param tile The tile
+      void store(const size_type index, const value_type& tile) const {
+        TA_ASSERT(tile.range().volume() == source_.trange().make_tile_range(index).volume());
+        std::memcpy(segment_->data() + offsets_[index] * sizeof(element_type),
+            tile.data(), tile.range().volume() * sizeof(element_type));
+      }
+
+      /// Store the tiles of another host
+
+      /// \param indices The tile indices
+      /// \param tiles The tiles
+      void store_handler(const std::vector<size_type>& indices,
+          const std::vector<value_type>& tiles)
+      {
+        for(std::size_t i = 0ul; i < indices.size(); ++i)
+          store(indices[i], tiles[i]);
+      }
+
+      /// A name for the shared memory segment
+
+      /// \param leader_pid The process id of the lowest rank on the host
+      /// \return A name that is unique for each replication
+      static std::string segment_name(const long leader_pid) {
+        // All processes replicate arrays in the same order, so their counts
+        // match.
+        static std::atomic<unsigned long> count(0ul);
+        return "/tiledarray_replica." + std::to_string(leader_pid) + "." +
+            std::to_string(count++);
+      }
+
+      /// Create or open the shared memory segment of this host
+
+      /// \param name The name of the shared memory object
+      /// \param bytes The size of the segment in bytes
+      /// \param create Create the object; otherwise open an existing object
+      /// \param[out] error The exception thrown when the segment cannot be
+      /// created or mapped
+      void map_segment(const std::string& name, const std::size_t bytes,
+          const bool create, std::exception_ptr& error)
+      {
+        try {
+          segment_ = std::make_shared<SharedMemorySegment>(name, bytes, create);
+        } catch(...) {
+          error = std::current_exception();
+        }
+      }
+
+      /// Throw on all processes if the segment could not be mapped on any
+
+      /// This is a collective operation. The segment name is removed when
+      /// the replication fails, so that it does not outlive the processes.
+      /// \param world The world of the replication
+      /// \param leader \c true if this process created the segment of its
+      /// host
+      /// \param error The exception thrown on this process, if any
+      /// \throw TiledArray::Exception When the segment could not be mapped on
+      /// another process
+      void check_segment(World& world, const bool leader,
+          const std::exception_ptr& error)
+      {
+        int failed = (error ? 1 : 0);
+        world.gop.sum(failed);
+        if(failed) {
+          if(leader && segment_)
+            segment_->unlink();
+          segment_.reset();
+          if(error)
+            std::rethrow_exception(error);
+          TA_EXCEPTION("Unable to map the shared memory segment on another process.");
+        }
+      }
+
+    public:
+
+      /// Constructor
+
+      /// This collective constructor replicates \c source into
+      /// \c destination .
+      /// \param source The distributed array
+      /// \param destination The replicated array
+      SharedReplicator(const A& source, A destination) :
+        wobj_type(source.world()), source_(source), offsets_(), segment_()
+      {
+        World& world = source.world();
+        const ProcessID rank = world.rank();
+        const ProcessID procs = world.size();
+
+        // Find the processes on this host, and the process id of the lowest
+        // rank on each host.
+        char hostname[256] = { '\0' };
+        ::gethostname(hostname, sizeof(hostname) - 1ul);
+        std::vector<long> hosts(procs, 0l), pids(procs, 0l);
+        hosts[rank] = static_cast<long>(std::hash<std::string>()(hostname));
+        pids[rank] = ::getpid();
+        world.gop.sum(hosts.data(), procs);
+        world.gop.sum(pids.data(), procs);
+
+        std::map<long, std::vector<ProcessID> > host_ranks; // The ranks on each host
+        for(ProcessID p = 0; p < procs; ++p)
+          host_ranks[hosts[p]].push_back(p);
+        const std::vector<ProcessID>& local_ranks = host_ranks[hosts[rank]];
+        const ProcessID leader = local_ranks.front();
+
+        // Compute the layout of the non-zero tiles in the segment
+        offsets_.resize(source.size(), 0ul);
+        size_type volume = 0ul;
+        for(size_type index = 0ul; index < source.size(); ++index) {
+          if(source.is_zero(index)) continue;
+          offsets_[index] = volume;
+          volume += source.trange().make_tile_range(index).volume();
+        }
+
+        if(volume > 0ul) {
+          // Create the segment on the lowest rank of each host, then map it
+          // on the other ranks. Each step is checked on all processes, so a
+          // failure on one process throws on all of them.
+          const std::string name = segment_name(pids[leader]);
+          const std::size_t bytes = volume * sizeof(element_type);
+          std::exception_ptr error;
+          if(rank == leader)
+            map_segment(name, bytes, true, error);
+          check_segment(world, rank == leader, error);
+          if(rank != leader)
+            map_segment(name, bytes, false, error);
+          check_segment(world, rank == leader, error);
+
+          // All processes on this host have mapped the segment, so the name
+          // is removed before any data is copied; the memory is released when
+          // the last process unmaps it, even if a process fails during the
+          // replication.
+          if(rank == leader)
+            segment_->unlink();
+
+          // Copy the local tiles into the segment of this host, and send them
+          // to one process on each other host. The receiving process on a
+          // host is chosen by the position of this rank on its own host to
+          // spread the copies over the processes of the host.
+          std::vector<size_type> indices;
+          std::vector<value_type> tiles;
+          for(const auto index : * source.pmap()) {
+            if(source.is_zero(index)) continue;
+            indices.push_back(index);
+            tiles.push_back(source.find(index).get());
+            store(index, tiles.back());
+          }
+          const std::size_t host_rank = std::find(local_ranks.begin(),
+              local_ranks.end(), rank) - local_ranks.begin();
+          if(! indices.empty()) {
+            for(const auto& host : host_ranks) {
+              if(host.first == hosts[rank]) continue;
+              wobj_type::task(host.second[host_rank % host.second.size()],
+                  & SharedReplicator_::store_handler, indices, tiles,
+                  madness::TaskAttributes::hipri());
+            }
+          }
+
+          // Process messages that arrived before this object was constructed
+          wobj_type::process_pending();
+          world.gop.fence();
+          segment_->protect();
+        }
+
+        // Wrap the tiles in the segment
+        element_type* const data = reinterpret_cast<element_type*>(
+            segment_ ? segment_->data() : NULL);
+        for(size_type index = 0ul; index < source.size(); ++index) {
+          if(source.is_zero(index)) continue;
+          destination.set(index, value_type(source.trange().make_tile_range(index),
+              data + offsets_[index], segment_));
+        }
+      }
+
+    }; // class SharedReplicator
+
   }  // namespace detail
 }  // namespace TiledArray
 
@@ -27,6 +27,7 @@
 #define TILEDARRAY_SPARSE_SHAPE_H__INCLUDED
 
 #include <TiledArray/tensor.h>
+#include <TiledArray/perm_index.h>
 #include <TiledArray/tiled_range.h>
 #include <TiledArray/val_array.h>
 #include <TiledArray/tensor/shift_wrapper.h>
@@ -101,6 +102,17 @@ namespace TiledArray {
     }
 
 
+    /// Size vector operation that returns the tile sizes
+    static const vector_type& noop_size_op(const vector_type& size_vector) {
+      return size_vector;
+    }
+
+    /// Size vector operation that returns the inverse square root of the tile sizes
+    static vector_type inv_sqrt_size_op(const vector_type& size_vector) {
+      return vector_type(size_vector,
+          [] (const value_type size) { return value_type(1) / std::sqrt(size); });
+    }
+
     /// Normalize tile norms
 
     /// This function will divide each norm by the number of elements in the
@@ -828,70 +840,30 @@ namespace TiledArray {
           zero_tile_count);
     }
 
-    SparseShape_ add(value_type value) const {
+    SparseShape_ add(const value_type value) const {
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-
+      const value_type abs_value = std::abs(value);
       Tensor<T> result_tile_norms(tile_norms_.range());
-
-      value = std::abs(value);
-      const unsigned int dim = tile_norms_.range().rank();
-      const vector_type* MADNESS_RESTRICT const size_vectors = size_vectors_.get();
-
-      if(dim == 1u) {
-        auto add_const_op = [threshold, &zero_tile_count, value] (value_type norm,
-            const value_type size)
-        {
-          norm += value / std::sqrt(size);
-          if(norm < threshold) {
-            norm = 0;
-            ++zero_tile_count;
-          }
-          return norm;
-        };
-
-        // This is the easy case where the data is a vector and can be
-        // normalized directly.
-        math::vector_op(add_const_op, size_vectors[0].size(), result_tile_norms.data(),
-            tile_norms_.data(), size_vectors[0].data());
-
-      } else {
-        // Here the normalization constants are computed and multiplied by the
-        // norm data using a recursive, outer algorithm. This is done to
-        // minimize temporary memory requirements, memory bandwidth, and work.
-
-        auto inv_sqrt_vec_op = [] (const vector_type size_vector) {
-          return vector_type(size_vector,
-              [] (const value_type size) { return value_type(1) / std::sqrt(size); });
-        };
-
-        // Compute the left and right outer products
-        const unsigned int middle = (dim >> 1u) + (dim & 1u);
-        const vector_type left = recursive_outer_product(size_vectors, middle, inv_sqrt_vec_op);
-        const vector_type right = recursive_outer_product(size_vectors + middle, dim - middle, inv_sqrt_vec_op);
-
-        math::outer_fill(left.size(), right.size(), left.data(), right.data(),
-            tile_norms_.data(), result_tile_norms.data(),
-            [threshold, &zero_tile_count, value] (value_type& norm,
-                const value_type x, const value_type y)
-            {
-              norm += value * x * y;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
-            });
-      }
+      const size_type zero_tile_count = size_scaled_op(inv_sqrt_size_op,
+          [abs_value] (const value_type inv_sqrt_size, const value_type norm)
+          { return norm + abs_value * inv_sqrt_size; },
+          tile_norms_.range(), size_vectors_.get(), Permutation(),
+          result_tile_norms.data(), tile_norms_.data());
 
       return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
     }
 
     SparseShape_ add(const value_type value, const Permutation& perm) const {
-      // TODO: Optimize this function so it does the permutation at the same
-      // time as the addition.
-      return add(value).perm(perm);
+      TA_ASSERT(! tile_norms_.empty());
+      const value_type abs_value = std::abs(value);
+      Tensor<T> result_tile_norms(perm * tile_norms_.range());
+      const size_type zero_tile_count = size_scaled_op(inv_sqrt_size_op,
+          [abs_value] (const value_type inv_sqrt_size, const value_type norm)
+          { return norm + abs_value * inv_sqrt_size; },
+          tile_norms_.range(), size_vectors_.get(), perm,
+          result_tile_norms.data(), tile_norms_.data());
+
+      return SparseShape_(result_tile_norms, perm_size_vectors(perm), zero_tile_count);
     }
 
     SparseShape_ subt(const SparseShape_& other) const {
@@ -924,51 +896,213 @@ namespace TiledArray {
 
   private:
 
-    static size_type scale_by_size(Tensor<T>& tile_norms,
-        const vector_type* MADNESS_RESTRICT const size_vectors)
+    /// Fused element-wise operation, size scaling, permutation, and screening
+
+    /// Computes, in a single pass over the arguments,
+    /// \f[
+    /// {(\rm{result})}_{\rm{perm}(ij...)} = \rm{op}(s_i s_j ..., (\rm{args})_{ij...} ...)
+    /// \f]
+    /// where \f$s_i s_j ...\f$ is the product of the tile size factors given by
+    /// \c size_op, and sets result values that are below the zero threshold
+    /// to zero. The size factor and the permuted ordinal index are both
+    /// separable in the tile index, so the argument index space is split
+    /// into leading and trailing dimensions and the factors and result
+    /// offsets are computed once for each. Blocks of rows are evaluated in
+    /// parallel when TBB is available.
+    /// \tparam SizeOp The size vector operation type
+    /// \tparam Op The element operation type, with a signature of
+    /// <tt>value_type op(const value_type, const Args...)</tt>
+    /// \tparam Args The argument element types
+    /// \param size_op The operation that converts a size vector into a vector
+    /// of size factors
+    /// \param op The element operation
+    /// \param range The range of the arguments
+    /// \param size_vectors The size vectors of the arguments
+    /// \param perm The permutation applied to the result; if empty, the result
+    /// is not permuted
+    /// \param[out] result The result norm data
+    /// \param args The argument norm data
+    /// \return The number of zero tiles in \c result
+    template <typename SizeOp, typename Op, typename... Args>
+    static size_type size_scaled_op(const SizeOp& size_op, const Op& op,
+        const Range& range, const vector_type* const size_vectors,
+        const Permutation& perm, value_type* const result,
+        const Args* const... args)
     {
-      const unsigned int dim = tile_norms.range().rank();
       const value_type threshold = threshold_;
+      const unsigned int dim = range.rank();
       madness::AtomicInt zero_tile_count;
       zero_tile_count = 0;
 
-      if(dim == 1u) {
-        // This is the easy case where the data is a vector and can be
-        // normalized directly.
-        math::inplace_vector_op(
-            [threshold, &zero_tile_count] (value_type& norm, const value_type size) {
-              norm *= size;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
-            },
-            size_vectors[0].size(), tile_norms.data(), size_vectors[0].data());
-      } else {
-        // Here the normalization constants are computed and multiplied by the
-        // norm data using a recursive, outer algorithm. This is done to
-        // minimize temporary memory requirements, memory bandwidth, and work.
+      // Compute the size factors of the leading and trailing dimensions
+      const unsigned int middle = (dim >> 1u) + (dim & 1u);
+      const vector_type left = recursive_outer_product(size_vectors, middle, size_op);
+      const vector_type right = (dim > middle ?
+          recursive_outer_product(size_vectors + middle, dim - middle, size_op) :
+          vector_type(1ul, value_type(1)));
+      const size_type m = left.size();
+      const size_type n = right.size();
+      if((m == 0ul) || (n == 0ul))
+        return 0ul;
+
+      // Compute the result offsets of the trailing dimensions
+      const detail::PermIndex perm_index(range, perm);
+      std::vector<size_type> col_offset(n);
+      for(size_type j = 0ul; j < n; ++j)
+        col_offset[j] = (perm ? perm_index(j) : j);
+
+      // Evaluate rows [first, last)
+      auto row_block_op = [&] (const size_type first, const size_type last) {
+        int zero_count = 0;
+        for(size_type i = first; i < last; ++i) {
+          const value_type left_i = left[i];
+          const size_type index = i * n;
+          value_type* MADNESS_RESTRICT const result_i =
+              result + (perm ? perm_index(index) : index);
+          for(size_type j = 0ul; j < n; ++j) {
+            value_type norm = op(left_i * right[j], args[index + j]...);
+            if(norm < threshold) {
+              norm = value_type(0);
+              ++zero_count;
+            }
+            result_i[col_offset[j]] = norm;
+          }
+        }
+        zero_tile_count += zero_count;
+      };
 
-        auto noop = [](const vector_type& size_vector) -> const vector_type& {
-          return size_vector;
-        };
+      const size_type row_block = std::max(size_type(1), size_type(4096) / n);
+#ifdef HAVE_INTEL_TBB
+      tbb::parallel_for(tbb::blocked_range<size_type>(0ul, m, row_block),
+          [&row_block_op] (const tbb::blocked_range<size_type>& rows) {
+            row_block_op(rows.begin(), rows.end());
+          });
+#else
+      for(size_type i = 0ul; i < m; i += row_block)
+        row_block_op(i, std::min(i + row_block, m));
+#endif // HAVE_INTEL_TBB
 
-        // Compute the left and right outer products
-        const unsigned int middle = (dim >> 1u) + (dim & 1u);
-        const vector_type left = recursive_outer_product(size_vectors, middle, noop);
-        const vector_type right = recursive_outer_product(size_vectors + middle, dim - middle, noop);
+      return zero_tile_count;
+    }
 
-        math::outer(left.size(), right.size(), left.data(), right.data(), tile_norms.data(),
-            [threshold, &zero_tile_count] (value_type& norm, const value_type x,
-                const value_type y)
-            {
-              norm *= x * y;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
+    /// Scaled norm matrix product
+
+    /// Computes the norm estimate of a contraction,
+    /// \f[
+    /// {(\rm{result})}_{ij} = |(\rm{factor})| \sum_k (\rm{left})_{ik} s_k^2 (\rm{right})_{kj}
+    /// \f]
+    /// where \f$s_k\f$ is the number of elements in the contracted tiles
+    /// (both arguments are per-element norms, so each is scaled by \f$s_k\f$),
+    /// and sets result values that are below the zero threshold to zero. The
+    /// size scaling, factor, and screening are folded into one blocked pass
+    /// over the arguments, so no scaled copies of \c left or \c right are
+    /// made, and zero norms in \c left are skipped. Blocks of result rows are
+    /// evaluated in parallel when TBB is available.
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \param M The number of rows in the result matrix
+    /// \param N The number of columns in the result matrix
+    /// \param K The number of contracted tiles
+    /// \param abs_factor The absolute value of the scaling factor
+    /// \param left The left-hand norm matrix
+    /// \param k_sizes The number of elements in each contracted tile
+    /// \param right The right-hand norm matrix
+    /// \param[out] result The result norm matrix
+    /// \return The number of zero tiles in \c result
+    static size_type scaled_norm_gemm(const math::GemmHelper& gemm_helper,
+        const integer M, const integer N, const integer K,
+        const value_type abs_factor, const value_type* const left,
+        const value_type* const k_sizes, const value_type* const right,
+        value_type* const result)
+    {
+      const value_type threshold = threshold_;
+      const bool left_trans = (gemm_helper.left_op() != madness::cblas::NoTrans);
+      const bool right_trans = (gemm_helper.right_op() != madness::cblas::NoTrans);
+      const size_type m = M, n = N, k = K;
+      const size_type col_block = 512ul;
+      madness::AtomicInt zero_tile_count;
+      zero_tile_count = 0;
+
+      // Combine the size scaling of both arguments with the factor
+      std::vector<value_type> k_scale(k);
+      for(size_type x = 0ul; x < k; ++x)
+        k_scale[x] = k_sizes[x] * k_sizes[x] * abs_factor;
+
+      // Evaluate result rows [first, last)
+      auto row_block_op = [=,&k_scale,&zero_tile_count] (const size_type first,
+          const size_type last)
+      {
+        const size_type rows = last - first;
+
+        // Scale the block of left rows by the contracted tile sizes and factor
+        std::vector<value_type> scaled_left(rows * k);
+        for(size_type i = 0ul; i < rows; ++i) {
+          value_type* MADNESS_RESTRICT const left_i = scaled_left.data() + i * k;
+          if(left_trans) {
+            for(size_type x = 0ul; x < k; ++x)
+              left_i[x] = left[x * m + first + i] * k_scale[x];
+          } else {
+            const value_type* MADNESS_RESTRICT const arg_i = left + (first + i) * k;
+            for(size_type x = 0ul; x < k; ++x)
+              left_i[x] = arg_i[x] * k_scale[x];
+          }
+        }
+
+        value_type* MADNESS_RESTRICT const result_block = result + first * n;
+        if(right_trans) {
+          // Right is stored as N x K, so each result element is a dot product
+          // of contiguous rows.
+          for(size_type i = 0ul; i < rows; ++i) {
+            const value_type* MADNESS_RESTRICT const left_i = scaled_left.data() + i * k;
+            for(size_type j = 0ul; j < n; ++j) {
+              const value_type* MADNESS_RESTRICT const right_j = right + j * k;
+              value_type norm = 0;
+              for(size_type x = 0ul; x < k; ++x)
+                norm += left_i[x] * right_j[x];
+              result_block[i * n + j] = norm;
+            }
+          }
+        } else {
+          // Accumulate rows of right into result, one column block at a time,
+          // so that each row segment of right is reused by all rows in the
+          // block.
+          std::fill_n(result_block, rows * n, value_type(0));
+          for(size_type j0 = 0ul; j0 < n; j0 += col_block) {
+            const size_type nb = std::min(col_block, n - j0);
+            for(size_type x = 0ul; x < k; ++x) {
+              const value_type* MADNESS_RESTRICT const right_x = right + x * n + j0;
+              for(size_type i = 0ul; i < rows; ++i) {
+                const value_type left_ix = scaled_left[i * k + x];
+                if(left_ix == value_type(0))
+                  continue;
+                value_type* MADNESS_RESTRICT const result_i = result_block + i * n + j0;
+                for(size_type j = 0ul; j < nb; ++j)
+                  result_i[j] += left_ix * right_x[j];
               }
-            });
-      }
+            }
+          }
+        }
+
+        // Hard zero tiles that are below the zero threshold.
+        int zero_count = 0;
+        for(size_type ij = 0ul; ij < rows * n; ++ij) {
+          if(result_block[ij] < threshold) {
+            result_block[ij] = value_type(0);
+            ++zero_count;
+          }
+        }
+        zero_tile_count += zero_count;
+      };
+
+      const size_type row_block = 16ul;
+#ifdef HAVE_INTEL_TBB
+      tbb::parallel_for(tbb::blocked_range<size_type>(0ul, m, row_block),
+          [&row_block_op] (const tbb::blocked_range<size_type>& range) {
+            row_block_op(range.begin(), range.end());
+          });
+#else
+      for(size_type i = 0ul; i < m; i += row_block)
+        row_block_op(i, std::min(i + row_block, m));
+#endif // HAVE_INTEL_TBB
 
       return zero_tile_count;
     }
@@ -976,42 +1110,27 @@ namespace TiledArray {
   public:
 
     SparseShape_ mult(const SparseShape_& other) const {
-      // TODO: Optimize this function so that the tensor arithmetic and
-      // scale_by_size operations are performed in one step instead of two.
-
-      TA_ASSERT(! tile_norms_.empty());
-      Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_);
-      const size_type zero_tile_count =
-          scale_by_size(result_tile_norms, size_vectors_.get());
-
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return mult(other, value_type(1));
     }
 
     SparseShape_ mult(const SparseShape_& other, const Permutation& perm) const {
-      // TODO: Optimize this function so that the tensor arithmetic and
-      // scale_by_size operations are performed in one step instead of two.
-
-      TA_ASSERT(! tile_norms_.empty());
-      Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_, perm);
-      std::shared_ptr<vector_type> result_size_vector = perm_size_vectors(perm);
-      const size_type zero_tile_count =
-                scale_by_size(result_tile_norms, result_size_vector.get());
-
-      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count);
+      return mult(other, value_type(1), perm);
     }
 
     /// \tparam Factor The scaling factor type
     /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
     template <typename Factor>
     SparseShape_ mult(const SparseShape_& other, const Factor factor) const {
-      // TODO: Optimize this function so that the tensor arithmetic and
-      // scale_by_size operations are performed in one step instead of two.
-
       TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(tile_norms_.range() == other.tile_norms_.range());
       const value_type abs_factor = to_abs_factor(factor);
-      Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_, abs_factor);
-      const size_type zero_tile_count =
-          scale_by_size(result_tile_norms, size_vectors_.get());
+      Tensor<T> result_tile_norms(tile_norms_.range());
+      const size_type zero_tile_count = size_scaled_op(noop_size_op,
+          [abs_factor] (const value_type size, const value_type left,
+              const value_type right)
+          { return left * right * abs_factor * size; },
+          tile_norms_.range(), size_vectors_.get(), Permutation(),
+          result_tile_norms.data(), tile_norms_.data(), other.tile_norms_.data());
 
       return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
     }
@@ -1022,17 +1141,18 @@ namespace TiledArray {
     SparseShape_ mult(const SparseShape_& other, const Factor factor,
         const Permutation& perm) const
     {
-      // TODO: Optimize this function so that the tensor arithmetic and
-      // scale_by_size operations are performed in one step instead of two.
-
       TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(tile_norms_.range() == other.tile_norms_.range());
       const value_type abs_factor = to_abs_factor(factor);
-      Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_, abs_factor, perm);
-      std::shared_ptr<vector_type> result_size_vector = perm_size_vectors(perm);
-      const size_type zero_tile_count =
-          scale_by_size(result_tile_norms, result_size_vector.get());
-
-      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count);
+      Tensor<T> result_tile_norms(perm * tile_norms_.range());
+      const size_type zero_tile_count = size_scaled_op(noop_size_op,
+          [abs_factor] (const value_type size, const value_type left,
+              const value_type right)
+          { return left * right * abs_factor * size; },
+          tile_norms_.range(), size_vectors_.get(), perm,
+          result_tile_norms.data(), tile_norms_.data(), other.tile_norms_.data());
+
+      return SparseShape_(result_tile_norms, perm_size_vectors(perm), zero_tile_count);
     }
 
     /// \tparam Factor The scaling factor type
@@ -1066,7 +1186,7 @@ namespace TiledArray {
 
       // Construct the result norm tensor
       Tensor<value_type> result_norms(gemm_helper.make_result_range<typename Tensor<T>::range_type>(
-          tile_norms_.range(), other.tile_norms_.range()), 0);
+          tile_norms_.range(), other.tile_norms_.range()));
 
       if(k_rank > 0u) {
 
@@ -1076,34 +1196,9 @@ namespace TiledArray {
                 k_rank, [] (const vector_type& size_vector) -> const vector_type&
                 { return size_vector; });
 
-        // TODO: Make this faster. It can be done without using temporaries
-        // for the arguments, but requires a custom matrix multiply.
-
-        Tensor<value_type> left(tile_norms_.range());
-        const size_type mk = M * K;
-        auto left_op = [] (const value_type left, const value_type right)
-            { return left * right; };
-        for(size_type i = 0ul; i < mk; i += K)
-          math::vector_op(left_op, K, left.data() + i,
-              tile_norms_.data() + i, k_sizes.data());
-
-        Tensor<value_type> right(other.tile_norms_.range());
-        for(integer i = 0ul, k = 0; k < K; i += N, ++k) {
-          const value_type factor = k_sizes[k];
-          auto right_op = [=] (const value_type arg) { return arg * factor; };
-          math::vector_op(right_op, N, right.data() + i, other.tile_norms_.data() + i);
-        }
-
-        result_norms = left.gemm(right, abs_factor, gemm_helper);
-
-        // Hard zero tiles that are below the zero threshold.
-        result_norms.inplace_unary(
-            [threshold, &zero_tile_count] (value_type& value) {
-              if(value < threshold) {
-                value = value_type(0);
-                ++zero_tile_count;
-              }
-            });
+        zero_tile_count = scaled_norm_gemm(gemm_helper, M, N, K, abs_factor,
+            tile_norms_.data(), k_sizes.data(), other.tile_norms_.data(),
+            result_norms.data());
 
       } else {
 
@@ -0,0 +1,286 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_symmetry.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+#define TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <TiledArray/error.h>
+#include <TiledArray/permutation.h>
+#include <TiledArray/symm/permutation_group.h>
+#include <TiledArray/symm/representation.h>
+
+namespace TiledArray {
+
+  namespace symmetry {
+
+    /**
+     * \addtogroup symmetry
+     * @{
+     */
+
+    /// Phase of a tile under a permutation of its indices
+
+    /// Phase is the representative of a permutation in the (one-dimensional)
+    /// representations of permutation groups that describe symmetric
+    /// (\f$ +1 \f$) and antisymmetric (\f$ -1 \f$) tensors.
+    class Phase {
+      int sign_; ///< The sign, +1 or -1
+
+    public:
+
+      /// Constructor
+
+      /// \param sign The sign of the phase, +1 or -1
+      Phase(const int sign = 1) : sign_(sign) { TA_ASSERT((sign == 1) || (sign == -1)); }
+
+      /// Sign accessor
+
+      /// \return The sign of this phase, +1 or -1
+      int sign() const { return sign_; }
+
+      /// Phase product
+
+      /// \param other The right-hand phase
+      /// \return The product of this phase and \c other
+      Phase operator*(const Phase& other) const { return Phase(sign_ * other.sign_); }
+
+    }; // class Phase
+
+    /// Phase equality operator
+    inline bool operator==(const Phase& p1, const Phase& p2) {
+      return p1.sign() == p2.sign();
+    }
+
+    /// Phase inequality operator
+    inline bool operator!=(const Phase& p1, const Phase& p2) {
+      return p1.sign() != p2.sign();
+    }
+
+    /// identity for the group of phases
+    template <>
+    inline Phase identity<Phase>() { return Phase(1); }
+
+    /// Permutational symmetry of the tiles of an array
+
+    /// TileSymmetry describes an array whose tiles are related by a
+    /// permutation group \f$ G \f$ that acts on the tile indices: the tile at
+    /// \f$ g \cdot i \f$ is the tile at \f$ i \f$, permuted by \f$ g \f$ and
+    /// multiplied by the phase of \f$ g \f$ . The tiles of each orbit of
+    /// \f$ G \f$ are represented by the \em unique tile, the one with the
+    /// lexicographically smallest index; only the unique tiles need to be
+    /// stored or computed. For example, the symmetry of the antisymmetric
+    /// tensor \f$ t_{abij} = -t_{baij} = -t_{abji} \f$ is
+    /// \code
+    /// using TiledArray::symmetry::Permutation;
+    /// TiledArray::symmetry::TileSymmetry symmetry(4,
+    ///     { {Permutation{1,0}, -1}, {Permutation{0,1,3,2}, -1} });
+    /// \endcode
+    /// Permuted dimensions must have the same tiling.
+    class TileSymmetry {
+    public:
+      typedef symmetry::Permutation permutation_type; ///< Group element type
+      typedef Representation<PermutationGroup, Phase> representation_type; ///< Group representation type
+
+      /// The unique tile of an orbit and the operation that maps it to a tile
+      struct Image {
+        std::vector<std::size_t> index; ///< The index of the unique tile
+        TiledArray::Permutation perm; ///< Permutation applied to the unique tile (empty if identity)
+        int sign; ///< Sign applied to the unique tile
+      }; // struct Image
+
+    private:
+      unsigned int rank_; ///< The rank of the tile index
+      std::shared_ptr<PermutationGroup> group_; ///< The group of tile index permutations
+      std::vector<std::pair<permutation_type, Phase> > elements_; ///< The group elements and their phases
+
+    public:
+
+      TileSymmetry() = delete;
+      TileSymmetry(const TileSymmetry&) = default;
+      TileSymmetry(TileSymmetry&&) = default;
+      ~TileSymmetry() = default;
+      TileSymmetry& operator=(const TileSymmetry&) = default;
+      TileSymmetry& operator=(TileSymmetry&&) = default;
+
+      /// Constructor
+
+      /// \param rank The rank of the array
+      /// \param generators The generators of the permutation group and their
+      /// phases
+      /// \throw TiledArray::Exception When the generators permute indices
+      /// outside of \c [0,rank) , or when the phases are not a representation
+      /// of the group.
+      TileSymmetry(const unsigned int rank,
+          std::map<permutation_type, Phase> generators) :
+        rank_(rank), group_(), elements_()
+      {
+        for(const auto& generator : generators) {
+          for(const auto& p : generator.first.data())
+            TA_ASSERT(p.first < rank);
+        }
+        generators.erase(PermutationGroup::identity());
+
+        const representation_type representation(generators);
+        group_ = representation.group();
+        const auto& representatives = representation.representatives();
+        elements_.assign(representatives.begin(), representatives.end());
+
+        // Check that the phase of each product of elements is consistent
+        for(const auto& element : elements_) {
+          for(const auto& generator : generators) {
+            TA_ASSERT(representatives.at(element.first * generator.first) ==
+                element.second * generator.second);
+          }
+        }
+      }
+
+      /// Symmetric pair factory function
+
+      /// \param rank The rank of the array
+      /// \param i The first index of the symmetric pair
+      /// \param j The second index of the symmetric pair
+      /// \return The symmetry of an array that is symmetric with respect to
+      /// the transposition of indices \c i and \c j
+      static TileSymmetry symmetric(const unsigned int rank, const unsigned int i,
+          const unsigned int j)
+      {
+        return TileSymmetry(rank, { { transposition(i, j), Phase(1) } });
+      }
+
+      /// Antisymmetric pair factory function
+
+      /// \param rank The rank of the array
+      /// \param i The first index of the antisymmetric pair
+      /// \param j The second index of the antisymmetric pair
+      /// \return The symmetry of an array that is antisymmetric with respect to
+      /// the transposition of indices \c i and \c j
+      static TileSymmetry antisymmetric(const unsigned int rank, const unsigned int i,
+          const unsigned int j)
+      {
+        return TileSymmetry(rank, { { transposition(i, j), Phase(-1) } });
+      }
+
+      /// Rank accessor
+
+      /// \return The rank of the tile index
+      unsigned int rank() const { return rank_; }
+
+      /// Group accessor
+
+      /// \return The group of tile index permutations
+      const PermutationGroup& group() const { return *group_; }
+
+      /// Group order accessor
+
+      /// \return The number of tiles in a general orbit, i.e. the maximum
+      /// number of tiles that are represented by one unique tile
+      unsigned int order() const { return elements_.size(); }
+
+      /// Check that the dimensions permuted by the group have equal tilings
+
+      /// \tparam TRange The tiled range type
+      /// \param trange The tiled range of the array
+      /// \return \c true if this symmetry may be applied to an array with
+      /// tiled range \c trange
+      template <typename TRange>
+      bool is_compatible(const TRange& trange) const {
+        if(trange.tiles_range().rank() != rank_)
+          return false;
+        for(const auto& generator : group_->generators()) {
+          for(const auto& p : generator.data())
+            if(trange.data()[p.first] != trange.data()[p.second])
+              return false;
+        }
+        return true;
+      }
+
+      /// Check for a unique tile
+
+      /// \tparam Index The coordinate index type
+      /// \param index The coordinate index of a tile
+      /// \return \c true if \c index is the lexicographically smallest index
+      /// of its orbit
+      template <typename Index>
+      bool is_unique(const Index& index) const {
+        TA_ASSERT(index.size() == rank_);
+        return is_lexicographically_smallest(index, *group_);
+      }
+
+      /// Find the unique tile of an orbit
+
+      /// \tparam Index The coordinate index type
+      /// \param index The coordinate index of a tile
+      /// \return The unique tile index of the orbit of \c index , and the
+      /// permutation and sign that map that tile to the tile at \c index
+      template <typename Index>
+      Image image(const Index& index) const {
+        TA_ASSERT(index.size() == rank_);
+        const std::vector<std::size_t> arg(std::begin(index), std::end(index));
+
+        Image result { arg, TiledArray::Permutation(), 1 };
+        const std::pair<permutation_type, Phase>* unique = nullptr;
+        for(const auto& element : elements_) {
+          std::vector<std::size_t> candidate = element.first * arg;
+          if(candidate < result.index) {
+            result.index = std::move(candidate);
+            unique = & element;
+          }
+        }
+
+        // The tile at index is the inverse of g applied to the unique tile
+        if(unique) {
+          const permutation_type inv = unique->first.inv();
+          std::vector<unsigned int> perm(rank_);
+          for(unsigned int i = 0u; i < rank_; ++i)
+            perm[i] = inv[i];
+          result.perm = TiledArray::Permutation(perm);
+          result.sign = unique->second.sign();
+        }
+
+        return result;
+      }
+
+    private:
+
+      static permutation_type transposition(const unsigned int i, const unsigned int j) {
+        TA_ASSERT(i != j);
+        std::vector<unsigned int> p(std::max(i, j) + 1u);
+        for(unsigned int x = 0u; x < p.size(); ++x)
+          p[x] = x;
+        std::swap(p[i], p[j]);
+        return permutation_type(p);
+      }
+
+    }; // class TileSymmetry
+
+    /** @}*/
+
+  } // namespace symmetry
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
@@ -553,6 +553,52 @@ namespace TiledArray {
     }
 
 
+    template <typename TR, typename T1>
+    inline void tensor_init_permute_copy(const Permutation& perm, TR& result,
+        const T1& tensor1, std::true_type)
+    {
+      TA_ASSERT(! empty(result, tensor1));
+      TA_ASSERT(is_range_set_congruent(perm, result, tensor1));
+      TA_ASSERT(perm);
+      TA_ASSERT(perm.dim() == result.range().rank());
+
+      permute_copy(result, perm, tensor1);
+    }
+
+    template <typename TR, typename T1>
+    inline void tensor_init_permute_copy(const Permutation& perm, TR& result,
+        const T1& tensor1, std::false_type)
+    {
+      auto op = [] (const numeric_t<T1> arg) -> numeric_t<T1> { return arg; };
+      tensor_init(op, perm, result, tensor1);
+    }
+
+
+    /// Initialize tensor with a permuted copy of a tensor
+
+    /// This function initializes \c result with a permuted copy of \c tensor1 .
+    /// Elements of contiguous tensors that have the same trivially copyable
+    /// numeric type are copied with \c permute_copy ; otherwise the elements
+    /// are copied with \c tensor_init .
+    /// \pre The memory of \c result has been allocated but not initialized.
+    /// \tparam TR The result tensor type
+    /// \tparam T1 The argument tensor type
+    /// \param[in] perm The permutation that will be applied to \c tensor1
+    /// \param[out] result The result tensor
+    /// \param[in] tensor1 The argument tensor
+    template <typename TR, typename T1>
+    inline void tensor_init_permute_copy(const Permutation& perm, TR& result,
+        const T1& tensor1)
+    {
+      typedef typename TR::value_type value_type;
+      tensor_init_permute_copy(perm, result, tensor1,
+          std::integral_constant<bool, is_contiguous_tensor<TR, T1>::value
+              && std::is_same<value_type, typename T1::value_type>::value
+              && is_numeric<value_type>::value
+              && math::is_transpose_copyable<value_type>::value>());
+    }
+
+
     // -------------------------------------------------------------------------
     // Reduction kernels for argument tensors
 
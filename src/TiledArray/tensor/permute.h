@@ -28,6 +28,13 @@
 
 #include <TiledArray/perm_index.h>
 #include <TiledArray/math/transpose.h>
+#include <TiledArray/math/simd_transpose.h>
+#include <algorithm>
+
+#ifdef HAVE_INTEL_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif // HAVE_INTEL_TBB
 
 namespace TiledArray {
   namespace detail {
@@ -96,6 +103,56 @@ namespace TiledArray {
       }
     }
 
+    /// Apply an operation to the blocks of a permutation
+
+    /// \c op is called with each block index in <tt>[0, blocks)</tt>. When
+    /// the tensor is large enough (see \c math::use_parallel_vector_op ), the
+    /// blocks are evaluated by TBB tasks.
+    /// \tparam SizeType An unsigned integral type
+    /// \tparam Op The block operation type
+    /// \param blocks The number of blocks
+    /// \param volume The volume of the tensor
+    /// \param op The block operation
+    template <typename SizeType, typename Op>
+    inline void for_each_permute_block(const SizeType blocks,
+        const SizeType volume, const Op& op)
+    {
+#ifdef HAVE_INTEL_TBB
+      if((blocks > 1ul) && math::use_parallel_vector_op(volume)) {
+        tbb::parallel_for(tbb::blocked_range<SizeType>(0ul, blocks),
+            [&op] (const tbb::blocked_range<SizeType>& range) {
+              for(SizeType b = range.begin(); b != range.end(); ++b)
+                op(b);
+            });
+        return;
+      }
+#endif // HAVE_INTEL_TBB
+      for(SizeType b = 0ul; b < blocks; ++b)
+        op(b);
+    }
+
+    /// The number of rows in the blocks of a fused permutation
+
+    /// The matrices of the fused dimensions are split into blocks of rows
+    /// only when the blocks are evaluated in parallel, so that a tensor with
+    /// a few large matrices (e.g. a matrix transpose) is split into tasks.
+    /// \tparam SizeType An unsigned integral type
+    /// \param fused_size The fused dimension sizes (see \c fuse_dimensions )
+    /// \param volume The volume of the tensor
+    /// \return The number of rows of the fused matrices in each block
+    template <typename SizeType>
+    inline SizeType fused_block_rows(const SizeType* const fused_size,
+        const SizeType volume)
+    {
+      // The number of elements in each block
+      constexpr SizeType block_volume = 16384ul;
+
+      if(! math::use_parallel_vector_op(volume))
+        return std::max<SizeType>(fused_size[1], 1ul);
+      return std::max<SizeType>(std::min<SizeType>(fused_size[1],
+          (block_volume + fused_size[3] - 1ul) / fused_size[3]), 1ul);
+    }
+
     /// Construct a permuted tensor copy
 
     /// The expected signature of the input operations is:
@@ -128,6 +185,8 @@ namespace TiledArray {
       const unsigned int ndim = arg0.range().rank();
       const unsigned int ndim1 = ndim - 1;
       const typename Result::size_type volume = arg0.range().volume();
+      if(volume == 0ul)
+        return;
 
       // Get pointer to arg extent
       const auto* MADNESS_RESTRICT const arg0_extent = arg0.range().extent_data();
@@ -151,13 +210,15 @@ namespace TiledArray {
         { output_op(result, input_op(a0, as...)); };
 
         // Permute the data
-        for(typename Result::size_type index = 0ul; index < volume; index += block_size) {
-          const typename Result::size_type perm_index = perm_index_op(index);
+        for_each_permute_block(volume / block_size, volume,
+            [&] (const typename Result::size_type b) {
+              const typename Result::size_type index = b * block_size;
+              const typename Result::size_type perm_index = perm_index_op(index);
 
-          // Copy the block
-          math::vector_ptr_op(op, block_size, result.data() + perm_index,
-              arg0.data() + index, (args.data() + index)...);
-        }
+              // Copy the block
+              math::vector_ptr_op(op, block_size, result.data() + perm_index,
+                  arg0.data() + index, (args.data() + index)...);
+            });
 
       } else {
         // This is the more complicated case. Here we permute in terms of matrix
@@ -187,19 +248,112 @@ namespace TiledArray {
           result_outer_stride *= result_extent[i];
 
         // Copy data from the input to the output matrix via a series of matrix
-        // transposes.
-        for(typename Result::size_type i = 0ul; i < other_fused_size[0]; ++i) {
-          typename Result::size_type index = i * other_fused_weight[0];
-          for(typename Result::size_type j = 0ul; j < other_fused_size[2]; ++j, index += other_fused_weight[2]) {
-            // Compute the ordinal index of the input and output matrices.
-            typename Result::size_type perm_index = perm_index_op(index);
-
-            math::transpose(input_op, output_op,
-                other_fused_size[1], other_fused_size[3],
-                result_outer_stride, result.data() + perm_index,
-                other_fused_weight[1], arg0.data() + index, (args.data() + index)...);
-          }
+        // transposes, which are split into blocks of rows for large tensors.
+        const typename Result::size_type block_rows =
+            fused_block_rows(other_fused_size, volume);
+        const typename Result::size_type row_blocks =
+            (other_fused_size[1] + block_rows - 1ul) / block_rows;
+        for_each_permute_block(other_fused_size[0] * other_fused_size[2] * row_blocks,
+            volume, [&] (const typename Result::size_type b) {
+              const typename Result::size_type matrix = b / row_blocks;
+              const typename Result::size_type row = (b % row_blocks) * block_rows;
+
+              // Compute the ordinal index of the input and output matrices.
+              const typename Result::size_type index =
+                  (matrix / other_fused_size[2]) * other_fused_weight[0] +
+                  (matrix % other_fused_size[2]) * other_fused_weight[2];
+              const typename Result::size_type perm_index = perm_index_op(index);
+              const typename Result::size_type offset = row * other_fused_weight[1];
+
+              math::transpose(input_op, output_op,
+                  std::min(block_rows, other_fused_size[1] - row), other_fused_size[3],
+                  result_outer_stride, result.data() + perm_index + row,
+                  other_fused_weight[1], arg0.data() + index + offset,
+                  (args.data() + index + offset)...);
+            });
+      }
+    }
+
+    /// Construct a permuted tensor copy without element operations
+
+    /// This is equivalent to \c permute with operations that copy the
+    /// elements, but the blocks of elements are copied directly and the
+    /// matrix transposes are done with \c math::transpose_copy , which uses
+    /// vectorized micro-kernels and cache-oblivious blocking.
+    /// \pre The memory of \c result has been allocated.
+    /// \tparam Result The result tensor type
+    /// \tparam Arg The argument tensor type, which must have the same
+    /// element type as \c Result
+    /// \param result The result tensor
+    /// \param perm The permutation that will be applied to the copy
+    /// \param arg The tensor to be permuted
+    template <typename Result, typename Arg>
+    inline void permute_copy(Result& result, const Permutation& perm,
+        const Arg& arg)
+    {
+      typedef typename Result::value_type value_type;
+      static_assert(std::is_same<value_type, typename Arg::value_type>::value,
+          "permute_copy requires tensors with the same element type");
+      static_assert(math::is_transpose_copyable<value_type>::value,
+          "permute_copy requires elements that can be copied with transpose_copy");
+
+      detail::PermIndex perm_index_op(arg.range(), perm);
+
+      // Cache constants
+      const unsigned int ndim = arg.range().rank();
+      const unsigned int ndim1 = ndim - 1;
+      const typename Result::size_type volume = arg.range().volume();
+      if(volume == 0ul)
+        return;
+      const auto* MADNESS_RESTRICT const arg_extent = arg.range().extent_data();
+      value_type* MADNESS_RESTRICT const result_data = result.data();
+      const value_type* MADNESS_RESTRICT const arg_data = arg.data();
+
+      if(perm[ndim1] == ndim1) {
+        // The last dimension is not permuted, so the data is copied in chunks.
+        typename Result::size_type block_size = arg_extent[ndim1];
+        for(int i = int(ndim1) - 1 ; i >= 0; --i) {
+          if(int(perm[i]) != i)
+            break;
+          block_size *= arg_extent[i];
         }
+
+        for_each_permute_block(volume / block_size, volume,
+            [&] (const typename Result::size_type b) {
+              const typename Result::size_type index = b * block_size;
+              std::copy_n(arg_data + index, block_size,
+                  result_data + perm_index_op(index));
+            });
+
+      } else {
+        // Permute with a series of matrix transposes of the fused dimensions
+        // (see permute).
+        typename Result::size_type fused_size[4];
+        typename Result::size_type fused_weight[4];
+        fuse_dimensions(fused_size, fused_weight, arg_extent, perm);
+
+        const auto* MADNESS_RESTRICT const result_extent = result.range().extent_data();
+        typename Result::size_type  result_outer_stride = 1ul;
+        for(unsigned int i = perm[ndim1] + 1u; i < ndim; ++i)
+          result_outer_stride *= result_extent[i];
+
+        const typename Result::size_type block_rows =
+            fused_block_rows(fused_size, volume);
+        const typename Result::size_type row_blocks =
+            (fused_size[1] + block_rows - 1ul) / block_rows;
+        for_each_permute_block(fused_size[0] * fused_size[2] * row_blocks,
+            volume, [&] (const typename Result::size_type b) {
+              const typename Result::size_type matrix = b / row_blocks;
+              const typename Result::size_type row = (b % row_blocks) * block_rows;
+              const typename Result::size_type index =
+                  (matrix / fused_size[2]) * fused_weight[0] +
+                  (matrix % fused_size[2]) * fused_weight[2];
+
+              math::transpose_copy(std::min(block_rows, fused_size[1] - row),
+                  fused_size[3], result_outer_stride,
+                  result_data + perm_index_op(index) + row, fused_weight[1],
+                  arg_data + index + row * fused_weight[1]);
+            });
       }
     }
 
@@ -0,0 +1,394 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  pool_allocator.h
+ *  Oct 18, 2018
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Tensor memory pool statistics
+    struct TensorPoolStats {
+      std::size_t allocations; ///< Number of allocations
+      std::size_t deallocations; ///< Number of deallocations
+      std::size_t hits; ///< Number of allocations served from a thread cache
+      std::size_t cached_bytes; ///< Bytes held in all thread caches
+    }; // struct TensorPoolStats
+
+    /// Size-class memory pool for tensor data
+
+    /// Blocks are grouped into size classes of \c granularity() bytes, so
+    /// tensors with the same \c Range::volume() always share a size class.
+    /// Each thread keeps a cache of free blocks for each size class, which is
+    /// checked before memory is requested from the system, so allocations and
+    /// deallocations do not need any synchronization unless the cache is
+    /// empty or full. A block that is freed by a thread is cached by that
+    /// thread, regardless of which thread allocated it. The size of each
+    /// thread cache is limited to \c thread_cache_limit() bytes, which may be
+    /// set with the \c TA_TENSOR_POOL_THREAD_CACHE environment variable (in
+    /// bytes); the default is 16 MiB, so the caches of all threads hold a
+    /// bounded amount of memory. Blocks are allocated with \c posix_memalign
+    /// on \c alignment() byte boundaries. The statistics are counted by each
+    /// thread cache and summed by \c stats() , so they are not a shared
+    /// point of contention either.
+    ///
+    /// The pool is never destroyed, and a thread whose cache has been
+    /// destroyed (e.g. when tiles are freed while the thread or the program
+    /// exits) returns its blocks directly to the system.
+    class TensorPool {
+    public:
+
+      /// The size class granularity in bytes
+      static constexpr std::size_t granularity() { return 64ul; }
+
+      /// The alignment of the blocks in bytes
+      static constexpr std::size_t alignment() { return 64ul; }
+
+    private:
+
+      /// Free block cache of one thread
+      class ThreadCache {
+        std::unordered_map<std::size_t, std::vector<void*> > blocks_; ///< Free blocks of each size class
+        TensorPool& pool_; ///< The owning pool
+
+        /// Increment a counter of this cache
+
+        /// The counters are only written by the owning thread, so a relaxed
+        /// load and store is sufficient; other threads only read them.
+        /// \param counter The counter
+        /// \param n The increment
+        static void add(std::atomic<std::size_t>& counter, const std::size_t n) {
+          counter.store(counter.load(std::memory_order_relaxed) + n,
+              std::memory_order_relaxed);
+        }
+
+      public:
+        std::atomic<std::size_t> allocations; ///< Allocation count
+        std::atomic<std::size_t> deallocations; ///< Deallocation count
+        std::atomic<std::size_t> hits; ///< Cache hit count
+        std::atomic<std::size_t> cached_bytes; ///< Bytes held by this cache
+
+        explicit ThreadCache(TensorPool& pool) :
+          blocks_(), pool_(pool), allocations(0ul), deallocations(0ul),
+          hits(0ul), cached_bytes(0ul)
+        {
+          pool_.register_cache(this);
+        }
+
+        ~ThreadCache() {
+          clear();
+          pool_.unregister_cache(this);
+          destroyed() = true;
+        }
+
+        /// Count an allocation
+
+        /// \param hit \c true if the allocation was served from this cache
+        void count_allocation(const bool hit) {
+          add(allocations, 1ul);
+          if(hit)
+            add(hits, 1ul);
+        }
+
+        /// Count a deallocation
+        void count_deallocation() { add(deallocations, 1ul); }
+
+        /// Take a block from the cache
+
+        /// \param bytes The size class of the block
+        /// \return A free block, or \c nullptr if there is none
+        void* pop(const std::size_t bytes) {
+          auto it = blocks_.find(bytes);
+          if((it == blocks_.end()) || it->second.empty())
+            return nullptr;
+          void* const block = it->second.back();
+          it->second.pop_back();
+          cached_bytes.store(cached_bytes.load(std::memory_order_relaxed) - bytes,
+              std::memory_order_relaxed);
+          return block;
+        }
+
+        /// Return a block to the cache
+
+        /// \param block The block
+        /// \param bytes The size class of \c block
+        /// \return \c true if the block was cached, or \c false if the cache
+        /// is full
+        bool push(void* const block, const std::size_t bytes) {
+          if(cached_bytes.load(std::memory_order_relaxed) + bytes >
+              pool_.thread_cache_limit_)
+            return false;
+          blocks_[bytes].push_back(block);
+          add(cached_bytes, bytes);
+          return true;
+        }
+
+        /// Return all cached blocks to the system
+        void clear() {
+          for(auto& size_class : blocks_)
+            for(void* const block : size_class.second)
+              std::free(block);
+          blocks_.clear();
+          cached_bytes.store(0ul, std::memory_order_relaxed);
+        }
+      }; // class ThreadCache
+
+      const std::size_t thread_cache_limit_; ///< Thread cache size limit in bytes
+      mutable std::mutex mutex_; ///< Protects \c caches_ and \c retired_
+      std::vector<const ThreadCache*> caches_; ///< The live thread caches
+      TensorPoolStats retired_; ///< The counts of destroyed thread caches
+
+      /// Add a thread cache to the statistics
+
+      /// \param cache The thread cache
+      void register_cache(const ThreadCache* const cache) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        caches_.push_back(cache);
+      }
+
+      /// Remove a thread cache from the statistics
+
+      /// The counts of \c cache are kept in the pool totals.
+      /// \param cache The thread cache
+      void unregister_cache(const ThreadCache* const cache) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.allocations += cache->allocations.load();
+        retired_.deallocations += cache->deallocations.load();
+        retired_.hits += cache->hits.load();
+        caches_.erase(std::find(caches_.begin(), caches_.end(), cache));
+      }
+
+      /// Read the thread cache size limit from the environment
+
+      /// \return The thread cache size limit in bytes
+      static std::size_t init_thread_cache_limit() {
+        const char* limit = getenv("TA_TENSOR_POOL_THREAD_CACHE");
+        if(limit)
+          return std::max(atol(limit), 0l);
+        return 16777216ul;
+      }
+
+      TensorPool() :
+        thread_cache_limit_(init_thread_cache_limit()), mutex_(), caches_(),
+        retired_{ 0ul, 0ul, 0ul, 0ul }
+      { }
+
+      /// Thread cache destruction flag accessor
+
+      /// The flag is trivially destructible, so it may be read after the
+      /// cache of the calling thread has been destroyed.
+      /// \return \c true if the cache of the calling thread has been
+      /// destroyed
+      static bool& destroyed() {
+        static thread_local bool flag = false;
+        return flag;
+      }
+
+      /// Free block cache accessor
+
+      /// \return The cache of the calling thread, or \c nullptr if it has
+      /// been destroyed
+      ThreadCache* thread_cache() {
+        if(destroyed())
+          return nullptr;
+        static thread_local ThreadCache cache(*this);
+        return & cache;
+      }
+
+      /// Compute the size class of an allocation
+
+      /// \param bytes The requested number of bytes
+      /// \return The size class of the block, which is not zero
+      static std::size_t size_class(const std::size_t bytes) {
+        return (std::max<std::size_t>(bytes, 1ul) + granularity() - 1ul) /
+            granularity() * granularity();
+      }
+
+      /// Allocate a block from the system
+
+      /// \param bytes The size class of the block
+      /// \return A pointer to the block
+      /// \throw std::bad_alloc When the allocation fails
+      static void* system_allocate(const std::size_t bytes) {
+        void* block = nullptr;
+        if(posix_memalign(& block, alignment(), bytes) != 0)
+          throw std::bad_alloc();
+        return block;
+      }
+
+    public:
+
+      TensorPool(const TensorPool&) = delete;
+      TensorPool& operator=(const TensorPool&) = delete;
+
+      /// Pool instance accessor
+
+      /// \return The global tensor memory pool
+      static TensorPool& instance() {
+        // The pool is not destroyed at exit, since tiles of static arrays
+        // may be freed after it would have been.
+        static TensorPool* const pool = new TensorPool();
+        return *pool;
+      }
+
+      /// Allocate a block
+
+      /// \param bytes The number of bytes to allocate
+      /// \return A pointer to the allocated memory
+      /// \throw std::bad_alloc When the allocation fails
+      void* allocate(const std::size_t bytes) {
+        const std::size_t block_size = size_class(bytes);
+        ThreadCache* const cache = thread_cache();
+        void* const block = (cache ? cache->pop(block_size) : nullptr);
+        if(cache)
+          cache->count_allocation(block != nullptr);
+        return (block ? block : system_allocate(block_size));
+      }
+
+      /// Deallocate a block
+
+      /// \param block The block to be deallocated
+      /// \param bytes The number of bytes that were requested for \c block
+      void deallocate(void* const block, const std::size_t bytes) {
+        if(! block)
+          return;
+        ThreadCache* const cache = thread_cache();
+        if(cache)
+          cache->count_deallocation();
+        if(! (cache && cache->push(block, size_class(bytes))))
+          std::free(block);
+      }
+
+      /// Return the blocks cached by the calling thread to the system
+      void release() {
+        ThreadCache* const cache = thread_cache();
+        if(cache)
+          cache->clear();
+      }
+
+      /// Statistics accessor
+
+      /// \return The current pool statistics
+      TensorPoolStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        TensorPoolStats result = retired_;
+        for(const ThreadCache* const cache : caches_) {
+          result.allocations += cache->allocations.load();
+          result.deallocations += cache->deallocations.load();
+          result.hits += cache->hits.load();
+          result.cached_bytes += cache->cached_bytes.load();
+        }
+        return result;
+      }
+
+      /// Thread cache size limit accessor
+
+      /// \return The maximum number of bytes held by each thread cache
+      std::size_t thread_cache_limit() const { return thread_cache_limit_; }
+
+    }; // class TensorPool
+
+  } // namespace detail
+
+  /// Pooled tensor allocator
+
+  /// This allocator obtains memory from \c detail::TensorPool , which keeps
+  /// per-thread caches of freed blocks so that temporary tiles of the same
+  /// size are reused instead of being returned to \c malloc . Memory is
+  /// aligned on \c detail::TensorPool::alignment() byte boundaries. Use it
+  /// to select pooled storage for an array type, e.g.
+  /// \code
+  /// typedef TiledArray::DistArray<TiledArray::Tensor<double,
+  ///     TiledArray::PoolAllocator<double> > > PoolArray;
+  /// \endcode
+  /// or the \c TArrayPool and \c TSpArrayPool aliases.
+  /// \tparam T The element type
+  template <typename T>
+  class PoolAllocator {
+  public:
+    typedef T value_type; ///< Element type
+    typedef T* pointer; ///< Element pointer type
+    typedef const T* const_pointer; ///< Element const pointer type
+    typedef T& reference; ///< Element reference type
+    typedef const T& const_reference; ///< Element const reference type
+    typedef std::size_t size_type; ///< Size type
+    typedef std::ptrdiff_t difference_type; ///< Difference type
+
+    template <typename U>
+    struct rebind { typedef PoolAllocator<U> other; };
+
+    PoolAllocator() noexcept { }
+    PoolAllocator(const PoolAllocator&) noexcept { }
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+    /// Allocate memory for \c n elements
+
+    /// \param n The number of elements
+    /// \return A pointer to the uninitialized elements
+    /// \throw std::bad_alloc When the allocation fails
+    pointer allocate(const size_type n, const void* = nullptr) {
+      return static_cast<pointer>(
+          detail::TensorPool::instance().allocate(n * sizeof(T)));
+    }
+
+    /// Deallocate memory
+
+    /// \param p A pointer that was returned by \c allocate
+    /// \param n The number of elements that was passed to \c allocate
+    void deallocate(pointer p, const size_type n) {
+      detail::TensorPool::instance().deallocate(p, n * sizeof(T));
+    }
+
+  }; // class PoolAllocator
+
+  template <typename T, typename U>
+  inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return true;
+  }
+
+  template <typename T, typename U>
+  inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return false;
+  }
+
+  /// Tensor memory pool statistics accessor
+
+  /// \return The statistics of the pool used by \c PoolAllocator
+  inline detail::TensorPoolStats tensor_pool_stats() {
+    return detail::TensorPool::instance().stats();
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
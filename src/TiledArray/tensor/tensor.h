@@ -21,7 +21,10 @@
 #define TILEDARRAY_TENSOR_TENSOR_H__INCLUDED
 
 #include <TiledArray/math/gemm_helper.h>
+#include <TiledArray/math/batched_gemm.h>
 #include <TiledArray/math/blas.h>
+#include <TiledArray/math/parallel_gemm.h>
+#include <TiledArray/math/strided_gemm.h>
 #include <TiledArray/tensor/kernels.h>
 #include <TiledArray/tensor/complex.h>
 
@@ -80,19 +83,42 @@ namespace TiledArray {
 
       /// \param range The N-dimensional range for this tensor
       explicit Impl(range_type&& range) :
-        allocator_type(), range_(range), data_(NULL)
+        allocator_type(), range_(std::move(range)), data_(NULL)
       {
-        data_ = allocator_type::allocate(range.volume());
+        data_ = allocator_type::allocate(range_.volume());
       }
 
+      /// Construct with external data
+
+      /// \param range The N-dimensional range for this tensor
+      /// \param data The tensor data, which is not owned by this object
+      /// \param owner The object that owns \c data
+      Impl(const range_type& range, pointer data,
+          const std::shared_ptr<void>& owner) :
+        allocator_type(), range_(range), data_(data), owner_(owner)
+      { }
+
+      /// Construct with an rvalue range and external data
+
+      /// \param range The N-dimensional range for this tensor
+      /// \param data The tensor data, which is not owned by this object
+      /// \param owner The object that owns \c data
+      Impl(range_type&& range, pointer data,
+          const std::shared_ptr<void>& owner) :
+        allocator_type(), range_(std::move(range)), data_(data), owner_(owner)
+      { }
+
       ~Impl() {
-        math::destroy_vector(range_.volume(), data_);
-        allocator_type::deallocate(data_, range_.volume());
+        if(! owner_) {
+          math::destroy_vector(range_.volume(), data_);
+          allocator_type::deallocate(data_, range_.volume());
+        }
         data_ = NULL;
       }
 
       range_type range_; ///< Tensor size info
       pointer data_; ///< Tensor data
+      std::shared_ptr<void> owner_; ///< Owner of external data
     }; // class Impl
 
     template <typename... Ts>
@@ -139,6 +165,33 @@ namespace TiledArray {
       default_init(range.volume(), pimpl_->data_);
     }
 
+    /// Construct tensor with an rvalue range
+
+    /// Construct a tensor with a range equal to \c range. The data is
+    /// uninitialized.
+    /// \param range The range of the tensor, which is moved into the tensor
+    Tensor(range_type&& range) :
+      pimpl_(std::make_shared<Impl>(std::move(range)))
+    {
+      default_init(pimpl_->range_.volume(), pimpl_->data_);
+    }
+
+    /// Construct a tensor that wraps external data
+
+    /// The tensor uses \c data directly, without copying or initializing
+    /// it, and keeps a reference to \c owner so that the memory remains valid
+    /// for the lifetime of the tensor and its shallow copies. The data is not
+    /// freed by the tensor. This is used, for example, to serve tiles from a
+    /// memory-mapped file.
+    /// \param range The range of the tensor
+    /// \param data A pointer to <tt>range.volume()</tt> elements
+    /// \param owner The object that owns \c data
+    Tensor(const range_type& range, pointer data,
+        const std::shared_ptr<void>& owner) :
+      pimpl_(std::make_shared<Impl>(range, data, owner))
+    {
+      TA_ASSERT(owner);
+    }
 
     /// Construct a tensor with a fill value
 
@@ -215,11 +268,7 @@ namespace TiledArray {
     Tensor(const T1& other, const Permutation& perm) :
       pimpl_(std::make_shared<Impl>(perm * other.range()))
     {
-      auto op =
-          [] (const numeric_t<T1> arg) -> numeric_t<T1>
-      { return arg; };
-
-      detail::tensor_init(op, perm, *this, other);
+      detail::tensor_init_permute_copy(perm, *this, other);
     }
 
     /// Copy and modify the data from \c other
@@ -1159,8 +1208,15 @@ namespace TiledArray {
       const integer lda = (gemm_helper.left_op() == madness::cblas::NoTrans ? k : m);
       const integer ldb = (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
 
-      math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
-          pimpl_->data_, lda, other.data(), ldb, numeric_type(0), result.data(), n);
+      // Large contractions are split into tasks so that they are not limited
+      // to a single thread.
+      if(math::use_parallel_gemm(m, n, k))
+        math::parallel_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n,
+            k, factor, pimpl_->data_, lda, other.data(), ldb, numeric_type(0),
+            result.data(), n);
+      else
+        math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
+            pimpl_->data_, lda, other.data(), ldb, numeric_type(0), result.data(), n);
 
       return result;
     }
@@ -1256,8 +1312,153 @@ namespace TiledArray {
       const integer ldb =
           (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
 
-      math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
-          left.data(), lda, right.data(), ldb, numeric_type(1), pimpl_->data_, n);
+      if(math::use_parallel_gemm(m, n, k))
+        math::parallel_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n,
+            k, factor, left.data(), lda, right.data(), ldb, numeric_type(1),
+            pimpl_->data_, n);
+      else
+        math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
+            left.data(), lda, right.data(), ldb, numeric_type(1), pimpl_->data_, n);
+
+      return *this;
+    }
+
+    /// Contract two permuted tensors and accumulate the scaled result to this tensor
+
+    /// This function is equivalent to
+    /// \code
+    /// gemm(left.permute(left_perm), right.permute(right_perm), factor, gemm_helper);
+    /// \endcode
+    /// but the arguments are not permuted. Instead, blocks of the arguments are
+    /// packed directly from their original layout into the GEMM panels (see
+    /// \c math::strided_gemm ), so that contractions that do not fit the
+    /// patterns of the \c gemm function above do not require a permuted copy
+    /// of the arguments.
+    /// \tparam U The left-hand tensor element type
+    /// \tparam AU The left-hand tensor allocator type
+    /// \tparam V The right-hand tensor element type
+    /// \tparam AV The right-hand tensor allocator type
+    /// \tparam W The type of the scaling factor
+    /// \param left The left-hand tensor that will be contracted
+    /// \param left_perm The permutation that is applied to \c left (may be
+    /// empty)
+    /// \param right The right-hand tensor that will be contracted
+    /// \param right_perm The permutation that is applied to \c right (may be
+    /// empty)
+    /// \param factor The contraction result will be scaling by this value, then accumulated into \c this
+    /// \param gemm_helper The *GEMM operation meta data of the permuted
+    /// arguments
+    /// \return A reference to \c this
+    template <
+        typename U, typename AU, typename V, typename AV, typename W,
+        typename std::enable_if<!detail::is_tensor_of_tensor<
+            Tensor_, Tensor<U, AU>, Tensor<V, AV>>::value>::type* = nullptr>
+    Tensor_& gemm(const Tensor<U, AU>& left, const Permutation& left_perm,
+                  const Tensor<V, AV>& right, const Permutation& right_perm,
+                  const W factor, const math::GemmHelper& gemm_helper) {
+      // Check that this tensor is not empty and has the correct rank
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.result_rank());
+
+      // Check that the arguments are not empty and have the correct ranks
+      TA_ASSERT(!left.empty());
+      TA_ASSERT(left.range().rank() == gemm_helper.left_rank());
+      TA_ASSERT(!right.empty());
+      TA_ASSERT(right.range().rank() == gemm_helper.right_rank());
+
+#ifndef NDEBUG
+      // Check the dimensions of the permuted arguments
+      const range_type left_range =
+          (left_perm ? left_perm * left.range() : left.range());
+      const range_type right_range =
+          (right_perm ? right_perm * right.range() : right.range());
+      TA_ASSERT(gemm_helper.left_result_congruent(left_range.extent_data(),
+          pimpl_->range_.extent_data()));
+      TA_ASSERT(gemm_helper.right_result_congruent(right_range.extent_data(),
+          pimpl_->range_.extent_data()));
+      TA_ASSERT(gemm_helper.left_right_congruent(left_range.extent_data(),
+          right_range.extent_data()));
+#endif // NDEBUG
+
+      // View the arguments as the matrices A(m,k) and B(k,n)
+      const math::StridedMatrix<U> a(left.data(), left.range(), left_perm,
+          gemm_helper.left_outer_begin(), gemm_helper.left_outer_end(),
+          gemm_helper.left_inner_begin(), gemm_helper.left_inner_end());
+      const math::StridedMatrix<V> b(right.data(), right.range(), right_perm,
+          gemm_helper.right_inner_begin(), gemm_helper.right_inner_end(),
+          gemm_helper.right_outer_begin(), gemm_helper.right_outer_end());
+
+      math::strided_gemm(factor, a, b, pimpl_->data_);
+
+      return *this;
+    }
+
+    /// Contract a batch of tensor pairs and accumulate the scaled result to this tensor
+
+    /// This function is equivalent to
+    /// \code
+    /// for(std::size_t p = 0ul; p < left.size(); ++p)
+    ///   gemm(*left[p], *right[p], factor, gemm_helper);
+    /// \endcode
+    /// but all pairs are packed side by side and contracted with a single
+    /// GEMM (see \c math::batched_gemm ), which is much faster for small
+    /// tensors.
+    /// \tparam U The left-hand tensor element type
+    /// \tparam AU The left-hand tensor allocator type
+    /// \tparam V The right-hand tensor element type
+    /// \tparam AV The right-hand tensor allocator type
+    /// \tparam W The type of the scaling factor
+    /// \param left The left-hand tensors that will be contracted
+    /// \param right The right-hand tensors that will be contracted
+    /// \param factor The contraction result will be scaling by this value, then accumulated into \c this
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A reference to \c this
+    template <
+        typename U, typename AU, typename V, typename AV, typename W,
+        typename std::enable_if<!detail::is_tensor_of_tensor<
+            Tensor_, Tensor<U, AU>, Tensor<V, AV>>::value>::type* = nullptr>
+    Tensor_& gemm(const std::vector<const Tensor<U, AU>*>& left,
+                  const std::vector<const Tensor<V, AV>*>& right,
+                  const W factor, const math::GemmHelper& gemm_helper) {
+      // Check that this tensor is not empty and has the correct rank
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.result_rank());
+      TA_ASSERT(left.size() == right.size());
+
+      // Compute gemm dimensions
+      integer m = 1, n = 1;
+      std::vector<integer> k;
+      std::vector<const U*> a;
+      std::vector<const V*> b;
+      k.reserve(left.size());
+      a.reserve(left.size());
+      b.reserve(left.size());
+      for(std::size_t p = 0ul; p < left.size(); ++p) {
+        // Check that the arguments are not empty and have the correct ranks
+        TA_ASSERT(!left[p]->empty());
+        TA_ASSERT(left[p]->range().rank() == gemm_helper.left_rank());
+        TA_ASSERT(!right[p]->empty());
+        TA_ASSERT(right[p]->range().rank() == gemm_helper.right_rank());
+
+        // Check that the outer dimensions match the result and that the
+        // inner dimensions of left and right match
+        TA_ASSERT(gemm_helper.left_result_congruent(left[p]->range().extent_data(),
+            pimpl_->range_.extent_data()));
+        TA_ASSERT(gemm_helper.right_result_congruent(right[p]->range().extent_data(),
+            pimpl_->range_.extent_data()));
+        TA_ASSERT(gemm_helper.left_right_congruent(left[p]->range().extent_data(),
+            right[p]->range().extent_data()));
+
+        integer k_p = 1;
+        gemm_helper.compute_matrix_sizes(m, n, k_p, left[p]->range(),
+            right[p]->range());
+        k.push_back(k_p);
+        a.push_back(left[p]->data());
+        b.push_back(right[p]->data());
+      }
+
+      math::batched_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n,
+          k, factor, a, b, pimpl_->data_, n);
 
       return *this;
     }
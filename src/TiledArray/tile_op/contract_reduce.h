@@ -32,10 +32,34 @@
 #include "../tile_interface/add.h"
 #include "../tile_interface/permute.h"
 #include <TiledArray/tensor/complex.h>
+#include <TiledArray/tensor/type_traits.h>
+#include <TiledArray/type_traits.h>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
 
+    template <typename>
+    struct is_strided_contractable_helper : public std::false_type { };
+
+    template <typename T, typename A>
+    struct is_strided_contractable_helper<Tensor<T, A> > :
+        public is_numeric<T> { };
+
+    /// Contraction of permuted tiles without permutation
+
+    /// \c value is \c true if tiles of types \c Left and \c Right can be
+    /// contracted into a tile of type \c Result with the strided GEMM kernel
+    /// of \c Tensor , without permuting them first, and with the batched
+    /// GEMM kernel of \c Tensor , i.e. if they are plain numeric tensors.
+    template <typename Result, typename Left, typename Right>
+    struct is_strided_contractable {
+      static constexpr bool value =
+          is_strided_contractable_helper<Result>::value
+          && is_strided_contractable_helper<Left>::value
+          && is_strided_contractable_helper<Right>::value;
+    };
+
     /// Contract and (sum) reduce base
 
     /// This implementation class is used to provide shallow copy semantics for ContractReduce.
@@ -61,9 +85,12 @@ namespace TiledArray {
             const madness::cblas::CBLAS_TRANSPOSE right_op,
             const scalar_type alpha, const unsigned int result_rank,
             const unsigned int left_rank, const unsigned int right_rank,
-            const Permutation& perm = Permutation()) :
+            const Permutation& perm = Permutation(),
+            const Permutation& left_perm = Permutation(),
+            const Permutation& right_perm = Permutation()) :
           gemm_helper_(left_op, right_op, result_rank, left_rank, right_rank),
-          alpha_(alpha), perm_(perm)
+          alpha_(alpha), perm_(perm), left_perm_(left_perm),
+          right_perm_(right_perm)
         { }
 
         math::GemmHelper gemm_helper_; ///< Gemm helper object
@@ -71,6 +98,8 @@ namespace TiledArray {
             ///< the left- and right-hand arguments
         Permutation perm_; ///< Permutation that is applied to the final result
             ///< tensor
+        Permutation left_perm_; ///< Permutation of the left-hand tiles
+        Permutation right_perm_; ///< Permutation of the right-hand tiles
       };
 
       std::shared_ptr<Impl> pimpl_;
@@ -96,13 +125,20 @@ namespace TiledArray {
       /// \param right_rank The rank of the right-hand tensor
       /// \param perm The permutation to be applied to the result tensor
       /// (default = no permute)
+      /// \param left_perm The permutation of the left-hand tiles; the
+      /// left-hand tiles are contracted as if they were permuted by
+      /// \c left_perm (default = no permute)
+      /// \param right_perm The permutation of the right-hand tiles
+      /// (default = no permute)
       ContractReduceBase(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op,
           const scalar_type alpha, const unsigned int result_rank,
           const unsigned int left_rank, const unsigned int right_rank,
-          const Permutation& perm = Permutation()) :
+          const Permutation& perm = Permutation(),
+          const Permutation& left_perm = Permutation(),
+          const Permutation& right_perm = Permutation()) :
         pimpl_(std::make_shared<Impl>(left_op, right_op, alpha, result_rank, left_rank,
-            right_rank, perm))
+            right_rank, perm, left_perm, right_perm))
       { }
 
 
@@ -122,6 +158,22 @@ namespace TiledArray {
         return pimpl_->perm_;
       }
 
+      /// Left-hand argument permutation accessor
+
+      /// \return A const reference to the permutation of the left-hand tiles
+      const Permutation& left_perm() const {
+        TA_ASSERT(pimpl_);
+        return pimpl_->left_perm_;
+      }
+
+      /// Right-hand argument permutation accessor
+
+      /// \return A const reference to the permutation of the right-hand tiles
+      const Permutation& right_perm() const {
+        TA_ASSERT(pimpl_);
+        return pimpl_->right_perm_;
+      }
+
 
       /// Scaling factor accessor
 
@@ -190,6 +242,94 @@ namespace TiledArray {
       typedef Result result_type; ///< The result tile type.
       typedef Scalar scalar_type;
 
+    private:
+
+      /// Contract a pair of permuted tiles without permuting them
+
+      /// \param[in,out] result The reduction target
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] right The right-hand tile to be contracted
+      void gemm_permuted(result_type& result, first_argument_type left,
+          second_argument_type right, std::true_type) const
+      {
+        using TiledArray::empty;
+        const Permutation& left_perm = ContractReduceBase_::left_perm();
+        const Permutation& right_perm = ContractReduceBase_::right_perm();
+        const math::GemmHelper& gemm_helper = ContractReduceBase_::gemm_helper();
+        if(empty(result))
+          result = result_type(gemm_helper.template make_result_range<
+              typename result_type::range_type>(
+                  (left_perm ? left_perm * left.range() : left.range()),
+                  (right_perm ? right_perm * right.range() : right.range())),
+              typename result_type::numeric_type(0));
+        result.gemm(left, left_perm, right, right_perm,
+            ContractReduceBase_::factor(), gemm_helper);
+      }
+
+      /// Contract a pair of permuted tiles
+
+      /// Fallback for tiles that do not support strided contractions, which
+      /// permutes the arguments before they are contracted.
+      /// \param[in,out] result The reduction target
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] right The right-hand tile to be contracted
+      void gemm_permuted(result_type& result, first_argument_type left,
+          second_argument_type right, std::false_type) const
+      {
+        using TiledArray::empty;
+        using TiledArray::gemm;
+        using TiledArray::permute;
+        const Permutation& left_perm = ContractReduceBase_::left_perm();
+        const Permutation& right_perm = ContractReduceBase_::right_perm();
+        const Left left_arg = (left_perm ? permute(left, left_perm) : left);
+        const Right right_arg = (right_perm ? permute(right, right_perm) : right);
+        if(empty(result))
+          result = gemm(left_arg, right_arg, ContractReduceBase_::factor(),
+              ContractReduceBase_::gemm_helper());
+        else
+          gemm(result, left_arg, right_arg, ContractReduceBase_::factor(),
+              ContractReduceBase_::gemm_helper());
+      }
+
+      /// Contract a batch of tile pairs with a single GEMM
+
+      /// \param[in,out] result The reduction target
+      /// \param[in] left The left-hand tiles to be contracted
+      /// \param[in] right The right-hand tiles to be contracted
+      void gemm_batch(result_type& result, const std::vector<const Left*>& left,
+          const std::vector<const Right*>& right, std::true_type) const
+      {
+        using TiledArray::empty;
+        if(ContractReduceBase_::left_perm() || ContractReduceBase_::right_perm()) {
+          gemm_batch(result, left, right, std::false_type());
+          return;
+        }
+
+        const math::GemmHelper& gemm_helper = ContractReduceBase_::gemm_helper();
+        if(empty(result))
+          result = result_type(gemm_helper.template make_result_range<
+              typename result_type::range_type>(left.front()->range(),
+                  right.front()->range()),
+              typename result_type::numeric_type(0));
+        result.gemm(left, right, ContractReduceBase_::factor(), gemm_helper);
+      }
+
+      /// Contract a batch of tile pairs
+
+      /// Fallback for tiles that are not plain numeric tensors, which
+      /// contracts the pairs one at a time.
+      /// \param[in,out] result The reduction target
+      /// \param[in] left The left-hand tiles to be contracted
+      /// \param[in] right The right-hand tiles to be contracted
+      void gemm_batch(result_type& result, const std::vector<const Left*>& left,
+          const std::vector<const Right*>& right, std::false_type) const
+      {
+        for(std::size_t p = 0ul; p < left.size(); ++p)
+          operator()(result, *left[p], *right[p]);
+      }
+
+    public:
+
       // Compiler generated defaults are fine. N.B. this is shallow-copy.
       
       ContractReduce() = default;
@@ -209,13 +349,19 @@ namespace TiledArray {
       /// \param right_rank The rank of the right-hand tensor
       /// \param perm The permutation to be applied to the result tensor
       /// (default = no permute)
+      /// \param left_perm The permutation of the left-hand tiles
+      /// (default = no permute)
+      /// \param right_perm The permutation of the right-hand tiles
+      /// (default = no permute)
       ContractReduce(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op,
           const scalar_type alpha, const unsigned int result_rank,
           const unsigned int left_rank, const unsigned int right_rank,
-          const Permutation& perm = Permutation()) :
+          const Permutation& perm = Permutation(),
+          const Permutation& left_perm = Permutation(),
+          const Permutation& right_perm = Permutation()) :
         ContractReduceBase_(left_op, right_op, alpha, result_rank, left_rank,
-            right_rank, perm)
+            right_rank, perm, left_perm, right_perm)
       { }
 
 
@@ -261,7 +407,10 @@ namespace TiledArray {
       {
         using TiledArray::empty;
         using TiledArray::gemm;
-        if(empty(result))
+        if(ContractReduceBase_::left_perm() || ContractReduceBase_::right_perm())
+          gemm_permuted(result, left, right, std::integral_constant<bool,
+              is_strided_contractable<Result, Left, Right>::value>());
+        else if(empty(result))
           result = gemm(left, right, ContractReduceBase_::factor(),
               ContractReduceBase_::gemm_helper());
         else
@@ -269,6 +418,27 @@ namespace TiledArray {
               ContractReduceBase_::gemm_helper());
       }
 
+      /// Contract a batch of tile pairs and add to a target tile
+
+      /// This is equivalent to contracting each pair of \c left and
+      /// \c right and adding the result to \c result , but the pairs of
+      /// plain numeric tensors are contracted with a single GEMM (see
+      /// \c Tensor::gemm ).
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tiles to be contracted
+      /// \param[in] right The right-hand tiles to be contracted
+      void operator()(result_type& result, const std::vector<const Left*>& left,
+          const std::vector<const Right*>& right) const
+      {
+        TA_ASSERT(left.size() == right.size());
+        if(left.size() == 1ul)
+          operator()(result, *left.front(), *right.front());
+        else if(! left.empty())
+          gemm_batch(result, left, right, std::integral_constant<bool,
+              is_strided_contractable<Result, Left, Right>::value>());
+      }
+
     }; // class ContractReduce
 
 
@@ -319,14 +489,23 @@ namespace TiledArray {
       /// \param right_rank The rank of the right-hand tensor
       /// \param perm The permutation to be applied to the result tensor
       /// (default = no permute)
+      /// \param left_perm The permutation of the left-hand tiles, which must
+      /// be empty since strided contractions are not used with conjugation
+      /// \param right_perm The permutation of the right-hand tiles, which must
+      /// be empty
       ContractReduce(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op,
           const scalar_type alpha, const unsigned int result_rank,
           const unsigned int left_rank, const unsigned int right_rank,
-          const Permutation& perm = Permutation()) :
+          const Permutation& perm = Permutation(),
+          const Permutation& left_perm = Permutation(),
+          const Permutation& right_perm = Permutation()) :
         ContractReduceBase_(left_op, right_op, alpha, result_rank, left_rank,
             right_rank, perm)
-      { }
+      {
+        TA_ASSERT(! left_perm);
+        TA_ASSERT(! right_perm);
+      }
 
 
       /// Create a result type object
@@ -430,14 +609,23 @@ namespace TiledArray {
       /// \param right_rank The rank of the right-hand tensor
       /// \param perm The permutation to be applied to the result tensor
       /// (default = no permute)
+      /// \param left_perm The permutation of the left-hand tiles, which must
+      /// be empty since strided contractions are not used with conjugation
+      /// \param right_perm The permutation of the right-hand tiles, which must
+      /// be empty
       ContractReduce(const madness::cblas::CBLAS_TRANSPOSE left_op,
           const madness::cblas::CBLAS_TRANSPOSE right_op,
           const scalar_type alpha, const unsigned int result_rank,
           const unsigned int left_rank, const unsigned int right_rank,
-          const Permutation& perm = Permutation()) :
+          const Permutation& perm = Permutation(),
+          const Permutation& left_perm = Permutation(),
+          const Permutation& right_perm = Permutation()) :
         ContractReduceBase_(left_op, right_op, alpha, result_rank, left_rank,
             right_rank, perm)
-      { }
+      {
+        TA_ASSERT(! left_perm);
+        TA_ASSERT(! right_perm);
+      }
 
 
       /// Create a result type object
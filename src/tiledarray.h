@@ -41,16 +41,20 @@
 #include <TiledArray/conversions/truncate.h>
 #include <TiledArray/conversions/foreach.h>
 #include <TiledArray/conversions/make_array.h>
+#include <TiledArray/conversions/redistribute.h>
 
 // Special Arrays
 #include <TiledArray/special/diagonal_array.h>
 
 // Process maps
+#include <TiledArray/pmap/balanced_pmap.h>
 #include <TiledArray/pmap/hash_pmap.h>
 #include <TiledArray/pmap/replicated_pmap.h>
 
 // Utility functionality
 #include <TiledArray/conversions/eigen.h>
+#include <TiledArray/conversions/checkpoint.h>
+#include <TiledArray/conversions/mapped_array.h>
 
 // Linear algebra
 #include <TiledArray/algebra/conjgrad.h>
@@ -37,6 +37,9 @@ namespace TiledArray {
   template<typename, typename>
   class Tensor;
 
+  template <typename>
+  class PoolAllocator;
+
   typedef Tensor<double, Eigen::aligned_allocator<double> > TensorD;
   typedef Tensor<int, Eigen::aligned_allocator<int> > TensorI;
   typedef Tensor<float, Eigen::aligned_allocator<float> > TensorF;
@@ -68,6 +71,12 @@ namespace TiledArray {
   typedef TSpArray<std::complex<double> > TSpArrayZ;
   typedef TSpArray<std::complex<float> >  TSpArrayC;
 
+  // Pooled Array Typedefs
+  template <typename T>
+  using TArrayPool = DistArray<Tensor<T, PoolAllocator<T> >, DensePolicy>;
+  template <typename T>
+  using TSpArrayPool = DistArray<Tensor<T, PoolAllocator<T> >, SparsePolicy>;
+
   // type alias for backward compatibility: the old Array has static type, DistArray is rank-polymorphic
   template <typename T, unsigned int = 0, typename Tile = Tensor<T, Eigen::aligned_allocator<T> >, typename Policy = DensePolicy>
   using Array = DistArray<Tile, Policy>;
@@ -0,0 +1,191 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/balanced_pmap.h"
+#include "TiledArray/dense_shape.h"
+#include "TiledArray/sparse_shape.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct BalancedPmapFixture {
+
+  BalancedPmapFixture() { }
+
+  /// Make a 1D tiled range with tiles of size 1, 2, ..., tiles
+  static TiledRange make_trange(const std::size_t tiles) {
+    std::vector<std::size_t> blocking(1ul, 0ul);
+    for(std::size_t t = 1ul; t <= tiles; ++t)
+      blocking.push_back(blocking.back() + t);
+    return TiledRange{TiledRange1(blocking.begin(), blocking.end())};
+  }
+
+  /// Make a shape where every third tile is non-zero
+  static SparseShape<float> make_shape(const TiledRange& trange) {
+    Tensor<float> norms(trange.tiles_range(), 0.0f);
+    for(std::size_t i = 0ul; i < norms.size(); i += 3ul)
+      norms[i] = 1.0f;
+    return SparseShape<float>(norms, trange);
+  }
+
+};
+
+
+// =============================================================================
+// BalancedPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( balanced_pmap_suite, BalancedPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledRange trange = make_trange(tiles);
+    BOOST_REQUIRE_NO_THROW(TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, trange, make_shape(trange)));
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, trange, make_shape(trange));
+    BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+    BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+    BOOST_CHECK_EQUAL(pmap.size(), tiles);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  // Check various pmap sizes
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledRange trange = make_trange(tiles);
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, trange, make_shape(trange));
+
+    for(std::size_t tile = 0; tile < tiles; ++tile) {
+      std::fill_n(p_owner, size, 0);
+      p_owner[rank] = pmap.owner(tile);
+      // check that the value is in range
+      BOOST_CHECK_LT(p_owner[rank], size);
+      GlobalFixture::world->gop.sum(p_owner, size);
+
+      // Make sure everyone agrees on who owns what.
+      for(std::size_t p = 0ul; p < size; ++p)
+        BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+    }
+  }
+
+  delete [] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE( local_size )
+{
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledRange trange = make_trange(tiles);
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, trange, make_shape(trange));
+
+    std::size_t total_size = pmap.local_size();
+    GlobalFixture::world->gop.sum(total_size);
+
+    // Check that the total number of elements in all local groups is equal to
+    // the number of tiles in the map.
+    BOOST_CHECK_EQUAL(total_size, tiles);
+    BOOST_CHECK(pmap.empty() == (pmap.local_size() == 0ul));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledRange trange = make_trange(tiles);
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, trange, make_shape(trange));
+
+    // Check that all local elements map to this rank
+    for(detail::BalancedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+      BOOST_CHECK(pmap.is_local(*it));
+    }
+
+    std::fill_n(tile_owners, tiles, 0);
+    for(detail::BalancedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      tile_owners[*it] += GlobalFixture::world->rank();
+    }
+
+    GlobalFixture::world->gop.sum(tile_owners, tiles);
+    for(std::size_t tile = 0; tile < tiles; ++tile) {
+      BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+    }
+
+  }
+}
+
+BOOST_AUTO_TEST_CASE( balance )
+{
+  const std::size_t procs = GlobalFixture::world->size();
+  const std::size_t tiles = 300ul;
+  TiledRange trange = make_trange(tiles);
+  SparseShape<float> shape = make_shape(trange);
+
+  for(const double compute_weight : { 0.0, 0.5, 1.0 }) {
+    TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, trange,
+        shape, compute_weight);
+
+    // Compute the normalized cost of the non-zero tiles owned by each process
+    double total_memory = 0.0, total_work = 0.0;
+    for(std::size_t tile = 0ul; tile < tiles; tile += 3ul) {
+      const double volume = double(tile + 1ul);
+      total_memory += volume;
+      total_work += volume * std::sqrt(volume);
+    }
+    std::vector<double> cost(procs + 1ul, 0.0);
+    double max_tile_cost = 0.0;
+    for(std::size_t tile = 0ul; tile < tiles; ++tile) {
+      if(shape.is_zero(tile)) continue;
+      const double volume = double(tile + 1ul);
+      const double tile_cost = (1.0 - compute_weight) * volume / total_memory
+          + compute_weight * volume * std::sqrt(volume) / total_work;
+      cost[pmap.owner(tile)] += tile_cost;
+      cost[procs] += tile_cost;
+      max_tile_cost = std::max(max_tile_cost, tile_cost);
+    }
+
+    // Each process owns the average cost to within one tile on either side
+    // of its block.
+    for(std::size_t p = 0ul; p < procs; ++p)
+      BOOST_CHECK_LE(std::abs(cost[p] - cost[procs] / double(procs)),
+          2.0 * max_tile_cost);
+
+    // Check that the blocks are contiguous
+    BOOST_CHECK_EQUAL(pmap.first(0ul), 0ul);
+    BOOST_CHECK_EQUAL(pmap.first(procs), tiles);
+    for(std::size_t p = 0ul; p < procs; ++p)
+      for(std::size_t tile = pmap.first(p); tile < pmap.first(p + 1ul); ++tile)
+        BOOST_CHECK_EQUAL(pmap.owner(tile), p);
+  }
+
+  // All tiles of a dense shape have a cost
+  TiledArray::detail::BalancedPmap pmap(* GlobalFixture::world, trange, DenseShape());
+  std::size_t total_size = pmap.local_size();
+  GlobalFixture::world->gop.sum(total_size);
+  BOOST_CHECK_EQUAL(total_size, tiles);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
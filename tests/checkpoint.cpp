@@ -0,0 +1,211 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  checkpoint.cpp
+ *  Oct 18, 2018
+ *
+ */
+
+#include <cstdio>
+#include "TiledArray/conversions/checkpoint.h"
+#include "TiledArray/conversions/mapped_array.h"
+#include "range_fixture.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct CheckpointFixture : public TiledRangeFixture {
+  CheckpointFixture() :
+    filename("checkpoint_test.tackpt"),
+    a_dense(*GlobalFixture::world, tr),
+    a_sparse(*GlobalFixture::world, tr, make_shape(tr))
+  {
+    random_fill(a_dense);
+    random_fill(a_sparse);
+    GlobalFixture::world->gop.fence();
+  }
+
+  ~CheckpointFixture() {
+    GlobalFixture::world->gop.fence();
+    if(GlobalFixture::world->rank() == 0)
+      std::remove(filename.c_str());
+  }
+
+  template <typename Tile, typename Policy>
+  static void random_fill(DistArray<Tile, Policy>& array) {
+    for(const auto index : * array.pmap())
+      if(! array.is_zero(index)) {
+        Tile tile(array.trange().make_tile_range(index));
+        for(std::size_t i = 0ul; i < tile.size(); ++i)
+          tile[i] = GlobalFixture::world->rand() % 101;
+        array.set(index, tile);
+      }
+  }
+
+  /// Make a shape where every third tile is zero
+  static SparseShape<float> make_shape(const TiledRange& tr) {
+    Tensor<float> norms(tr.tiles_range(), 0.0);
+    for(std::size_t i = 0ul; i < norms.size(); ++i)
+      norms[i] = (i % 3ul ? 1.0 : 0.0);
+    return SparseShape<float>(norms, tr);
+  }
+
+  template <typename A, typename B>
+  static void check_equal(const A& a, const B& b) {
+    BOOST_CHECK_EQUAL(a.trange(), b.trange());
+    for(std::size_t i = 0ul; i < a.size(); ++i) {
+      if(! a.is_zero(i)) {
+        BOOST_REQUIRE(! b.is_zero(i));
+        const auto a_tile = a.find(i).get();
+        const auto b_tile = b.find(i).get();
+        BOOST_CHECK_EQUAL(a_tile.range(), b_tile.range());
+        for(std::size_t j = 0ul; j < a_tile.size(); ++j)
+          BOOST_CHECK_EQUAL(a_tile[j], b_tile[j]);
+      }
+    }
+  }
+
+  std::string filename;
+  TArrayD a_dense;
+  TSpArrayD a_sparse;
+};
+
+BOOST_FIXTURE_TEST_SUITE( checkpoint_suite, CheckpointFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  BOOST_REQUIRE_NO_THROW(save_array(a_dense, filename));
+
+  TArrayD b;
+  BOOST_REQUIRE_NO_THROW(b = load_array<TArrayD>(*GlobalFixture::world, filename));
+  check_equal(a_dense, b);
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  BOOST_REQUIRE_NO_THROW(save_array(a_sparse, filename));
+
+  TSpArrayD b;
+  BOOST_REQUIRE_NO_THROW(b = load_array<TSpArrayD>(*GlobalFixture::world, filename));
+  check_equal(a_sparse, b);
+
+  // Check that the zero tiles are preserved
+  for(std::size_t i = 0ul; i < a_sparse.size(); ++i)
+    BOOST_CHECK_EQUAL(a_sparse.is_zero(i), b.is_zero(i));
+}
+
+BOOST_AUTO_TEST_CASE( different_pmap )
+{
+  save_array(a_sparse, filename);
+
+  // Load the array with a different process map
+  auto pmap = std::make_shared<detail::HashPmap>(*GlobalFixture::world,
+      tr.tiles_range().volume(), 1ul);
+  TSpArrayD b = load_array<TSpArrayD>(*GlobalFixture::world, filename, pmap);
+  BOOST_CHECK(b.pmap() == pmap);
+  check_equal(a_sparse, b);
+}
+
+BOOST_AUTO_TEST_CASE( sparse_to_dense )
+{
+  save_array(a_sparse, filename);
+
+  // Zero tiles of the sparse array are zero-filled in the dense array
+  TArrayD b = load_array<TArrayD>(*GlobalFixture::world, filename);
+  check_equal(a_sparse, b);
+  for(std::size_t i = 0ul; i < a_sparse.size(); ++i)
+    if(a_sparse.is_zero(i)) {
+      const auto tile = b.find(i).get();
+      for(std::size_t j = 0ul; j < tile.size(); ++j)
+        BOOST_CHECK_EQUAL(tile[j], 0.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( element_type_mismatch )
+{
+  save_array(a_dense, filename);
+
+  BOOST_CHECK_THROW(load_array<TArrayF>(*GlobalFixture::world, filename),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( byte_order_mismatch )
+{
+  save_array(a_dense, filename);
+
+  // Swap the byte order marker, which follows the signature and the version
+  if(GlobalFixture::world->rank() == 0) {
+    std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+    std::uint64_t marker = 0ul;
+    file.seekg(6ul + sizeof(std::uint64_t));
+    file.read(reinterpret_cast<char*>(& marker), sizeof(marker));
+    char* const bytes = reinterpret_cast<char*>(& marker);
+    std::reverse(bytes, bytes + sizeof(marker));
+    file.seekp(6ul + sizeof(std::uint64_t));
+    file.write(reinterpret_cast<const char*>(& marker), sizeof(marker));
+  }
+  GlobalFixture::world->gop.fence();
+
+  BOOST_CHECK_THROW(load_array<TArrayD>(*GlobalFixture::world, filename),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( missing_file )
+{
+  // All processes throw, so none of them waits for the others
+  BOOST_CHECK_THROW(load_array<TArrayD>(*GlobalFixture::world,
+      "missing_checkpoint_test.tackpt"), TiledArray::Exception);
+  BOOST_CHECK_THROW(save_array(a_dense, "missing_directory/checkpoint_test.tackpt"),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( mapped )
+{
+  save_array(a_sparse, filename);
+
+  TSpArrayD b;
+  BOOST_REQUIRE_NO_THROW(b = map_array<TSpArrayD>(*GlobalFixture::world, filename));
+  check_equal(a_sparse, b);
+
+  // Check that local tiles refer to aligned, mapped data
+  for(const auto index : * b.pmap())
+    if(! b.is_zero(index)) {
+      const auto tile = b.find(index).get();
+      BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(tile.data()) %
+          detail::CheckpointHeader::alignment(), 0ul);
+    }
+
+  // Mapped tiles may be used in expressions
+  TSpArrayD c;
+  c("i,j,k") = 2.0 * b("i,j,k");
+  TSpArrayD d;
+  d("i,j,k") = 2.0 * a_sparse("i,j,k");
+  check_equal(d, c);
+}
+
+BOOST_AUTO_TEST_CASE( mapped_dense )
+{
+  save_array(a_dense, filename);
+
+  auto pmap = std::make_shared<detail::HashPmap>(*GlobalFixture::world,
+      tr.tiles_range().volume(), 1ul);
+  TArrayD b = map_array<TArrayD>(*GlobalFixture::world, filename, pmap);
+  check_equal(a_dense, b);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -184,4 +184,33 @@ BOOST_AUTO_TEST_CASE(make_array_test) {
                                             &this->init_rand_tile<TensorI>));
 }
 
+BOOST_AUTO_TEST_CASE(redistribute_test) {
+  // move the tiles to a map balanced by tile cost
+  TSpArrayI b_sparse;
+  BOOST_CHECK_NO_THROW(b_sparse = balance(a_sparse));
+  BOOST_CHECK(std::dynamic_pointer_cast<const detail::BalancedPmap>(b_sparse.pmap()));
+
+  // move the tiles back to a blocked map
+  TSpArrayI c_sparse;
+  BOOST_CHECK_NO_THROW(c_sparse = redistribute(b_sparse,
+      std::make_shared<detail::BlockedPmap>(*GlobalFixture::world, a_sparse.size())));
+
+  // check correctness
+  for (std::size_t i = 0; i < a_sparse.size(); i++) {
+    if (!a_sparse.is_zero(i)) {
+      TSpArrayI::value_type a_tile = a_sparse.find(i).get();
+      TSpArrayI::value_type b_tile = b_sparse.find(i).get();
+      TSpArrayI::value_type c_tile = c_sparse.find(i).get();
+
+      for (std::size_t j = 0ul; j < a_tile.size(); ++j) {
+        BOOST_CHECK_EQUAL(a_tile[j], b_tile[j]);
+        BOOST_CHECK_EQUAL(a_tile[j], c_tile[j]);
+      }
+    } else {
+      BOOST_CHECK(b_sparse.is_zero(i));
+      BOOST_CHECK(c_sparse.is_zero(i));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -19,6 +19,8 @@
 
 #include <random>
 #include <chrono>
+#include <dirent.h>
+#include <unistd.h>
 
 #include <madness/world/text_fstream_archive.h>
 #include <madness/world/binary_fstream_archive.h>
@@ -209,6 +211,69 @@ BOOST_AUTO_TEST_CASE( assign_tiles )
   }
 }
 
+BOOST_AUTO_TEST_CASE( symmetric_find )
+{
+  ArrayN s(world, tr);
+  s.set_symmetry(symmetry::TileSymmetry::antisymmetric(GlobalFixture::dim, 0u, 1u));
+  BOOST_REQUIRE(s.symmetry());
+
+  // Only the unique tiles are initialized
+  const auto& elements_range = tr.elements_range();
+  s.init_tiles([&elements_range] (const Range& range) -> tile_type {
+    tile_type tile(range);
+    for(const auto& i : range)
+      tile[i] = elements_range.ordinal(i);
+    return tile;
+  });
+
+  for(std::size_t i = 0ul; i < s.range().volume(); ++i) {
+    const ArrayN::range_type::index index = s.range().idx(i);
+    BOOST_CHECK_EQUAL(s.is_unique(i), index[0] <= index[1]);
+
+    // Non-unique tiles are generated from the transposed unique tile
+    const tile_type tile = s.find(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), tr.make_tile_range(i));
+    for(const auto& e : tile.range()) {
+      std::vector<std::size_t> t(e.begin(), e.end());
+      std::swap(t[0], t[1]);
+      if(s.is_unique(i))
+        BOOST_CHECK_EQUAL(tile[e], int(elements_range.ordinal(e)));
+      else
+        BOOST_CHECK_EQUAL(tile[e], -int(elements_range.ordinal(t)));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( init_elements )
+{
+  const auto& elements_range = tr.elements_range();
+  ArrayN e(world, tr);
+  ArrayN s(world, tr);
+
+  // Initialize each element with its ordinal index in the array
+  e.init_elements([&elements_range] (const ArrayN::index& i) -> int {
+    return elements_range.ordinal(i);
+  });
+  s.init_spans([&elements_range] (const ArrayN::index& first, int* data,
+      const std::size_t n)
+  {
+    const int ordinal = elements_range.ordinal(first);
+    for(std::size_t j = 0ul; j < n; ++j)
+      data[j] = ordinal + j;
+  });
+
+  for(const auto index : * e.pmap()) {
+    const tile_type e_tile = e.find(index).get();
+    const tile_type s_tile = s.find(index).get();
+    BOOST_CHECK_EQUAL(e_tile.range(), tr.make_tile_range(index));
+    BOOST_CHECK_EQUAL(s_tile.range(), tr.make_tile_range(index));
+    for(const auto& i : e_tile.range()) {
+      BOOST_CHECK_EQUAL(e_tile[i], int(elements_range.ordinal(i)));
+      BOOST_CHECK_EQUAL(s_tile[i], int(elements_range.ordinal(i)));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( clone )
 {
   std::vector<int> data;
@@ -280,6 +345,63 @@ BOOST_AUTO_TEST_CASE( make_replicated )
   }
 }
 
+BOOST_AUTO_TEST_CASE( make_replicated_modes )
+{
+  for(const ReplicationMode mode : { ReplicationMode::direct,
+      ReplicationMode::ring, ReplicationMode::shared })
+  {
+    ArrayN r(a.world(), a.trange());
+    r.fill(GlobalFixture::world->rank() + 1);
+    std::shared_ptr<ArrayN::pmap_interface> distributed_pmap = r.pmap();
+
+    BOOST_REQUIRE_NO_THROW(r.make_replicated(mode));
+
+    // Check that all the data is local and correct
+    for(std::size_t i = 0; i < r.size(); ++i) {
+      BOOST_CHECK(r.is_local(i));
+      const ArrayN::value_type tile = r.find(i).get();
+      BOOST_CHECK_EQUAL(tile.range(), r.trange().make_tile_range(i));
+      for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+        BOOST_CHECK_EQUAL(*it, distributed_pmap->owner(i) + 1);
+    }
+    GlobalFixture::world->gop.fence();
+  }
+}
+
+BOOST_AUTO_TEST_CASE( shared_replicator )
+{
+  // make_replicated() does not replicate arrays on a single process, so
+  // construct the replicator directly; with more than one process this
+  // replicates the tiles through the shared memory of each host.
+  ArrayN r(a.world(), a.trange());
+  r.fill(GlobalFixture::world->rank() + 1);
+  auto pmap = std::make_shared<detail::ReplicatedPmap>(r.world(), r.size());
+  ArrayN result(r.world(), r.trange(), r.shape(), pmap);
+
+  std::shared_ptr<detail::SharedReplicator<ArrayN> > replicator;
+  BOOST_REQUIRE_NO_THROW(replicator =
+      std::make_shared<detail::SharedReplicator<ArrayN> >(r, result));
+
+  // The segment name is removed as soon as all processes have mapped it
+  const std::string prefix = "tiledarray_replica." + std::to_string(::getpid()) + ".";
+  if(DIR* dir = ::opendir("/dev/shm")) {
+    while(const dirent* entry = ::readdir(dir))
+      BOOST_CHECK(std::string(entry->d_name).compare(0, prefix.size(), prefix) != 0);
+    ::closedir(dir);
+  }
+
+  for(std::size_t i = 0; i < result.size(); ++i) {
+    BOOST_CHECK(result.is_local(i));
+    const ArrayN::value_type tile = result.find(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), result.trange().make_tile_range(i));
+    for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+      BOOST_CHECK_EQUAL(*it, r.pmap()->owner(i) + 1);
+  }
+
+  madness::detail::deferred_cleanup(r.world(), replicator);
+  GlobalFixture::world->gop.fence();
+}
+
 BOOST_AUTO_TEST_CASE( serialization )
 {
   decltype(a) acopy(a.world(), a.trange(), a.shape());
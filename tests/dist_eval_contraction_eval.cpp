@@ -320,6 +320,122 @@ BOOST_AUTO_TEST_CASE( eval )
 }
 
 
+BOOST_AUTO_TEST_CASE( stats )
+{
+  detail::set_summa_stats(SummaStats());
+
+  auto contract = make_contract_eval(left_arg, right_arg,
+      left_arg.world(), DenseShape(), pmap, Permutation(), make_contract(2u,
+      left_arg.trange().tiles_range().rank(), right_arg.trange().tiles_range().rank()));
+
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+  GlobalFixture::world->gop.fence();
+
+  // Check the statistics of processes that participated in the contraction
+  const SummaStats stats = summa_stats();
+  std::size_t participants = (stats.iterations ? 1ul : 0ul);
+  GlobalFixture::world->gop.sum(participants);
+  BOOST_CHECK_GT(participants, 0ul);
+
+  if(stats.iterations) {
+    BOOST_CHECK_EQUAL(stats.iterations,
+        left_arg.range().volume() / left_arg.range().extent(0));
+    BOOST_CHECK_EQUAL(stats.layers, 1ul);
+    BOOST_CHECK_GE(stats.min_depth, 1ul);
+    BOOST_CHECK_LE(stats.min_depth, stats.initial_depth);
+    BOOST_CHECK_LE(stats.initial_depth, stats.max_depth);
+    BOOST_CHECK_LE(stats.max_depth, stats.depth_limit);
+    BOOST_CHECK_GE(stats.final_depth, stats.min_depth);
+    BOOST_CHECK_LE(stats.final_depth, stats.max_depth);
+    if(! stats.adaptive) {
+      BOOST_CHECK_EQUAL(stats.grow_count, 0ul);
+      BOOST_CHECK_EQUAL(stats.shrink_count, 0ul);
+    }
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE( timed_contract_flops )
+{
+  // The left-hand tile is stored transposed and contracted as if it were
+  // permuted, so the matrix sizes come from the permuted range
+  const ContractReduce<TensorI, TensorI, TensorI, int> op(
+      madness::cblas::NoTrans, madness::cblas::NoTrans, 1, 2u, 2u, 2u,
+      Permutation(), Permutation({1,0}));
+  auto counters = std::make_shared<TiledArray::detail::SummaCounters>(false);
+  const TiledArray::detail::TimedContractOp<
+      ContractReduce<TensorI, TensorI, TensorI, int> > timed_op(op, counters);
+
+  const TensorI left(Range(std::array<int, 2>{{7, 3}}), 1);
+  const TensorI right(Range(std::array<int, 2>{{7, 4}}), 1);
+  TensorI result;
+  timed_op(result, left, right);
+
+  BOOST_CHECK_EQUAL(result.range(), Range(std::array<int, 2>{{3, 4}}));
+  BOOST_CHECK_EQUAL(counters->flops.load(), 2ul * 3ul * 4ul * 7ul);
+}
+
+BOOST_AUTO_TEST_CASE( trace )
+{
+  ContractionTrace::clear();
+  ContractionTrace::enable();
+  {
+    auto contract = make_contract_eval(left_arg, right_arg,
+        left_arg.world(), DenseShape(), pmap, Permutation(), make_contract(2u,
+        left_arg.trange().tiles_range().rank(), right_arg.trange().tiles_range().rank()));
+
+    BOOST_REQUIRE_NO_THROW(contract.eval());
+    BOOST_REQUIRE_NO_THROW(contract.wait());
+  }
+  ContractionTrace::enable(false);
+  GlobalFixture::world->gop.fence();
+
+  // Check that each process that participated in the contraction stored a
+  // profile
+  const std::vector<ContractionProfile> profiles = ContractionTrace::profiles();
+  std::size_t count = profiles.size();
+  GlobalFixture::world->gop.sum(count);
+  BOOST_CHECK_GT(count, 0ul);
+
+  for(const ContractionProfile& profile : profiles) {
+    BOOST_CHECK_EQUAL(profile.rank, GlobalFixture::world->rank());
+    BOOST_CHECK_EQUAL(profile.layers, 1ul);
+    BOOST_CHECK_GT(profile.flops, 0ul);
+
+    // Check that the phase totals match the events
+    std::uint64_t gemm_ns = 0ul;
+    std::size_t bcast_count = 0ul;
+    for(const ContractionEvent& event : profile.events) {
+      BOOST_CHECK_GE(event.start, profile.start);
+      BOOST_CHECK_LE(event.start + event.duration, profile.start + profile.duration);
+      if(event.phase == ContractionEvent::gemm)
+        gemm_ns += event.duration;
+      else if(event.phase == ContractionEvent::bcast)
+        ++bcast_count;
+    }
+    BOOST_CHECK_CLOSE(profile.gemm_time, double(gemm_ns) * 1.0e-9, 1.0e-6);
+    BOOST_CHECK_EQUAL(bcast_count, profile.iterations);
+  }
+
+  std::stringstream ss;
+  ContractionTrace::write_chrome_trace(ss);
+  BOOST_CHECK(ss.str().find("\"traceEvents\"") != std::string::npos);
+  ContractionTrace::clear();
+
+  // Times keep their nanosecond resolution in long traces
+  ContractionProfile profile = ContractionProfile();
+  profile.start = 12345678901234ul;
+  profile.duration = 5ul;
+  ContractionTrace::record(std::move(profile));
+  std::stringstream long_ss;
+  ContractionTrace::write_chrome_trace(long_ss);
+  BOOST_CHECK(long_ss.str().find("\"ts\":12345678901.234,\"dur\":0.005")
+      != std::string::npos);
+  ContractionTrace::clear();
+}
+
+
 BOOST_AUTO_TEST_CASE( perm_eval )
 {
   Permutation perm({1,0});
@@ -449,4 +565,67 @@ BOOST_AUTO_TEST_CASE( sparse_eval )
   do_sparse_eval(true);
 }
 
+BOOST_AUTO_TEST_CASE( sparse_index )
+{
+  const SparseShape<float> left_shape = make_shape(tr, 0.1, 23);
+  const SparseShape<float> right_shape = make_shape(tr, 0.1, 42);
+  const SparseShape<float> result_shape = make_shape(result_tr, 0.5, 7);
+
+  const std::size_t M = proc_grid.rows();
+  const std::size_t N = proc_grid.cols();
+  const std::size_t K = tr.tiles_range().volume() / M;
+  const std::size_t P_rows = proc_grid.proc_rows();
+  const std::size_t P_cols = proc_grid.proc_cols();
+
+  detail::SummaSparseIndex index(proc_grid, K, 0ul, K, left_shape,
+      right_shape, false, [&] (const std::size_t ij) { return result_shape.is_zero(ij); });
+
+  for(std::size_t k = 0ul; k < K; ++k) {
+    // Check the local non-zero tiles of column k of left and row k of right
+    std::vector<std::size_t> col, row;
+    for(std::size_t i = proc_grid.rank_row(), t = 0ul; i < M; i += P_rows, ++t)
+      if(! left_shape.is_zero(i * K + k))
+        col.push_back(t);
+    for(std::size_t j = proc_grid.rank_col(), t = 0ul; j < N; j += P_cols, ++t)
+      if(! right_shape.is_zero(k * N + j))
+        row.push_back(t);
+    BOOST_CHECK_EQUAL(index.col_size(k), col.size());
+    BOOST_CHECK_EQUAL(index.row_size(k), row.size());
+    BOOST_CHECK(std::equal(col.begin(), col.end(), index.col_begin(k)));
+    BOOST_CHECK(std::equal(row.begin(), row.end(), index.row_begin(k)));
+
+    // Check the processes that own non-zero tiles
+    for(std::size_t p = 0ul; p < P_rows; ++p) {
+      bool nonzero = false;
+      for(std::size_t i = p; i < M; i += P_rows)
+        nonzero = nonzero || ! left_shape.is_zero(i * K + k);
+      BOOST_CHECK_EQUAL(index.col_nonzero(k, p), nonzero);
+    }
+    for(std::size_t p = 0ul; p < P_cols; ++p) {
+      bool nonzero = false;
+      for(std::size_t j = p; j < N; j += P_cols)
+        nonzero = nonzero || ! right_shape.is_zero(k * N + j);
+      BOOST_CHECK_EQUAL(index.row_nonzero(k, p), nonzero);
+    }
+  }
+
+  // Check the processes that own non-zero result tiles
+  for(std::size_t i = proc_grid.rank_row(), t = 0ul; i < M; i += P_rows, ++t) {
+    for(std::size_t p = 0ul; p < P_cols; ++p) {
+      bool nonzero = false;
+      for(std::size_t j = p; j < N; j += P_cols)
+        nonzero = nonzero || ! result_shape.is_zero(i * N + j);
+      BOOST_CHECK_EQUAL(index.result_row_nonzero(t, p), nonzero);
+    }
+  }
+  for(std::size_t j = proc_grid.rank_col(), t = 0ul; j < N; j += P_cols, ++t) {
+    for(std::size_t p = 0ul; p < P_rows; ++p) {
+      bool nonzero = false;
+      for(std::size_t i = p; i < M; i += P_rows)
+        nonzero = nonzero || ! result_shape.is_zero(i * N + j);
+      BOOST_CHECK_EQUAL(index.result_col_nonzero(t, p), nonzero);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -116,6 +116,24 @@ struct ExpressionsFixture : public TiledRangeFixture {
     return matrix;
   }
 
+  /// Check that all tiles of an array are equal to those of a reference
+
+  /// \param array The array to be checked
+  /// \param ref The reference array
+  template <typename Tile>
+  static void check_tiles(const DistArray<Tile>& array,
+      const DistArray<Tile>& ref)
+  {
+    BOOST_CHECK_EQUAL(array.trange(), ref.trange());
+    for(std::size_t i = 0ul; i < array.range().volume(); ++i) {
+      const Tile tile = array.find(i).get();
+      const Tile tile_ref = ref.find(i).get();
+      BOOST_CHECK_EQUAL(tile.range(), tile_ref.range());
+      for(std::size_t x = 0ul; x < tile.size(); ++x)
+        BOOST_CHECK_EQUAL(tile[x], tile_ref[x]);
+    }
+  }
+
   ~ExpressionsFixture() {
     GlobalFixture::world->gop.fence();
   }
@@ -1730,6 +1748,113 @@ BOOST_AUTO_TEST_CASE( cont_plus_reduce )
   }
 }
 
+BOOST_AUTO_TEST_CASE( cont_symmetric )
+{
+  // Construct an argument that is antisymmetric in its first two indices
+  TArrayI anti;
+  anti("a,b,c") = a("a,b,c") - a("b,a,c");
+
+  // Compute the reference result
+  TArrayI result_ref;
+  result_ref("a,b,i,j") = anti("a,b,k") * b("k,i,j");
+
+  // Compute the result with antisymmetric tile storage
+  TArrayI result(*GlobalFixture::world, result_ref.trange());
+  result.set_symmetry(TiledArray::symmetry::TileSymmetry::antisymmetric(4u, 0u, 1u));
+  BOOST_REQUIRE_NO_THROW(result("a,b,i,j") = anti("a,b,k") * b("k,i,j"));
+  BOOST_REQUIRE(result.symmetry());
+
+  // Check that the tiles with a <= b are the unique tiles
+  for(TArrayI::iterator it = result.begin(); it != result.end(); ++it) {
+    const auto index = result.range().idx(it.ordinal());
+    BOOST_CHECK_EQUAL(result.is_unique(index), index[0] <= index[1]);
+  }
+
+  // Check that the unique and the regenerated tiles are equal to the reference
+  check_tiles(result, result_ref);
+}
+
+BOOST_AUTO_TEST_CASE( cont_chain_reorder )
+{
+  using TiledArray::expressions::ContractionOrder;
+  const bool enabled = ContractionOrder::enabled();
+
+  // Compute the reference result in the left-to-right order, which has an
+  // intermediate with four indices
+  ContractionOrder::enable(false);
+  TArrayI result_ref;
+  result_ref("i,j,n") = 2 * a("i,j,k") * b("k,l,m") * a("l,m,n");
+
+  // The reordered product contracts b and the second a first
+  ContractionOrder::enable(true);
+  const auto product = 2 * a("i,j,k") * b("k,l,m") * a("l,m,n");
+  TiledArray::expressions::detail::ContractionChain<TArrayI> chain;
+  TiledArray::expressions::detail::ContractionChainTrait<
+      std::decay_t<decltype(product)>, TArrayI>::collect(product, chain);
+  const auto plan = chain.order("i,j,n");
+  BOOST_REQUIRE_EQUAL(plan.size(), 2ul);
+  BOOST_CHECK_EQUAL(std::min(plan[0].left, plan[0].right), 1u);
+  BOOST_CHECK_EQUAL(std::max(plan[0].left, plan[0].right), 2u);
+  BOOST_CHECK_EQUAL(std::min(plan[1].left, plan[1].right), 0u);
+  BOOST_CHECK_EQUAL(std::max(plan[1].left, plan[1].right), 3u);
+
+  TArrayI result;
+  BOOST_REQUIRE_NO_THROW(result("i,j,n") = 2 * a("i,j,k") * b("k,l,m") * a("l,m,n"));
+  check_tiles(result, result_ref);
+
+  ContractionOrder::enable(enabled);
+}
+
+BOOST_AUTO_TEST_CASE( cont_plus_fused )
+{
+  // Compute the reference result from separately evaluated terms
+  TArrayI term1, term2, term3;
+  term1("i,j") = a("i,k,l") * b("k,l,j");
+  term2("i,j") = c("i,k,l") * a("k,l,j");
+  term3("i,j") = b("i,k,l") * c("k,l,j");
+  TArrayI result_ref;
+  result_ref("i,j") = term1("i,j") - term2("i,j") + term3("i,j");
+
+  // The second product and the array are added to the tiles of the first
+  // product as they are reduced
+  const auto sum = a("i,k,l") * b("k,l,j") - c("i,k,l") * a("k,l,j") + term3("i,j");
+  std::decay_t<decltype(sum)>::engine_type engine(sum);
+  engine.init(*GlobalFixture::world, nullptr,
+      TiledArray::expressions::VariableList("i,j"));
+  BOOST_CHECK(engine.is_fusable());
+
+  TArrayI result;
+  BOOST_REQUIRE_NO_THROW(result("i,j") = a("i,k,l") * b("k,l,j") -
+      c("i,k,l") * a("k,l,j") + term3("i,j"));
+
+  check_tiles(result, result_ref);
+}
+
+BOOST_AUTO_TEST_CASE( cont_cache )
+{
+  using TiledArray::expressions::IntermediateCache;
+  IntermediateCache::clear();
+  IntermediateCache::enable(1ul << 30);
+
+  TArrayI result1;
+  result1("i,j,n") = a("i,j,k") * b("k,l,m") * a("l,m,n");
+  BOOST_CHECK_EQUAL(IntermediateCache::hits(), 0ul);
+  BOOST_CHECK_GT(IntermediateCache::size(), 0ul);
+
+  // The product is reused, with a different scaling factor and annotation
+  TArrayI result2;
+  result2("n,j,i") = 2 * a("i,j,k") * b("k,l,m") * a("l,m,n");
+  BOOST_CHECK_EQUAL(IntermediateCache::hits(), 1ul);
+
+  TArrayI result_ref;
+  result_ref("n,j,i") = 2 * result1("i,j,n");
+  check_tiles(result2, result_ref);
+
+  // Disabling the cache releases the cached arrays
+  IntermediateCache::enable(0ul);
+  BOOST_CHECK_EQUAL(IntermediateCache::size(), 0ul);
+}
+
 BOOST_AUTO_TEST_CASE( no_alias_plus_reduce )
 {
   // Construct the tiled range
@@ -1878,6 +2003,127 @@ BOOST_AUTO_TEST_CASE( dot_expr )
   BOOST_CHECK_EQUAL(result, expected);
 }
 
+BOOST_AUTO_TEST_CASE( dot_products )
+{
+  // Test the batched dot products of a with a, b, and c
+  c("a,b,c") = 2 * b("a,b,c");
+  const std::vector<TArrayI> arrays = { a, b, c };
+  std::vector<int> result;
+  BOOST_REQUIRE_NO_THROW(result = TiledArray::dot_products(a, arrays.begin(), arrays.end()));
+  BOOST_REQUIRE_EQUAL(result.size(), 3ul);
+
+  // Check the results against dot
+  for(std::size_t k = 0ul; k < arrays.size(); ++k)
+    BOOST_CHECK_EQUAL(result[k], a("a,b,c").dot(arrays[k]("a,b,c")).get());
+
+  // Check an empty sequence
+  BOOST_CHECK(TiledArray::dot_products(a, arrays.end(), arrays.end()).empty());
+}
+
+BOOST_AUTO_TEST_CASE( linear_combination )
+{
+  // Test c = 2 * a - 3 * b, and c = a * (c + b)
+  const std::vector<TArrayI> arrays = { a, b };
+  BOOST_REQUIRE_NO_THROW(TiledArray::linear_combination(c, {2, -3}, arrays.begin(), arrays.end()));
+  TArrayI d;
+  d("a,b,c") = 2 * a("a,b,c") - 3 * b("a,b,c");
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type d_tile = d.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], d_tile[j]);
+  }
+
+  // The result may also be an argument
+  const std::array<std::reference_wrapper<const TArrayI>, 2> terms = {{ std::cref(c), std::cref(b) }};
+  BOOST_REQUIRE_NO_THROW(TiledArray::linear_combination(c, {1, 1}, terms.begin(), terms.end(), a));
+  d("a,b,c") = a("a,b,c") * (d("a,b,c") + b("a,b,c"));
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type d_tile = d.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], d_tile[j]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( conjugate_gradient )
+{
+  // Solve A x = b, where A is a symmetric, diagonally dominant, tridiagonal
+  // matrix and x[i] = i + 1
+  const TiledRange1 tr1{ 0, 5, 10, 15, 20 };
+  const TiledRange vector_trange{ tr1 };
+  const TiledRange matrix_trange{ tr1, tr1 };
+
+  struct Op {
+    TArrayD A;
+    void operator()(const TArrayD& x, TArrayD& result) const {
+      result("i") = A("i,j") * x("j");
+    }
+  } op;
+
+  op.A = TArrayD(*GlobalFixture::world, matrix_trange);
+  op.A.init_elements([] (const TArrayD::index& i) {
+    return (i[0] == i[1] ? 10.0 : (i[0] == i[1] + 1 || i[1] == i[0] + 1 ? -1.0 : 0.0));
+  });
+  TArrayD x_ref(*GlobalFixture::world, vector_trange);
+  x_ref.init_elements([] (const TArrayD::index& i) { return double(i[0] + 1); });
+  TArrayD preconditioner(*GlobalFixture::world, vector_trange);
+  preconditioner.init_elements([] (const TArrayD::index&) { return 0.1; });
+  TArrayD b;
+  op(x_ref, b);
+  TArrayD x;
+
+  ConjugateGradientSolver<TArrayD, Op> solver;
+  double rnorm = 0.0;
+  BOOST_REQUIRE_NO_THROW(rnorm = solver(op, b, x, preconditioner, 1e-10));
+  BOOST_CHECK_LT(rnorm, 1e-10);
+
+  for(TArrayD::iterator it = x.begin(); it != x.end(); ++it) {
+    const TArrayD::value_type tile = *it;
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_CLOSE(tile[j], double(tile.range().lobound()[0] + j + 1), 1e-6);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( diis_jacobi )
+{
+  // Accelerate the Jacobi iterations x += D^-1 (b - A x) for the system of
+  // the conjugate_gradient test with DIIS
+  const TiledRange1 tr1{ 0, 5, 10, 15, 20 };
+  const TiledRange vector_trange{ tr1 };
+  const TiledRange matrix_trange{ tr1, tr1 };
+
+  TArrayD A(*GlobalFixture::world, matrix_trange);
+  A.init_elements([] (const TArrayD::index& i) {
+    return (i[0] == i[1] ? 10.0 : (i[0] == i[1] + 1 || i[1] == i[0] + 1 ? -1.0 : 0.0));
+  });
+  TArrayD x_ref(*GlobalFixture::world, vector_trange);
+  x_ref.init_elements([] (const TArrayD::index& i) { return double(i[0] + 1); });
+  TArrayD b;
+  b("i") = A("i,j") * x_ref("j");
+  TArrayD x(*GlobalFixture::world, vector_trange);
+  x.init_elements([] (const TArrayD::index&) { return 0.0; });
+
+  // Plain Jacobi iterations leave an error of about 5e-8 after 12 iterations
+  DIIS<TArrayD> diis;
+  for(unsigned int iter = 0u; iter < 12u; ++iter) {
+    TArrayD error;
+    error("i") = b("i") - A("i,j") * x("j");
+    x("i") = x("i") + 0.1 * error("i");
+    BOOST_REQUIRE_NO_THROW(diis.extrapolate(x, error));
+  }
+
+  for(TArrayD::iterator it = x.begin(); it != x.end(); ++it) {
+    const TArrayD::value_type tile = *it;
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_SMALL(tile[j] - double(tile.range().lobound()[0] + j + 1), 1e-8);
+  }
+}
+
 BOOST_AUTO_TEST_CASE( dot_contr )
 {
   for(int i=0; i!=50; ++i)
@@ -1909,4 +2155,23 @@ BOOST_AUTO_TEST_CASE( inner_product )
   BOOST_CHECK_CLOSE(result.imag(), expected.imag(), 1e-9);
 }
 
+BOOST_AUTO_TEST_CASE( cont_cache_finalize )
+{
+  using TiledArray::expressions::IntermediateCache;
+  const std::size_t budget = IntermediateCache::budget();
+  IntermediateCache::clear();
+  IntermediateCache::enable(1ul << 30);
+
+  TArrayI result;
+  result("i,j,n") = a("i,j,k") * b("k,l,m") * a("l,m,n");
+  BOOST_CHECK_GT(IntermediateCache::size(), 0ul);
+
+  // TiledArray::finalize() runs the finalization callbacks before the
+  // runtime is finalized, which releases the cached arrays
+  TiledArray::detail::run_finalize_callbacks();
+  BOOST_CHECK_EQUAL(IntermediateCache::size(), 0ul);
+
+  IntermediateCache::enable(budget);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -118,5 +118,35 @@ BOOST_AUTO_TEST_CASE( local_group )
   }
 }
 
+BOOST_AUTO_TEST_CASE( buckets )
+{
+  const std::size_t procs = GlobalFixture::world->size();
+
+  for(std::size_t buckets_per_proc = 1ul; buckets_per_proc < 5ul; ++buckets_per_proc) {
+    const std::size_t tiles = 1000ul;
+    TiledArray::detail::HashPmap pmap(* GlobalFixture::world, tiles, 0ul,
+        buckets_per_proc);
+
+    // Check that the buckets cover all tiles
+    BOOST_CHECK_GE(pmap.bucket_size() * procs * buckets_per_proc, tiles);
+
+    // Check that all tiles in a bucket have the same owner
+    for(std::size_t tile = 0ul; tile < tiles; ++tile)
+      BOOST_CHECK_EQUAL(pmap.owner(tile),
+          pmap.owner(tile - tile % pmap.bucket_size()));
+
+    // Check that the local tiles are sorted and owned by this rank
+    for(detail::HashPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+      if(it != pmap.begin())
+        BOOST_CHECK_LT(*(it - 1), *it);
+    }
+
+    std::size_t total_size = pmap.local_size();
+    GlobalFixture::world->gop.sum(total_size);
+    BOOST_CHECK_EQUAL(total_size, tiles);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,135 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/layered_cyclic_pmap.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct LayeredCyclicPmapFixture {
+
+  LayeredCyclicPmapFixture() { }
+
+};
+
+
+// =============================================================================
+// LayeredCyclicPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( layered_cyclic_pmap_suite, LayeredCyclicPmapFixture )
+
+BOOST_AUTO_TEST_CASE( layer_blocks )
+{
+  for(std::size_t size = 1ul; size < 20ul; ++size) {
+    for(std::size_t layers = 1ul; layers <= size; ++layers) {
+      BOOST_CHECK_EQUAL(detail::LayeredCyclicPmap::layer_begin(size, layers, 0ul), 0ul);
+      BOOST_CHECK_EQUAL(detail::LayeredCyclicPmap::layer_begin(size, layers, layers), size);
+
+      // Check that each index is in the block of its layer
+      for(std::size_t i = 0ul; i < size; ++i) {
+        const std::size_t layer = detail::LayeredCyclicPmap::layer(size, layers, i);
+        BOOST_CHECK_LT(layer, layers);
+        BOOST_CHECK_LE(detail::LayeredCyclicPmap::layer_begin(size, layers, layer), i);
+        BOOST_CHECK_GT(detail::LayeredCyclicPmap::layer_begin(size, layers, layer + 1ul), i);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  for(std::size_t layers = 1ul; layers <= size; ++layers) {
+    const std::size_t p_cols = size / layers;
+    for(std::size_t x = layers; x < 10ul; ++x) {
+      for(std::size_t y = layers; y < 10ul; ++y) {
+        for(int layer_cols = 0; layer_cols < 2; ++layer_cols) {
+          detail::LayeredCyclicPmap pmap(* GlobalFixture::world, x, y, 1ul,
+              p_cols, layers, layer_cols);
+          BOOST_CHECK_EQUAL(pmap.size(), x * y);
+
+          for(std::size_t tile = 0; tile < x * y; ++tile) {
+            std::fill_n(p_owner, size, 0);
+            p_owner[rank] = pmap.owner(tile);
+            // check that the value is in range
+            BOOST_CHECK_LT(p_owner[rank], size);
+
+            // check that the tile is owned by the layer of its block
+            const std::size_t index = (layer_cols ? tile % y : tile / y);
+            BOOST_CHECK_EQUAL(pmap.owner(tile) / p_cols,
+                detail::LayeredCyclicPmap::layer((layer_cols ? y : x), layers, index));
+
+            GlobalFixture::world->gop.sum(p_owner, size);
+
+            // Make sure everyone agrees on who owns what.
+            for(std::size_t p = 0ul; p < size; ++p)
+              BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+          }
+        }
+      }
+    }
+  }
+
+  delete [] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+  const std::size_t size = GlobalFixture::world->size();
+
+  for(std::size_t layers = 1ul; layers <= size; ++layers) {
+    const std::size_t p_cols = size / layers;
+    for(std::size_t x = layers; x < 10ul; ++x) {
+      for(std::size_t y = layers; y < 10ul; ++y) {
+        for(int layer_cols = 0; layer_cols < 2; ++layer_cols) {
+          const std::size_t tiles = x * y;
+          detail::LayeredCyclicPmap pmap(* GlobalFixture::world, x, y, 1ul,
+              p_cols, layers, layer_cols);
+
+          // Check that the total number of local tiles is equal to the number
+          // of tiles in the map.
+          std::size_t total_size = pmap.local_size();
+          GlobalFixture::world->gop.sum(total_size);
+          BOOST_CHECK_EQUAL(total_size, tiles);
+
+          // Check that all local elements map to this rank
+          std::fill_n(tile_owners, tiles, 0);
+          for(detail::LayeredCyclicPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+            BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+            tile_owners[*it] += GlobalFixture::world->rank();
+          }
+
+          GlobalFixture::world->gop.sum(tile_owners, tiles);
+          for(std::size_t tile = 0; tile < tiles; ++tile) {
+            BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+          }
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,7 @@
  */
 
 #include "TiledArray/math/blas.h"
+#include "TiledArray/math/parallel_gemm.h"
 #include "tiledarray.h"
 #include "unit_test_config.h"
 
@@ -350,4 +351,37 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( complex_gemm_ld , T, floating_point_types )
   delete [] c;
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE( parallel_gemm , T, floating_point_types )
+{
+  // Use matrices that span several blocks in every dimension
+  const integer pm = 2 * TiledArray::math::GemmBlockSize::m_block + 3;
+  const integer pn = TiledArray::math::GemmBlockSize::n_block + 5;
+  const integer pk = TiledArray::math::GemmBlockSize::k_block + 7;
+
+  std::vector<T> a(pm * pk), b(pk * pn), c(pm * pn), expected(pm * pn);
+  rand_fill(a.data(), a.size(), 29);
+  rand_fill(b.data(), b.size(), 47);
+  rand_fill(c.data(), c.size(), 99);
+
+  const madness::cblas::CBLAS_TRANSPOSE ops[2] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+  for(auto op_a : ops) {
+    for(auto op_b : ops) {
+      const integer lda = (op_a == madness::cblas::NoTrans ? pk : pm);
+      const integer ldb = (op_b == madness::cblas::NoTrans ? pn : pk);
+
+      std::copy(c.begin(), c.end(), expected.begin());
+      TiledArray::math::gemm(op_a, op_b, pm, pn, pk, T(3), a.data(), lda,
+          b.data(), ldb, T(2), expected.data(), pn);
+
+      std::vector<T> result(c);
+      BOOST_REQUIRE_NO_THROW(TiledArray::math::parallel_gemm(op_a, op_b, pm,
+          pn, pk, T(3), a.data(), lda, b.data(), ldb, T(2), result.data(), pn));
+
+      for(integer i = 0; i < pm * pn; ++i)
+        BOOST_CHECK_CLOSE(result[i], expected[i], tol);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,7 @@
  *
  */
 
+#include "TiledArray/math/simd_transpose.h"
 #include "TiledArray/math/transpose.h"
 #include "tiledarray.h"
 #include "unit_test_config.h"
@@ -154,4 +155,41 @@ BOOST_AUTO_TEST_CASE( binary )
   delete [] b;
   delete [] c;
 }
+
+BOOST_AUTO_TEST_CASE( simd_copy )
+{
+  // Large enough for several micro-kernel blocks and unaligned edges
+  const std::size_t m = 40;
+  const std::size_t n = 45;
+  const std::size_t mn = m * n;
+
+  double* a = new double[mn];
+  double* b = new double[mn];
+
+  GlobalFixture::world->srand(1764);
+  for(std::size_t i = 0ul; i < mn; ++i)
+    a[i] = GlobalFixture::world->rand() % 42;
+
+  for(std::size_t x = 1ul; x < m; ++x) {
+    for(std::size_t y = 1ul; y < n; ++y) {
+      std::fill_n(b, mn, 0.0);
+
+      // Offset the matrices so that the rows are not aligned
+      TiledArray::math::transpose_copy(x - 1ul, y - 1ul, m, b + 1, n, a + 1);
+
+      for(std::size_t i = 0ul; i < m; ++i) {
+        for(std::size_t j = 0ul; j < n; ++j) {
+          if((i < x - 1ul) && (j < y - 1ul)) {
+            BOOST_CHECK_EQUAL(b[j * m + i + 1], a[i * n + j + 1]);
+          } else if(j * m + i + 1 < mn) {
+            BOOST_CHECK_EQUAL(b[j * m + i + 1], 0.0);
+          }
+        }
+      }
+    }
+  }
+
+  delete [] a;
+  delete [] b;
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -193,6 +193,55 @@ BOOST_AUTO_TEST_CASE( make_groups )
   }
 }
 
+BOOST_AUTO_TEST_CASE( layers )
+{
+  const std::size_t nprocs = 64ul, layers = 4ul;
+  const std::size_t rows = 100ul, cols = 50ul, k = 30ul;
+
+  TiledArray::detail::ProcGrid proc_grid0(*GlobalFixture::world, 0, nprocs,
+      rows, cols, rows * 10ul, cols * 10ul, layers);
+
+  // Each layer is a 2D grid of the processes available to the layer
+  BOOST_CHECK_EQUAL(proc_grid0.proc_layers(), layers);
+  BOOST_CHECK_LE(proc_grid0.proc_size() * layers, nprocs);
+  BOOST_CHECK_EQUAL(proc_grid0.proc_size(), proc_grid0.proc_rows() * proc_grid0.proc_cols());
+
+  // Check that the inner dimension is partitioned among the layers
+  BOOST_CHECK_EQUAL(proc_grid0.layer_begin(k, 0ul), 0ul);
+  BOOST_CHECK_EQUAL(proc_grid0.layer_begin(k, layers), k);
+  for(std::size_t layer = 0ul; layer < layers; ++layer)
+    BOOST_CHECK_LT(proc_grid0.layer_begin(k, layer), proc_grid0.layer_begin(k, layer + 1ul));
+
+  std::size_t local_size = 0ul;
+  for(std::size_t rank = 0ul; rank < nprocs; ++rank) {
+    TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, rank, nprocs,
+        rows, cols, rows * 10ul, cols * 10ul, layers);
+
+    BOOST_CHECK_EQUAL(proc_grid.proc_rows(), proc_grid0.proc_rows());
+    BOOST_CHECK_EQUAL(proc_grid.proc_cols(), proc_grid0.proc_cols());
+
+    if(rank < (proc_grid0.proc_size() * layers)) {
+      // Check process grid rank
+      BOOST_CHECK_EQUAL(proc_grid.rank_layer(), ProcessID(rank / proc_grid0.proc_size()));
+      BOOST_CHECK_EQUAL(proc_grid.rank_row(),
+          ProcessID((rank % proc_grid0.proc_size()) / proc_grid0.proc_cols()));
+      BOOST_CHECK_EQUAL(proc_grid.rank_col(), ProcessID(rank % proc_grid0.proc_cols()));
+
+      // Check that process coordinates map back to this process
+      BOOST_CHECK_EQUAL(proc_grid.map_layer(proc_grid.rank_layer()), ProcessID(rank));
+      BOOST_CHECK_EQUAL(proc_grid.map_row(proc_grid.rank_row()), ProcessID(rank));
+      BOOST_CHECK_EQUAL(proc_grid.map_col(proc_grid.rank_col()), ProcessID(rank));
+    } else {
+      BOOST_CHECK_EQUAL(proc_grid.local_size(), 0ul);
+    }
+
+    local_size += proc_grid.local_size();
+  }
+
+  // Each layer holds a copy of the process grid elements
+  BOOST_CHECK_EQUAL(local_size, rows * cols * layers);
+}
+
 #if 0
 // This test case us used to evaluate distribute statistics. This unit test
 // should only be enabled when changes are made to the ProcGrid algorithm, and
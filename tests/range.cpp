@@ -372,4 +372,60 @@ BOOST_AUTO_TEST_CASE( swap )
   BOOST_CHECK_EQUAL(r.volume(), volume);
 }
 
+BOOST_AUTO_TEST_CASE( inline_storage )
+{
+  // Check ranks with inline and heap dimension data
+  for(unsigned int rank = 1u; rank <= Range::max_inline_rank + 2u; ++rank) {
+    std::vector<std::size_t> lower(rank), upper(rank);
+    std::vector<unsigned int> p(rank);
+    for(unsigned int i = 0u; i < rank; ++i) {
+      lower[i] = i;
+      upper[i] = i + 2u + (i % 3u);
+      p[i] = rank - i - 1u;
+    }
+    const Range reference(lower, upper);
+    const Permutation perm(p);
+
+    // Copy
+    Range copy(reference);
+    BOOST_CHECK_EQUAL(copy, reference);
+    BOOST_CHECK_NE(copy.lobound_data(), reference.lobound_data());
+    BOOST_CHECK_EQUAL(copy.volume(), reference.volume());
+    BOOST_CHECK_EQUAL(copy.offset(), reference.offset());
+
+    // Move construction and assignment
+    Range moved(std::move(copy));
+    BOOST_CHECK_EQUAL(moved, reference);
+    BOOST_CHECK_EQUAL(copy.rank(), 0u);
+    BOOST_CHECK_EQUAL(copy.volume(), 0ul);
+    copy = std::move(moved);
+    BOOST_CHECK_EQUAL(copy, reference);
+    BOOST_CHECK_EQUAL(moved.rank(), 0u);
+
+    // Swap with a range of a different rank
+    Range other(std::vector<std::size_t>(Range::max_inline_rank + 2u - rank + 1u, 2ul));
+    const Range other_copy(other);
+    copy.swap(other);
+    BOOST_CHECK_EQUAL(copy, other_copy);
+    BOOST_CHECK_EQUAL(other, reference);
+    BOOST_CHECK_EQUAL(other.volume(), reference.volume());
+
+    // Permute
+    Range permuted = perm * reference;
+    Range permuted_inplace(reference);
+    permuted_inplace *= perm;
+    BOOST_CHECK_EQUAL(permuted, permuted_inplace);
+    for(unsigned int i = 0u; i < rank; ++i) {
+      BOOST_CHECK_EQUAL(permuted.lobound(perm[i]), reference.lobound(i));
+      BOOST_CHECK_EQUAL(permuted.upbound(perm[i]), reference.upbound(i));
+    }
+    BOOST_CHECK_EQUAL(permuted.volume(), reference.volume());
+
+    // Resize to a rank on the other side of the inline limit
+    permuted.resize(other_copy.lobound(), other_copy.upbound());
+    BOOST_CHECK_EQUAL(permuted, other_copy);
+    BOOST_CHECK_EQUAL(permuted.volume(), other_copy.volume());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -79,6 +79,18 @@ struct ReduceOp {
   }
 }; // struct ReduceOp
 
+struct BatchReduceOp : public ReduceOp {
+  using ReduceOp::operator();
+
+  void operator()(result_type& result,
+      const std::vector<const first_argument_type*>& first,
+      const std::vector<const second_argument_type*>& second) const
+  {
+    for(std::size_t i = 0ul; i < first.size(); ++i)
+      result += *first[i] * *second[i];
+  }
+}; // struct BatchReduceOp
+
 struct ReducePairTaskFixture {
 
   ReducePairTaskFixture() : world(*GlobalFixture::world), rt(world) {
@@ -228,4 +240,40 @@ BOOST_AUTO_TEST_CASE( reduce_zero )
   BOOST_CHECK_EQUAL(result.get(), 0);
 }
 
+BOOST_AUTO_TEST_CASE( reduce_batch )
+{
+  static_assert(is_batch_reducible<ReducePairOpWrapper<BatchReduceOp>, int,
+      ReducePairOpWrapper<BatchReduceOp>::argument_type>::value,
+      "BatchReduceOp should reduce batches of pairs");
+  static_assert(! is_batch_reducible<ReducePairOpWrapper<ReduceOp>, int,
+      ReducePairOpWrapper<ReduceOp>::argument_type>::value,
+      "ReduceOp should not reduce batches of pairs");
+
+  ReducePairTask<BatchReduceOp> batch_rt(world, BatchReduceOp(), nullptr, true);
+  std::vector<Future<int> > fut1_vec;
+  std::vector<Future<int> > fut2_vec;
+
+  int sum = 0;
+  for(int i = 0; i < 100; ++i) {
+    Future<int> f1;
+    Future<int> f2;
+    fut1_vec.push_back(f1);
+    fut2_vec.push_back(f2);
+    batch_rt.add(f1, f2);
+    // Arguments that are ready when added
+    sum += i * (i + 1);
+    batch_rt.add(i, i + 1);
+  }
+
+  Future<int> result = batch_rt.submit();
+
+  for(int i = 0; i < 100; ++i) {
+    sum += i * i;
+    fut1_vec[i].set(i);
+    fut2_vec[i].set(i);
+  }
+
+  BOOST_CHECK_EQUAL(result.get(), sum);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -817,6 +817,51 @@ BOOST_AUTO_TEST_CASE( add_const_perm )
   BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(tr.tiles_range().volume()), tolerance);
 }
 
+BOOST_AUTO_TEST_CASE( size_scaled_rank )
+{
+  // The size scaled operations split the tile index into leading and
+  // trailing dimensions, so check them for even and odd ranks.
+  for(unsigned int rank = 1u; rank <= 4u; ++rank) {
+    const std::vector<TiledRange1> rank_dims(rank, tr1);
+    const TiledRange trange(rank_dims.begin(), rank_dims.end());
+    const SparseShape<float> arg = make_shape(trange, 0.5, 42 + rank);
+    const SparseShape<float> other = make_shape(trange, 0.5, 23 + rank);
+
+    std::vector<unsigned int> p(rank);
+    for(unsigned int i = 0u; i < rank; ++i)
+      p[i] = (i + 1u) % rank;
+    const Permutation rank_perm(p.begin(), p.end());
+    const TiledArray::detail::PermIndex rank_perm_index(trange.tiles_range(), rank_perm);
+
+    SparseShape<float> add_result, add_perm_result, mult_result, mult_perm_result;
+    BOOST_REQUIRE_NO_THROW(add_result = arg.add(-2.3f));
+    BOOST_REQUIRE_NO_THROW(add_perm_result = arg.add(-2.3f, rank_perm));
+    BOOST_REQUIRE_NO_THROW(mult_result = arg.mult(other));
+    BOOST_REQUIRE_NO_THROW(mult_perm_result = arg.mult(other, rank_perm));
+
+    for(Tensor<float>::size_type i = 0ul; i < trange.tiles_range().volume(); ++i) {
+      const float volume = trange.make_tile_range(i).volume();
+      float add_expected = arg[i] + 2.3f / std::sqrt(volume);
+      if(add_expected < SparseShape<float>::threshold())
+        add_expected = 0.0f;
+      float mult_expected = arg[i] * other[i] * volume;
+      if(mult_expected < SparseShape<float>::threshold())
+        mult_expected = 0.0f;
+
+      const std::size_t pi = rank_perm_index(i);
+      BOOST_CHECK_CLOSE(add_result[i], add_expected, tolerance);
+      BOOST_CHECK_CLOSE(add_perm_result[pi], add_expected, tolerance);
+      BOOST_CHECK_CLOSE(mult_result[i], mult_expected, tolerance);
+      BOOST_CHECK_CLOSE(mult_perm_result[pi], mult_expected, tolerance);
+      BOOST_CHECK_EQUAL(add_perm_result.is_zero(pi), add_expected == 0.0f);
+      BOOST_CHECK_EQUAL(mult_perm_result.is_zero(pi), mult_expected == 0.0f);
+    }
+
+    BOOST_CHECK_CLOSE(add_perm_result.sparsity(), add_result.sparsity(), tolerance);
+    BOOST_CHECK_CLOSE(mult_perm_result.sparsity(), mult_result.sparsity(), tolerance);
+  }
+}
+
 BOOST_AUTO_TEST_CASE( subt )
 {
   SparseShape<float> result;
@@ -1181,6 +1226,63 @@ BOOST_AUTO_TEST_CASE( gemm )
   BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(result_norms.size()), tolerance);
 }
 
+BOOST_AUTO_TEST_CASE( gemm_trans )
+{
+  // Contract the leading dimensions of left with the trailing dimensions of
+  // right: result[a,b] = left[i,j,a] * right[b,i,j]
+  const std::size_t m = left.data().range().extent(left.data().range().rank() - 1);
+  const std::size_t n = right.data().range().extent(0);
+
+  size_type zero_tile_count = 0ul;
+
+  // Evaluate the contraction of sparse shapes
+  math::GemmHelper gemm_helper(madness::cblas::Trans, madness::cblas::Trans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = left.gemm(right, -7.2, gemm_helper));
+
+  // Create volumes tensors for the arguments
+  Tensor<float> volumes(tr.tiles_range(), 0.0f);
+  for(std::size_t i = 0ul; i < tr.tiles_range().volume(); ++i) {
+    const float volume = tr.make_tile_range(i).volume();
+    volumes[i] = volume;
+  }
+
+  Tensor<float> result_norms =
+      left.data().mult(volumes).gemm(right.data().mult(volumes), 7.2, gemm_helper);
+
+  // Check that the result is correct
+  std::array<std::size_t, 2> i = {{ 0, 0 }};
+  for(i[0] = 0ul; i[0] < m; ++i[0]) {
+
+    const TiledRange1::range_type r_0 = tr.data()[2].tile(i[0]);
+    const float size_0 = r_0.second - r_0.first;
+
+    for(i[1] = 0ul; i[1] < n; ++i[1]) {
+
+      const TiledRange1::range_type r_1 = tr.data()[0].tile(i[1]);
+      const float size_1 = r_1.second - r_1.first;
+
+      // Compute expected value
+      float expected = result_norms[i] / (size_0 * size_1);
+      if(expected < SparseShape<float>::threshold())
+        expected = 0.0f;
+
+      BOOST_CHECK_CLOSE(result[i], expected, tolerance);
+
+      // Check zero threshold
+      if(result[i] < SparseShape<float>::threshold()) {
+        BOOST_CHECK(result.is_zero(i));
+        ++zero_tile_count;
+      } else {
+        BOOST_CHECK(! result.is_zero(i));
+      }
+    }
+  }
+
+  BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(result_norms.size()), tolerance);
+}
+
 BOOST_AUTO_TEST_CASE( gemm_perm )
 {
   const Permutation perm({1,0});
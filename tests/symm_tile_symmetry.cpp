@@ -0,0 +1,96 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  symm_tile_symmetry.cpp
+ *  Oct 18, 2018
+ *
+ */
+
+#include "TiledArray/symm/tile_symmetry.h"
+#include "unit_test_config.h"
+
+using TiledArray::symmetry::TileSymmetry;
+using TiledArray::symmetry::Permutation;
+using TiledArray::symmetry::Phase;
+
+struct TileSymmetryFixture {
+
+  TileSymmetryFixture() :
+    // t_abij = -t_baij = -t_abji = t_baji
+    symmetry(4u, { {Permutation{1,0}, Phase(-1)}, {Permutation{0,1,3,2}, Phase(-1)} })
+  { }
+
+  ~TileSymmetryFixture() { }
+
+  TileSymmetry symmetry;
+}; // TileSymmetryFixture
+
+BOOST_FIXTURE_TEST_SUITE( symm_tile_symmetry_suite, TileSymmetryFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  BOOST_CHECK_EQUAL(symmetry.rank(), 4u);
+  BOOST_CHECK_EQUAL(symmetry.order(), 4u);
+  BOOST_CHECK_EQUAL(TileSymmetry::symmetric(3u, 0u, 2u).order(), 2u);
+
+#ifdef TA_EXCEPTION_ERROR
+  // The phases of the generators must be a representation of the group
+  BOOST_CHECK_THROW(TileSymmetry(3u, { {Permutation{1,2,0}, Phase(-1)} }),
+      TiledArray::Exception);
+
+  // The generators must permute the tile index
+  BOOST_CHECK_THROW(TileSymmetry(2u, { {Permutation{0,2,1}, Phase(1)} }),
+      TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( image )
+{
+  std::size_t unique_count = 0ul;
+  std::vector<std::size_t> index(4);
+  for(index[0] = 0ul; index[0] < 3ul; ++index[0]) {
+    for(index[1] = 0ul; index[1] < 3ul; ++index[1]) {
+      for(index[2] = 0ul; index[2] < 2ul; ++index[2]) {
+        for(index[3] = 0ul; index[3] < 2ul; ++index[3]) {
+          const bool unique = (index[0] <= index[1]) && (index[2] <= index[3]);
+          BOOST_CHECK_EQUAL(symmetry.is_unique(index), unique);
+          if(unique)
+            ++unique_count;
+
+          const TileSymmetry::Image image = symmetry.image(index);
+          BOOST_CHECK(symmetry.is_unique(image.index));
+          if(unique) {
+            BOOST_CHECK(image.index == index);
+            BOOST_CHECK(! image.perm);
+            BOOST_CHECK_EQUAL(image.sign, 1);
+          } else {
+            // The permutation maps the unique tile index to the tile index
+            BOOST_CHECK(image.perm * image.index == index);
+
+            // The sign is ambiguous for tiles on the diagonal of a pair
+            if((index[0] != index[1]) && (index[2] != index[3]))
+              BOOST_CHECK_EQUAL(image.sign, (index[0] > index[1]) != (index[2] > index[3]) ? -1 : 1);
+          }
+        }
+      }
+    }
+  }
+
+  BOOST_CHECK_EQUAL(unique_count, 18ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -169,6 +169,40 @@ BOOST_AUTO_TEST_CASE( permute_constructor_tensor ) {
   }
 }
 
+BOOST_AUTO_TEST_CASE( permute_constructor_large_tensor ) {
+  // The tensor is large enough for the permutation to be split into blocks
+  // that are evaluated by TBB tasks (see math::parallel_vector_op_threshold),
+  // and the rows of the fused matrices are not a multiple of the block rows.
+  // The permutations include the identity, the block copy, the transpose of
+  // one fused matrix and the transposes of several fused matrices.
+  const std::array<std::size_t, 3> start = {{0ul, 0ul, 0ul}};
+  const std::array<std::size_t, 3> finish = {{3ul, 389ul, 257ul}};
+  TensorN x(range_type(start, finish));
+  rand_fill(2731, x.size(), x.data());
+  BOOST_WARN(math::use_parallel_vector_op(x.size()));
+
+  std::array<unsigned int, 3> p = {{0,1,2}};
+
+  do {
+    Permutation perm(p.begin(), p.end());
+
+    TensorN px, opx;
+    BOOST_REQUIRE_NO_THROW(px = TensorN(x, perm));
+    BOOST_REQUIRE_NO_THROW(opx = TensorN(x, [] (const int arg) { return arg * 3; }, perm));
+    BOOST_CHECK_EQUAL(px.range(), perm * x.range());
+    BOOST_CHECK_EQUAL(opx.range(), perm * x.range());
+
+    // Compare with the element-wise permutation
+    std::size_t mismatches = 0ul;
+    for(std::size_t i = 0ul; i < x.size(); ++i) {
+      std::size_t pi = px.range().ordinal(perm * x.range().idx(i));
+      if((px[pi] != x[i]) || (opx[pi] != 3 * x[i]))
+        ++mismatches;
+    }
+    BOOST_CHECK_EQUAL(mismatches, 0ul);
+  } while(std::next_permutation(p.begin(), p.end()));
+}
+
 BOOST_AUTO_TEST_CASE( unary_constructor ) {
   // check constructor
   BOOST_REQUIRE_NO_THROW(TensorN x(t, [] (const int arg) { return arg * 83; }));
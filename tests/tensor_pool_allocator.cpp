@@ -0,0 +1,114 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2018  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tensor_pool_allocator.cpp
+ *  Oct 18, 2018
+ *
+ */
+
+#include "TiledArray/tensor/pool_allocator.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include <thread>
+
+using TiledArray::Tensor;
+using TiledArray::Range;
+using TiledArray::PoolAllocator;
+using TiledArray::detail::TensorPool;
+
+struct PoolAllocatorFixture {
+
+  typedef Tensor<double, PoolAllocator<double> > TensorN;
+
+  PoolAllocatorFixture() { TensorPool::instance().release(); }
+
+  ~PoolAllocatorFixture() { TensorPool::instance().release(); }
+
+}; // PoolAllocatorFixture
+
+BOOST_FIXTURE_TEST_SUITE( tensor_pool_allocator_suite, PoolAllocatorFixture )
+
+BOOST_AUTO_TEST_CASE( reuse )
+{
+  PoolAllocator<double> alloc;
+  const auto start = TiledArray::tensor_pool_stats();
+
+  double* const p = alloc.allocate(100);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % TensorPool::alignment(), 0ul);
+  alloc.deallocate(p, 100);
+
+  // A block of the same size class is reused
+  double* const q = alloc.allocate(100);
+  BOOST_CHECK_EQUAL(p, q);
+  alloc.deallocate(q, 100);
+
+  const auto stats = TiledArray::tensor_pool_stats();
+  BOOST_CHECK_EQUAL(stats.allocations - start.allocations, 2ul);
+  BOOST_CHECK_EQUAL(stats.deallocations - start.deallocations, 2ul);
+  BOOST_CHECK_EQUAL(stats.hits - start.hits, 1ul);
+  BOOST_CHECK_EQUAL(stats.cached_bytes, 100ul * sizeof(double) +
+      (TensorPool::granularity() - (100ul * sizeof(double)) % TensorPool::granularity()));
+
+  // Release returns cached blocks to the system
+  TensorPool::instance().release();
+  BOOST_CHECK_EQUAL(TiledArray::tensor_pool_stats().cached_bytes, 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( thread_exit )
+{
+  // The holder is constructed before the thread cache, so it is destroyed
+  // after it and frees its block directly to the system.
+  struct Holder {
+    double* p = nullptr;
+    ~Holder() { PoolAllocator<double>().deallocate(p, 100); }
+  };
+
+  const auto start = TiledArray::tensor_pool_stats();
+  std::thread thread([] {
+    static thread_local Holder holder;
+    holder.p = PoolAllocator<double>().allocate(100);
+  });
+  thread.join();
+
+  const auto stats = TiledArray::tensor_pool_stats();
+  BOOST_CHECK_EQUAL(stats.allocations - start.allocations, 1ul);
+  BOOST_CHECK_EQUAL(stats.cached_bytes, start.cached_bytes);
+}
+
+BOOST_AUTO_TEST_CASE( tensor )
+{
+  const Range range(std::array<int, 3>{{3, 4, 5}});
+  const auto start = TiledArray::tensor_pool_stats();
+
+  TensorN a(range, 1.0);
+  TensorN b(range, 2.0);
+  TensorN c = a.add(b);
+  for(std::size_t i = 0ul; i < c.size(); ++i)
+    BOOST_CHECK_EQUAL(c[i], 3.0);
+
+  // Temporaries with the same volume reuse the memory of freed tensors
+  const double* const data = c.data();
+  c = TensorN();
+  TensorN d = a.subt(b);
+  BOOST_CHECK_EQUAL(d.data(), data);
+  for(std::size_t i = 0ul; i < d.size(); ++i)
+    BOOST_CHECK_EQUAL(d[i], -1.0);
+
+  BOOST_CHECK_GE(TiledArray::tensor_pool_stats().hits - start.hits, 1ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
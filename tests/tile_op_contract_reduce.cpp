@@ -471,5 +471,36 @@ BOOST_AUTO_TEST_CASE( tensor_contract2 )
   BOOST_CHECK_EQUAL(result_map, C);
 }
 
+BOOST_AUTO_TEST_CASE( tensor_contract_permuted )
+{
+  // Construct tensors that must be permuted to the matrix form:
+  // result[i,j] = left[l,i,k] * right[j,k,l]
+  TensorI left = make_tensor(3, 2, 1, 30, 20, 9);
+  TensorI right = make_tensor(5, 1, 3, 50, 9, 30);
+  const Permutation left_perm({2, 0, 1});
+  const Permutation right_perm({2, 0, 1});
+
+  ContractReduce<TensorI, TensorI, TensorI, int>
+  op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 2u, 3u, 3u,
+      Permutation(), left_perm, right_perm);
+  ContractReduce<TensorI, TensorI, TensorI, int>
+  ref_op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 2u, 3u, 3u);
+
+  BOOST_CHECK_EQUAL(op.left_perm(), left_perm);
+  BOOST_CHECK_EQUAL(op.right_perm(), right_perm);
+
+  // Contract the tiles twice to check the accumulation
+  TensorI result, reference;
+  BOOST_REQUIRE_NO_THROW(op(result, left, right));
+  BOOST_REQUIRE_NO_THROW(op(result, left, right));
+  ref_op(reference, left.permute(left_perm), right.permute(right_perm));
+  ref_op(reference, left.permute(left_perm), right.permute(right_perm));
+
+  // Check that the result is equal to the contraction of the permuted tiles
+  BOOST_CHECK_EQUAL(result.range(), reference.range());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+      reference.begin(), reference.end());
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()